@@ -0,0 +1,103 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+struct BenchmarkOptions
+{
+    double MinSeconds = 0.25; // Keep iterating until at least this much time has been measured
+    int MinIterations = 10;
+    int MaxIterations = 100000;
+    bool Quick = false; // Trim the size sweeps so a run finishes in a few seconds
+};
+
+struct BenchmarkResult
+{
+    std::string Kernel;
+    std::string Variant;
+    std::size_t Size = 0;     // Problem size the sweep is over (blades, chain segments, curve samples)
+    std::size_t Elements = 0; // Elements processed by one iteration
+    int Iterations = 0;
+    double NsPerElement = 0.0;
+    double ElementsPerSecond = 0.0;
+    double P50Ns = 0.0;
+    double P99Ns = 0.0;
+};
+
+// Times Iteration() repeatedly and summarises the per-iteration latencies
+template <class IterationFn>
+BenchmarkResult runBenchmark(const std::string& Kernel, const std::string& Variant, const std::size_t Size, const std::size_t Elements,
+    const BenchmarkOptions& Options, IterationFn&& Iteration)
+{
+    using Clock = std::chrono::steady_clock;
+
+    Iteration(); // Warm up caches and page in any lazily touched memory
+
+    std::vector<double> Samples;
+    double TotalNs = 0.0;
+    while (static_cast<int>(Samples.size()) < Options.MaxIterations
+        && (static_cast<int>(Samples.size()) < Options.MinIterations || TotalNs < Options.MinSeconds * 1e9))
+    {
+        const auto Start = Clock::now();
+        Iteration();
+        const double Ns = std::chrono::duration<double, std::nano>(Clock::now() - Start).count();
+        Samples.push_back(Ns);
+        TotalNs += Ns;
+    }
+
+    const auto Percentile = [&Samples](const double Fraction)
+    {
+        const std::size_t Index = std::min(Samples.size() - 1, static_cast<std::size_t>(Fraction * static_cast<double>(Samples.size())));
+        std::nth_element(Samples.begin(), Samples.begin() + static_cast<std::ptrdiff_t>(Index), Samples.end());
+        return Samples[Index];
+    };
+
+    BenchmarkResult Result;
+    Result.Kernel = Kernel;
+    Result.Variant = Variant;
+    Result.Size = Size;
+    Result.Elements = Elements;
+    Result.Iterations = static_cast<int>(Samples.size());
+    const double MeanNs = TotalNs / static_cast<double>(Samples.size());
+    Result.NsPerElement = MeanNs / static_cast<double>(Elements);
+    Result.ElementsPerSecond = static_cast<double>(Elements) * 1e9 / MeanNs;
+    Result.P50Ns = Percentile(0.50);
+    Result.P99Ns = Percentile(0.99);
+    return Result;
+}
+
+// Geometric sweep Min, 10 * Min, ... up to and including Max
+std::vector<std::size_t> sizeSweep(std::size_t Min, std::size_t Max);
+
+// Kernel suites, each appending one result per variant and size
+void benchmarkGrass(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results);
+void benchmarkGrassSegments(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results);
+void benchmarkGrassPoseCache(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results);
+void benchmarkGrassWind(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results);
+void benchmarkGrassDynamics(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results);
+void benchmarkGrassTimeSlice(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results);
+void benchmarkGrassDisplacement(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results);
+void benchmarkGrassSnapshot(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results);
+void benchmarkGrassWorld(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results);
+void benchmarkWorm(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results);
+void benchmarkWormSwarm(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results);
+void benchmarkWormCollision(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results);
+void benchmarkWormRope(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results);
+void benchmarkArm(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results);
+void benchmarkBezier(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results);
+void benchmarkSoftwareRaster(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results);
+void benchmarkVectorMath(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results);
+
+// Accuracy checks run by --verify instead of the timings. Each prints the error of every kernel variant
+// the CPU supports against the scalar reference, or of a solver on a fixed seeded run, and returns false
+// if any exceeds its documented bound.
+bool verifyGrassKernels();
+bool verifyWormSwarmKernels();
+bool verifyWormCollisions();
+bool verifyWormRopeSolvers();
+
+void writeBenchmarkJson(std::ostream& Stream, const std::vector<BenchmarkResult>& Results);
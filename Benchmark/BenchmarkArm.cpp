@@ -0,0 +1,49 @@
+#include "Benchmark.h"
+
+#include "Arm.h"
+#include "WorkerPool.h"
+
+#include <cmath>
+
+void benchmarkArm(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results)
+{
+    const sf::Vector2f Base(800.0f, 450.0f);
+    for (const std::size_t Segments : sizeSweep(10, 10000))
+    {
+        std::vector<ArmSegment> ArmSegments(Segments);
+        initializeArm(ArmSegments, Base);
+
+        float Angle = 0.0f;
+        Results.push_back(runBenchmark("arm", "scalar", Segments, Segments, Options, [&]
+        {
+            Angle += 0.05f;
+            updateArm(ArmSegments, Base + sf::Vector2f(400.0f * std::cos(Angle), 400.0f * std::sin(Angle)), Base);
+        }));
+    }
+
+    // A grid of exercise-sized arms, each reaching around its own base, updated through the shared pool
+    WorkerPool Pool;
+    for (const std::size_t Count : sizeSweep(10, 10000))
+    {
+        std::vector<std::vector<ArmSegment>> Arms(Count, std::vector<ArmSegment>(NumArmSegments));
+        std::vector<sf::Vector2f> Targets(Count);
+        std::vector<sf::Vector2f> Bases(Count);
+        for (std::size_t I = 0; I < Count; ++I)
+        {
+            Bases[I] = sf::Vector2f(static_cast<float>(I % 100) * 16.0f, static_cast<float>(I / 100) * 9.0f);
+            initializeArm(Arms[I], Bases[I]);
+        }
+
+        float Angle = 0.0f;
+        Results.push_back(runBenchmark("arm", "chains pool", Count, Count * NumArmSegments, Options, [&]
+        {
+            Angle += 0.05f;
+            for (std::size_t I = 0; I < Count; ++I)
+            {
+                const float Phase = Angle + static_cast<float>(I);
+                Targets[I] = Bases[I] + sf::Vector2f(400.0f * std::cos(Phase), 400.0f * std::sin(Phase));
+            }
+            updateArms(Arms, Targets, Bases, Pool);
+        }));
+    }
+}
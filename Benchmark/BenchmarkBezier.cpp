@@ -0,0 +1,35 @@
+#include "Benchmark.h"
+
+#include "Bezier.h"
+#include "WorkerPool.h"
+
+void benchmarkBezier(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results)
+{
+    const sf::Vector2f AnchorLeft(0.0f, 450.0f);
+    const sf::Vector2f AnchorRight(1600.0f, 450.0f);
+    sf::Vector2f ControlLeft(400.0f, 300.0f);
+    const sf::Vector2f ControlRight(1200.0f, 600.0f);
+    WorkerPool Pool;
+
+    for (const std::size_t Samples : sizeSweep(1000, Options.Quick ? 100000 : 10000000))
+    {
+        std::vector<sf::Vector2f> Points(Samples);
+        const float Step = 1.0f / static_cast<float>(Samples - 1);
+
+        Results.push_back(runBenchmark("bezier", "scalar", Samples, Samples, Options, [&]
+        {
+            // Nudge a control point so the compiler cannot hoist the curve out of the loop
+            ControlLeft.y += 0.01f;
+            for (std::size_t I = 0; I < Samples; ++I)
+            {
+                Points[I] = bezierPoint(AnchorLeft, ControlLeft, ControlRight, AnchorRight, static_cast<float>(I) * Step);
+            }
+        }));
+
+        Results.push_back(runBenchmark("bezier", "pool", Samples, Samples, Options, [&]
+        {
+            ControlLeft.y += 0.01f;
+            tessellateBezier(Points, AnchorLeft, ControlLeft, ControlRight, AnchorRight, Pool);
+        }));
+    }
+}
@@ -0,0 +1,350 @@
+#include "Benchmark.h"
+
+#include "GrassDisplacement.h"
+#include "GrassDynamics.h"
+#include "GrassField.h"
+#include "GrassPoseCache.h"
+#include "GrassSimd.h"
+#include "GrassSnapshot.h"
+#include "GrassTimeSlice.h"
+#include "GrassWind.h"
+#include "GrassWorkerPool.h"
+#include "GrassWorld.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <random>
+
+void benchmarkGrass(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results)
+{
+    const GrassIsa Isa = detectGrassIsa();
+    WorkerPool Pool;
+
+    for (const std::size_t Blades : sizeSweep(500, Options.Quick ? 50000 : 10000000))
+    {
+        GrassField Field;
+        initializeGrass(Field, Blades, 1600.0f, 900.0f);
+
+        // Advance time every iteration so the sin arguments do not repeat
+        float Time = 0.0f;
+        const auto Run = [&](const GrassIsa KernelIsa)
+        {
+            return [&, KernelIsa] { updateGrass(Field, Time += 0.016f, KernelIsa); };
+        };
+
+        Results.push_back(runBenchmark("grass", "scalar", Blades, Blades, Options, Run(GrassIsa::Scalar)));
+        if (Isa != GrassIsa::Scalar)
+        {
+            Results.push_back(runBenchmark("grass", grassIsaName(Isa), Blades, Blades, Options, Run(Isa)));
+        }
+        Results.push_back(runBenchmark("grass", std::string(grassIsaName(Isa)) + " x" + std::to_string(Pool.threadCount()) + " threads",
+            Blades, Blades, Options, [&] { updateGrass(Field, Time += 0.016f, Isa, Pool); }));
+    }
+}
+
+bool verifyGrassKernels()
+{
+    // Every instruction set up to the detected one, as each CPU with a wider set also has the narrower ones
+    const GrassIsa Widest = detectGrassIsa();
+    bool Passed = true;
+    for (const int Segments : { GrassSegments, 64 })
+    {
+        GrassField Field;
+        generateGrass(Field, 2000, 0.0f, 1600.0f, 900.0f, Segments, 1);
+        for (const GrassIsa Isa : { GrassIsa::Scalar, GrassIsa::Sse2, GrassIsa::Avx2, GrassIsa::Avx512 })
+        {
+            for (const GrassSegmentBuilder Builder : { GrassSegmentBuilder::Direct, GrassSegmentBuilder::Incremental })
+            {
+                // The direct scalar kernel is the reference itself
+                if (Isa > Widest || (Isa == GrassIsa::Scalar && Builder == GrassSegmentBuilder::Direct))
+                {
+                    continue;
+                }
+                const float Error = grassKernelMaxError(Field, Isa, Builder);
+                const bool Within = Error <= GrassKernelTolerance;
+                std::cerr << "  " << Segments << " segments, " << grassIsaName(Isa) << (Builder == GrassSegmentBuilder::Direct ? " direct" : " incremental")
+                    << ": max error " << Error << " px, limit " << GrassKernelTolerance << " px" << (Within ? "" : " FAILED") << std::endl;
+                Passed = Passed && Within;
+            }
+        }
+    }
+    return Passed;
+}
+
+void benchmarkGrassSegments(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results)
+{
+    const GrassIsa Isa = detectGrassIsa();
+    const std::size_t Blades = Options.Quick ? 10000 : 100000;
+
+    // Long blades, where the incremental builder replaces a sin/cos pair per segment with a rotation
+    for (const int Segments : { 5, 16, 64, 256 })
+    {
+        GrassField Field;
+        initializeGrass(Field, Blades, 1600.0f, 900.0f, Segments);
+        const std::size_t Elements = Blades * static_cast<std::size_t>(Segments);
+
+        float Time = 0.0f;
+        for (const GrassIsa KernelIsa : { GrassIsa::Scalar, Isa })
+        {
+            for (const GrassSegmentBuilder Builder : { GrassSegmentBuilder::Direct, GrassSegmentBuilder::Incremental })
+            {
+                const std::string Variant = std::string(grassIsaName(KernelIsa)) + (Builder == GrassSegmentBuilder::Direct ? " direct" : " incremental");
+                Results.push_back(runBenchmark("grass_segments", Variant, static_cast<std::size_t>(Segments), Elements, Options, [&]
+                {
+                    updateGrass(Field, Time += 0.016f, KernelIsa, Builder);
+                }));
+            }
+        }
+    }
+}
+
+void benchmarkGrassPoseCache(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results)
+{
+    const std::size_t Blades = Options.Quick ? 10000 : 100000;
+
+    // Single-threaded scalar, so the cache lookup is compared with the trig it replaces. The accuracy of
+    // each cache size goes to stderr with the progress lines.
+    for (const int Segments : { 5, 16, 64 })
+    {
+        GrassField Field;
+        initializeGrass(Field, Blades, 1600.0f, 900.0f, Segments);
+        const std::size_t Elements = Blades * static_cast<std::size_t>(Segments);
+
+        float Time = 0.0f;
+        Results.push_back(runBenchmark("grass_pose_cache", "scalar exact", static_cast<std::size_t>(Segments), Elements, Options, [&]
+        {
+            updateGrassRange(Field, Time += 0.016f, 0, Field.BladeCount);
+        }));
+        for (const int Poses : { 16, 64, 256, 1024 })
+        {
+            for (const bool Interpolate : { false, true })
+            {
+                GrassPoseCache Cache;
+                buildGrassPoseCache(Cache, Segments, Poses, Interpolate);
+                const std::string Variant = "K=" + std::to_string(Poses) + (Interpolate ? " lerp" : " nearest");
+                std::cerr << "  " << Segments << " segments, " << Variant << ": max error " << grassPoseCacheMaxError(Field, Cache) << " px" << std::endl;
+                Results.push_back(runBenchmark("grass_pose_cache", Variant, static_cast<std::size_t>(Segments), Elements, Options, [&]
+                {
+                    updateGrassCachedRange(Field, Time += 0.016f, Cache, 0, Field.BladeCount);
+                }));
+            }
+        }
+    }
+}
+
+void benchmarkGrassWind(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results)
+{
+    const GrassIsa Isa = detectGrassIsa();
+    WorkerPool Pool;
+    const sf::FloatRect Bounds(0.0f, 0.0f, 1600.0f, 900.0f);
+
+    // The grid covers one screen whatever the blade count, so its share of the frame should shrink as
+    // blades are added and only the bilinear lookup per blade remains
+    for (const std::size_t Blades : sizeSweep(500, Options.Quick ? 50000 : 1000000))
+    {
+        GrassField Field;
+        initializeGrass(Field, Blades, 1600.0f, 900.0f);
+        GrassWindField Wind;
+
+        float Time = 0.0f;
+        Results.push_back(runBenchmark("grass_wind", "grid only", Blades, Blades, Options, [&]
+        {
+            updateWindField(Wind, Bounds, Time += 0.016f);
+        }));
+        Results.push_back(runBenchmark("grass_wind", std::string(grassIsaName(Isa)) + " no wind", Blades, Blades, Options, [&]
+        {
+            updateGrass(Field, Time += 0.016f, Isa, Pool);
+        }));
+        Results.push_back(runBenchmark("grass_wind", std::string(grassIsaName(Isa)) + " wind", Blades, Blades, Options, [&]
+        {
+            updateWindField(Wind, Bounds, Time += 0.016f);
+            updateGrass(Field, Time, Isa, Pool, GrassSegmentBuilder::Direct, &Wind);
+        }));
+    }
+}
+
+void benchmarkGrassDynamics(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results)
+{
+    const GrassIsa Isa = detectGrassIsa();
+    WorkerPool Pool;
+
+    // One 60 Hz frame: two 120 Hz spring steps plus the interpolated pose, against the kinematic update
+    for (const std::size_t Blades : sizeSweep(500, Options.Quick ? 50000 : 1000000))
+    {
+        GrassField Field;
+        initializeGrass(Field, Blades, 1600.0f, 900.0f);
+        GrassDynamics Dynamics;
+        resetGrassDynamics(Dynamics, Field, 0.0f);
+
+        float Time = 0.0f;
+        Results.push_back(runBenchmark("grass_dynamics", std::string(grassIsaName(Isa)) + " kinematic", Blades, Blades, Options, [&]
+        {
+            updateGrass(Field, Time += 1.0f / 60.0f, Isa, Pool);
+        }));
+        Results.push_back(runBenchmark("grass_dynamics", std::string(grassIsaName(Isa)) + " spring", Blades, Blades, Options, [&]
+        {
+            advanceGrassDynamics(Dynamics, Field, 1.0f / 60.0f, Isa, Pool);
+        }));
+        Results.push_back(runBenchmark("grass_dynamics", "step only", Blades, Blades, Options, [&]
+        {
+            stepGrassDynamicsRange(Dynamics, Field, 0, Field.BladeCount);
+        }));
+    }
+}
+
+void benchmarkGrassTimeSlice(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results)
+{
+    WorkerPool Pool;
+
+    // One 60 Hz frame of the exact update against the amortised one solving 1/N of the blades. Extrapolating
+    // streams two stored poses per blade, so it only pays where the solve costs more than that: the scalar
+    // path, not the vector kernels. The tip error that buys goes to stderr, measured on a fixed scripted run
+    // from a fresh seeded field at time 0, so it does not depend on how many frames were timed or on the
+    // variants before it.
+    constexpr int QualityFrames = 120;
+    for (const std::size_t Blades : sizeSweep(500, Options.Quick ? 50000 : 1000000))
+    {
+        GrassField Field;
+        initializeGrass(Field, Blades, 1600.0f, 900.0f);
+
+        for (const GrassIsa Isa : { GrassIsa::Scalar, detectGrassIsa() })
+        {
+            float Time = 0.0f;
+            Results.push_back(runBenchmark("grass_time_slice", std::string(grassIsaName(Isa)) + " exact", Blades, Blades, Options, [&]
+            {
+                updateGrass(Field, Time += 1.0f / 60.0f, Isa, Pool);
+            }));
+            for (const int Slices : { 2, 4, 8 })
+            {
+                GrassTimeSlice Slice;
+                resetGrassTimeSlice(Slice, Field, Slices);
+                const std::string Variant = std::string(grassIsaName(Isa)) + " 1/" + std::to_string(Slices);
+                Results.push_back(runBenchmark("grass_time_slice", Variant, Blades, Blades, Options, [&]
+                {
+                    updateGrassTimeSliced(Field, Slice, Time += 1.0f / 60.0f, Isa, Pool);
+                }));
+
+                GrassField QualityField;
+                generateGrass(QualityField, Blades, 0.0f, 1600.0f, 900.0f, GrassSegments, 1);
+                resetGrassTimeSlice(Slice, QualityField, Slices);
+                GrassTimeSliceStats Stats;
+                for (int Frame = 1; Frame <= QualityFrames; ++Frame)
+                {
+                    updateGrassTimeSliced(QualityField, Slice, static_cast<float>(Frame) / 60.0f, Isa, Pool);
+                    Stats.add(Slice.LastStats);
+                }
+                std::cerr << "  " << Blades << " blades, " << Variant << ": tip error over " << QualityFrames << " frames mean "
+                    << Stats.meanTipError() << " px, max " << Stats.MaxTipError << " px" << std::endl;
+            }
+        }
+    }
+}
+
+void benchmarkGrassDisplacement(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results)
+{
+    WorkerPool Pool;
+
+    // One frame of displacement from 1000 colliders spread over the grass, which wander a little each
+    // frame, and the per-frame cost of easing the blades they left bent with no colliders at all
+    constexpr int ColliderCount = 1000;
+    for (const std::size_t Blades : sizeSweep(10000, Options.Quick ? 100000 : 1000000))
+    {
+        GrassField Field;
+        generateGrass(Field, Blades, 0.0f, 1600.0f, 900.0f, GrassSegments, 1);
+        updateGrass(Field, 0.0f);
+        GrassBladeGrid Grid;
+        buildGrassBladeGrid(Grid, Field);
+        GrassDisplacement Displacement;
+        resetGrassDisplacement(Displacement, Field, Grid);
+
+        std::mt19937 Generator(1);
+        std::uniform_real_distribution PositionX(0.0f, 1600.0f);
+        std::uniform_real_distribution PositionY(700.0f, 900.0f);
+        std::uniform_real_distribution Step(-2.0f, 2.0f);
+        std::vector<GrassCollider> Colliders(ColliderCount);
+        for (GrassCollider& Collider : Colliders)
+        {
+            Collider.Position = sf::Vector2f(PositionX(Generator), PositionY(Generator));
+        }
+
+        Results.push_back(runBenchmark("grass_displacement", "grid", Blades, Blades, Options, [&]
+        {
+            for (GrassCollider& Collider : Colliders)
+            {
+                Collider.Position += sf::Vector2f(Step(Generator), Step(Generator));
+            }
+            applyGrassDisplacement(Displacement, Field, Grid, Colliders, 1.0f / 60.0f, Pool);
+        }));
+
+        Results.push_back(runBenchmark("grass_displacement", "ease only", Blades, Blades, Options, [&]
+        {
+            applyGrassDisplacement(Displacement, Field, Grid, {}, 1.0f / 60.0f, Pool);
+        }));
+    }
+}
+
+void benchmarkGrassSnapshot(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results)
+{
+    const std::string Path = (std::filesystem::temp_directory_path() / "KernelBenchmark.grass").string();
+
+    // Startup cost of a field: generating it blade by blade against mapping a saved snapshot. The load
+    // includes touching one blade per page so the mapping is not measured as free.
+    for (const std::size_t Blades : sizeSweep(500, Options.Quick ? 50000 : 5000000))
+    {
+        Results.push_back(runBenchmark("grass_snapshot", "generate", Blades, Blades, Options, [&]
+        {
+            GrassField Field;
+            generateGrass(Field, Blades, 0.0f, 1600.0f, 900.0f, GrassSegments, 1);
+        }));
+
+        GrassField Source;
+        generateGrass(Source, Blades, 0.0f, 1600.0f, 900.0f, GrassSegments, 1);
+        for (const bool RestPose : { false, true })
+        {
+            if (!saveGrassSnapshot(Source, Path, RestPose))
+            {
+                continue;
+            }
+            float Checksum = 0.0f;
+            Results.push_back(runBenchmark("grass_snapshot", RestPose ? "load with rest pose" : "load", Blades, Blades, Options, [&]
+            {
+                GrassField Field;
+                loadGrassSnapshot(Field, Path);
+                for (std::size_t Blade = 0; Blade < Field.BladeCount; Blade += 1024)
+                {
+                    Checksum += Field.BaseX[Blade];
+                }
+            }));
+        }
+    }
+    std::remove(Path.c_str());
+}
+
+void benchmarkGrassWorld(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results)
+{
+    const GrassIsa Isa = detectGrassIsa();
+    WorkerPool Pool;
+
+    // Per-frame cost of a world N screens wide while the camera pans a quarter screen per frame, which
+    // keeps generating and evicting chunks. It should not depend on the world width.
+    for (const long long Screens : { 1LL, 1000LL, 100000LL })
+    {
+        GrassWorldSettings Settings;
+        Settings.ChunkCount = Screens * 1600 / static_cast<long long>(Settings.ChunkWidth);
+        GrassWorld World(Settings);
+
+        float Time = 0.0f;
+        float CameraX = 0.0f;
+        Results.push_back(runBenchmark("grass_world", "pan", static_cast<std::size_t>(Screens), 500, Options, [&]
+        {
+            CameraX += 400.0f;
+            if (CameraX + 1600.0f > World.width())
+            {
+                CameraX = 0.0f;
+            }
+            World.setView(sf::FloatRect(CameraX, 0.0f, 1600.0f, 900.0f));
+            World.update(Time += 0.016f, Isa, Pool);
+        }));
+    }
+}
@@ -0,0 +1,52 @@
+#include "Benchmark.h"
+
+#include "GrassField.h"
+#include "SoftwareRasterizer.h"
+#include "WorkerPool.h"
+
+#include <cmath>
+
+void benchmarkSoftwareRaster(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results)
+{
+    // One 1600x900 frame of a grass field drawn the way GrassRenderer batches it, two triangles per
+    // segment, on every hardware thread and on the calling thread alone
+    WorkerPool Pool;
+    WorkerPool SingleThread(1);
+    const std::uint32_t Green = softwareColor(34, 139, 34);
+    const std::uint32_t Cyan = softwareColor(0, 255, 255);
+    for (const std::size_t Blades : sizeSweep(1000, Options.Quick ? 100000 : 1000000))
+    {
+        GrassField Field;
+        generateGrass(Field, Blades, 0.0f, 1600.0f, 900.0f, GrassSegments, 1);
+        updateGrass(Field, 0.0f);
+        const std::size_t Triangles = Blades * GrassSegments * 2;
+
+        for (WorkerPool* Target : { &Pool, &SingleThread })
+        {
+            SoftwareRasterizer Rasterizer(1600, 900, *Target);
+            Results.push_back(runBenchmark("raster", Target == &Pool ? "tiles" : "tiles 1 thread", Blades, Triangles, Options, [&]
+            {
+                Rasterizer.clear(Cyan);
+                for (int Segment = 0; Segment < Field.SegmentCount; ++Segment)
+                {
+                    const float Thickness = 3.0f - 2.0f * static_cast<float>(Segment) / static_cast<float>(Field.SegmentCount);
+                    const float* StartX = Field.segmentRowX(Segment);
+                    const float* StartY = Field.segmentRowY(Segment);
+                    const float* EndX = Field.segmentRowX(Segment + 1);
+                    const float* EndY = Field.segmentRowY(Segment + 1);
+                    for (std::size_t Blade = 0; Blade < Field.BladeCount; ++Blade)
+                    {
+                        const sf::Vector2f A(StartX[Blade], StartY[Blade]);
+                        const sf::Vector2f B(EndX[Blade], EndY[Blade]);
+                        const float Length = std::sqrt((B.x - A.x) * (B.x - A.x) + (B.y - A.y) * (B.y - A.y));
+                        const float Scale = Length > 0.0f ? Thickness / Length : 0.0f;
+                        const sf::Vector2f Offset(-(B.y - A.y) * Scale, (B.x - A.x) * Scale);
+                        Rasterizer.drawTriangle(A, B, B + Offset, Green);
+                        Rasterizer.drawTriangle(A, B + Offset, A + Offset, Green);
+                    }
+                }
+                Rasterizer.finish();
+            }));
+        }
+    }
+}
@@ -0,0 +1,93 @@
+#include "Benchmark.h"
+
+#include "VectorMath.h"
+#include "Worm.h"
+
+#include <cmath>
+#include <random>
+
+namespace
+{
+    // The chain constraint as updateWorm did it before the fast path: a square root and a divide per segment
+    void updateWormExact(std::vector<WormSegment>& WormSegments, const sf::Vector2f& TargetPosition)
+    {
+        WormSegments[0].Position = TargetPosition;
+        for (std::size_t I = 1; I < WormSegments.size(); ++I)
+        {
+            sf::Vector2f Direction = WormSegments[I].Position - WormSegments[I - 1].Position;
+            const float Distance = std::sqrt(Direction.x * Direction.x + Direction.y * Direction.y);
+            if (Distance > SegmentLength)
+            {
+                Direction /= Distance;
+                WormSegments[I].Position = WormSegments[I - 1].Position + Direction * SegmentLength;
+            }
+        }
+    }
+}
+
+void benchmarkVectorMath(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results)
+{
+    // Batched normalize and length of random vectors: std::sqrt and a divide against the refined reciprocal
+    // square root estimate, scalar and on the widest vector unit
+    const VectorMathIsa Isa = detectVectorMathIsa();
+    for (const std::size_t Count : sizeSweep(1000, Options.Quick ? 100000 : 1000000))
+    {
+        std::mt19937 Generator(1);
+        std::uniform_real_distribution<float> Component(-100.0f, 100.0f);
+        std::vector<float> X(Count);
+        std::vector<float> Y(Count);
+        for (std::size_t I = 0; I < Count; ++I)
+        {
+            X[I] = Component(Generator);
+            Y[I] = Component(Generator);
+        }
+        std::vector<float> OutX(Count);
+        std::vector<float> OutY(Count);
+        std::vector<float> Lengths(Count);
+
+        Results.push_back(runBenchmark("vector_math", "normalize std::sqrt", Count, Count, Options, [&]
+        {
+            exactNormalizeBatch(X.data(), Y.data(), OutX.data(), OutY.data(), Lengths.data(), Count);
+        }));
+        Results.push_back(runBenchmark("vector_math", "length std::sqrt", Count, Count, Options, [&]
+        {
+            exactLengthBatch(X.data(), Y.data(), Lengths.data(), Count);
+        }));
+        for (const VectorMathIsa Variant : { VectorMathIsa::Scalar, Isa })
+        {
+            const NormalizeBatchKernel Normalize = normalizeBatchKernel(Variant);
+            const LengthBatchKernel Length = lengthBatchKernel(Variant);
+            Results.push_back(runBenchmark("vector_math", std::string("normalize rsqrt ") + vectorMathIsaName(Variant), Count, Count, Options, [&]
+            {
+                Normalize(X.data(), Y.data(), OutX.data(), OutY.data(), Lengths.data(), Count);
+            }));
+            Results.push_back(runBenchmark("vector_math", std::string("length rsqrt ") + vectorMathIsaName(Variant), Count, Count, Options, [&]
+            {
+                Length(X.data(), Y.data(), Lengths.data(), Count);
+            }));
+        }
+    }
+
+    // The sequential worm chain, where each segment waits on the one before, so latency rather than
+    // throughput decides between the two
+    for (const std::size_t Segments : sizeSweep(10, 10000))
+    {
+        std::vector<WormSegment> Exact(Segments);
+        std::vector<WormSegment> Fast(Segments);
+        initializeWorm(Exact, sf::Vector2f(800.0f, 450.0f));
+        initializeWorm(Fast, sf::Vector2f(800.0f, 450.0f));
+
+        float Angle = 0.0f;
+        Results.push_back(runBenchmark("vector_math", "chain std::sqrt", Segments, Segments, Options, [&]
+        {
+            Angle += 0.05f;
+            updateWormExact(Exact, sf::Vector2f(800.0f + 400.0f * std::cos(Angle), 450.0f + 400.0f * std::sin(Angle)));
+        }));
+        Angle = 0.0f;
+        Results.push_back(runBenchmark("vector_math", "chain rsqrt", Segments, Segments, Options, [&]
+        {
+            Angle += 0.05f;
+            updateWorm(Fast, sf::Vector2f(800.0f + 400.0f * std::cos(Angle), 450.0f + 400.0f * std::sin(Angle)));
+        }));
+    }
+}
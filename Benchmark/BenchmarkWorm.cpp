@@ -0,0 +1,325 @@
+#include "Benchmark.h"
+
+#include "WorkerPool.h"
+#include "Worm.h"
+#include "WormCollision.h"
+#include "WormRope.h"
+#include "WormSwarm.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+void benchmarkWorm(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results)
+{
+    for (const std::size_t Segments : sizeSweep(10, 10000))
+    {
+        std::vector<WormSegment> WormSegments(Segments);
+        initializeWorm(WormSegments, sf::Vector2f(800.0f, 450.0f));
+
+        // Lead the head around a circle faster than one segment per step so the whole chain keeps moving
+        float Angle = 0.0f;
+        Results.push_back(runBenchmark("worm", "scalar", Segments, Segments, Options, [&]
+        {
+            Angle += 0.05f;
+            updateWorm(WormSegments, sf::Vector2f(800.0f + 400.0f * std::cos(Angle), 450.0f + 400.0f * std::sin(Angle)));
+        }));
+    }
+
+    // A crowd of exercise-sized worms, each led around its own circle, updated through the shared pool
+    WorkerPool Pool;
+    for (const std::size_t Count : sizeSweep(10, 10000))
+    {
+        std::vector<std::vector<WormSegment>> Worms(Count, std::vector<WormSegment>(NumWormSegments));
+        std::vector<sf::Vector2f> Targets(Count);
+        for (std::size_t I = 0; I < Count; ++I)
+        {
+            initializeWorm(Worms[I], sf::Vector2f(static_cast<float>(I % 100) * 16.0f, static_cast<float>(I / 100) * 9.0f));
+        }
+
+        float Angle = 0.0f;
+        Results.push_back(runBenchmark("worm", "chains pool", Count, Count * NumWormSegments, Options, [&]
+        {
+            Angle += 0.05f;
+            for (std::size_t I = 0; I < Count; ++I)
+            {
+                const float Phase = Angle + static_cast<float>(I);
+                Targets[I] = Worms[I][0].Position + sf::Vector2f(60.0f * std::cos(Phase), 60.0f * std::sin(Phase));
+            }
+            updateWorms(Worms, Targets, Pool);
+        }));
+    }
+}
+
+void benchmarkWormSwarm(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results)
+{
+    // One swarm frame, steering plus the constraint solve, with one element per worm segment: the scalar
+    // reference against the widest vector kernel, each on one thread and across the pool. Steering every
+    // iteration keeps the chains stretching, so the scalar path cannot skip its corrections.
+    WorkerPool SingleThread(1);
+    WorkerPool Pool;
+    const WormIsa Isa = detectWormIsa();
+    for (const std::size_t Count : sizeSweep(1000, Options.Quick ? 100000 : 1000000))
+    {
+        WormSwarm Swarm;
+        initializeWormSwarm(Swarm, Count, sf::Vector2f(1600.0f, 900.0f), 1);
+        const std::size_t Elements = Count * static_cast<std::size_t>(Swarm.SegmentCount);
+
+        for (const WormIsa Variant : { WormIsa::Scalar, Isa })
+        {
+            Results.push_back(runBenchmark("worm_swarm", std::string(wormIsaName(Variant)) + " x1 threads", Count, Elements, Options, [&]
+            {
+                steerWormSwarm(Swarm, 1.0f / 60.0f, SingleThread);
+                updateWormSwarm(Swarm, Variant, SingleThread);
+            }));
+            Results.push_back(runBenchmark("worm_swarm", std::string(wormIsaName(Variant)) + " pool", Count, Elements, Options, [&]
+            {
+                steerWormSwarm(Swarm, 1.0f / 60.0f, Pool);
+                updateWormSwarm(Swarm, Variant, Pool);
+            }));
+        }
+    }
+}
+
+bool verifyWormSwarmKernels()
+{
+    // Every instruction set up to the detected one, as each CPU with a wider set also has the narrower ones
+    const WormIsa Widest = detectWormIsa();
+    bool Passed = true;
+    for (const WormIsa Isa : { WormIsa::Sse2, WormIsa::Avx2, WormIsa::Avx512 })
+    {
+        if (Isa > Widest)
+        {
+            continue;
+        }
+        const float Limit = Isa == WormIsa::Avx512 ? WormSwarmAvx512Tolerance : 0.0f;
+        for (const unsigned Seed : { 1u, 2u, 3u })
+        {
+            const float Error = wormSwarmKernelMaxError(1000, Isa, Seed);
+            const bool Within = Error <= Limit;
+            std::cerr << "  " << wormIsaName(Isa) << ", seed " << Seed << ": max error " << Error << " px, limit " << Limit << " px"
+                << (Within ? "" : " FAILED") << std::endl;
+            Passed = Passed && Within;
+        }
+    }
+    return Passed;
+}
+
+void benchmarkWormCollision(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results)
+{
+    // A swarm frame with and without the collision pass, in a field spread out the way the collision scene
+    // spreads it, with one element per worm segment. Every variant starts from a fresh swarm and runs a fixed
+    // number of seconds of its own frames untimed first, so the timings come from the settled scene rather
+    // than the first frames pushing the initial overlaps apart, and at least one second of frames is timed.
+    // The contacts on the last frame go to stderr.
+    const float DeltaTime = 1.0f / 60.0f;
+    const int WarmupFrames = static_cast<int>((Options.Quick ? 2.0f : 20.0f) / DeltaTime);
+    BenchmarkOptions FrameOptions = Options;
+    FrameOptions.MinIterations = std::max(Options.MinIterations, static_cast<int>(1.0f / DeltaTime));
+    WorkerPool SingleThread(1);
+    WorkerPool Pool;
+    const WormIsa Isa = detectWormIsa();
+    struct CollisionVariant
+    {
+        const char* Name;
+        bool Collide;
+        WorkerPool* Target;
+    };
+    const CollisionVariant Variants[] = { { "no collision pool", false, &Pool }, { "collide x1 threads", true, &SingleThread },
+        { "collide pool", true, &Pool } };
+    for (const std::size_t Count : sizeSweep(1000, Options.Quick ? 10000 : 50000))
+    {
+        const sf::Vector2f Size = wormCollisionFieldSize(Count, NumWormSegments, sf::Vector2f(1600.0f, 900.0f));
+        for (const CollisionVariant& Variant : Variants)
+        {
+            WormSwarm Swarm;
+            initializeWormSwarm(Swarm, Count, Size, 1);
+            const std::size_t Elements = Count * static_cast<std::size_t>(Swarm.SegmentCount);
+            WormCollisionGrid Grid;
+            std::size_t Contacts = 0;
+            const auto Frame = [&]
+            {
+                steerWormSwarm(Swarm, DeltaTime, *Variant.Target);
+                updateWormSwarm(Swarm, Isa, *Variant.Target);
+                if (Variant.Collide)
+                {
+                    Contacts = resolveWormCollisions(Grid, Swarm, *Variant.Target);
+                }
+            };
+
+            for (int I = 0; I < WarmupFrames; ++I)
+            {
+                Frame();
+            }
+            Results.push_back(runBenchmark("worm_collision", Variant.Name, Count, Elements, FrameOptions, Frame));
+            if (Variant.Collide)
+            {
+                std::cerr << "  " << Count << " worms, " << Variant.Name << ": " << Contacts << " contacts on the last frame" << std::endl;
+            }
+        }
+    }
+}
+
+bool verifyWormCollisions()
+{
+    // Seeded swarms at the collision scene's coverage, left to settle without steering, must come apart.
+    // Seed 5 starts with two worms whose links cross once the pass has pushed them.
+    WorkerPool SingleThread(1);
+    WorkerPool Pool(4);
+    constexpr std::size_t Count = 1000;
+    const sf::Vector2f Size = wormCollisionFieldSize(Count, NumWormSegments, sf::Vector2f(1600.0f, 900.0f));
+    bool Passed = true;
+    for (const unsigned Seed : { 1u, 2u, 3u, 4u, 5u })
+    {
+        WormSwarm Swarm;
+        initializeWormSwarm(Swarm, Count, Size, Seed);
+        WormCollisionGrid Grid;
+        for (int Frame = 0; Frame < WormCollisionSettleFrames; ++Frame)
+        {
+            updateWormSwarm(Swarm, WormIsa::Scalar, Pool);
+            resolveWormCollisions(Grid, Swarm, Pool);
+        }
+        const float Overlap = wormSwarmMaxOverlap(Swarm);
+        const bool Within = Overlap <= WormCollisionSettleTolerance;
+        std::cerr << "  seed " << Seed << ": deepest overlap after " << WormCollisionSettleFrames << " settling frames " << Overlap << " px, limit "
+            << WormCollisionSettleTolerance << " px" << (Within ? "" : " FAILED") << std::endl;
+        Passed = Passed && Within;
+    }
+
+    // The same steered run on one thread and across the pool must find the same contacts every frame and
+    // leave every point in the same place
+    constexpr int SteeredFrames = 120;
+    WormSwarm Swarms[2];
+    WormCollisionGrid Grids[2];
+    WorkerPool* Targets[2] = { &SingleThread, &Pool };
+    bool Same = true;
+    for (int Variant = 0; Variant < 2; ++Variant)
+    {
+        initializeWormSwarm(Swarms[Variant], Count, Size, 1);
+    }
+    for (int Frame = 0; Frame < SteeredFrames && Same; ++Frame)
+    {
+        std::size_t Contacts[2];
+        for (int Variant = 0; Variant < 2; ++Variant)
+        {
+            steerWormSwarm(Swarms[Variant], 1.0f / 60.0f, *Targets[Variant]);
+            updateWormSwarm(Swarms[Variant], WormIsa::Scalar, *Targets[Variant]);
+            Contacts[Variant] = resolveWormCollisions(Grids[Variant], Swarms[Variant], *Targets[Variant]);
+        }
+        Same = Contacts[0] == Contacts[1];
+    }
+    const std::size_t Floats = Swarms[0].Stride * static_cast<std::size_t>(Swarms[0].SegmentCount);
+    Same = Same && std::equal(Swarms[0].X, Swarms[0].X + Floats, Swarms[1].X) && std::equal(Swarms[0].Y, Swarms[0].Y + Floats, Swarms[1].Y);
+    std::cerr << "  " << SteeredFrames << " steered frames on 1 and " << Pool.threadCount() << " threads: " << (Same ? "identical" : "different FAILED")
+        << std::endl;
+    return Passed && Same;
+}
+
+namespace
+{
+    // The scripted rope run the benchmark reports and --verify checks: a fresh rope as long as the worm led
+    // round a circle at 60 Hz, starting with a jump from its rest pose to the circle
+    constexpr int RopeScriptedUpdates = 120;
+
+    void restartScriptedRope(WormRope& Rope, const std::size_t Points)
+    {
+        initializeWormRope(Rope, Points, sf::Vector2f(800.0f, 450.0f), 450.0f / static_cast<float>(Points - 1));
+    }
+
+    void updateScriptedRope(WormRope& Rope, const int Update, const RopeSettings& Settings, WorkerPool& Pool)
+    {
+        const float Angle = 0.05f * static_cast<float>(Update + 1);
+        updateWormRope(Rope, sf::Vector2f(800.0f + 400.0f * std::cos(Angle), 450.0f + 400.0f * std::sin(Angle)), 1.0f / 60.0f, Settings, Pool);
+    }
+}
+
+void benchmarkWormRope(const BenchmarkOptions& Options, std::vector<BenchmarkResult>& Results)
+{
+    // One rope update per iteration with the default substeps and iterations, the head led around a circle,
+    // with one element per link solved: every solver on one thread, and the parallel ones across the pool.
+    // The quality side of the trade-off goes to stderr: how far each iteration got on the last of the fixed
+    // scripted run from a fresh rope, so every variant reports the same state.
+    WorkerPool SingleThread(1);
+    WorkerPool Pool;
+    struct RopeVariant
+    {
+        RopeSolver Solver;
+        WorkerPool* Target;
+    };
+    const RopeVariant Variants[] = { { RopeSolver::GaussSeidel, &SingleThread }, { RopeSolver::Jacobi, &SingleThread }, { RopeSolver::Jacobi, &Pool },
+        { RopeSolver::Colored, &SingleThread }, { RopeSolver::Colored, &Pool } };
+    for (const std::size_t Points : sizeSweep(10, Options.Quick ? 10000 : 100000))
+    {
+        for (const RopeVariant& Variant : Variants)
+        {
+            RopeSettings Settings;
+            Settings.Solver = Variant.Solver;
+            WormRope Rope;
+            const std::size_t Elements = (Points - 1) * static_cast<std::size_t>(Settings.Substeps * Settings.Iterations);
+            const std::string Name = std::string(ropeSolverName(Variant.Solver)) + (Variant.Target == &Pool ? " pool" : " x1 threads");
+
+            restartScriptedRope(Rope, Points);
+            int Update = 0;
+            Results.push_back(runBenchmark("worm_rope", Name, Points, Elements, Options, [&]
+            {
+                updateScriptedRope(Rope, Update++, Settings, *Variant.Target);
+            }));
+
+            restartScriptedRope(Rope, Points);
+            for (int I = 0; I < RopeScriptedUpdates; ++I)
+            {
+                updateScriptedRope(Rope, I, Settings, *Variant.Target);
+            }
+            std::cerr << "  " << Points << " points, " << Name << ": largest link residual by iteration after " << RopeScriptedUpdates << " updates";
+            for (std::size_t I = 0; I + 1 < Rope.IterationError.size(); ++I)
+            {
+                std::cerr << ' ' << Rope.IterationError[I];
+            }
+            std::cerr << " px, " << Rope.IterationError.back() << " px left, " << Rope.TetherCorrection << " px tether correction" << std::endl;
+        }
+    }
+}
+
+bool verifyWormRopeSolvers()
+{
+    // Every solver on the scripted run, at the worm's own rope and a longer one. No iteration may leave more
+    // than the one before, and the last must leave less than the bound. The parallel solvers must also give
+    // the same rope on one thread as across the pool.
+    WorkerPool SingleThread(1);
+    WorkerPool Pool(4);
+    bool Passed = true;
+    for (const std::size_t Points : { static_cast<std::size_t>(NumWormSegments), std::size_t{ 100 } })
+    {
+        for (const RopeSolver Solver : { RopeSolver::GaussSeidel, RopeSolver::Jacobi, RopeSolver::Colored })
+        {
+            RopeSettings Settings;
+            Settings.Solver = Solver;
+            WormRope Ropes[2];
+            WorkerPool* Targets[2] = { &SingleThread, &Pool };
+            const int Variants = Solver == RopeSolver::GaussSeidel ? 1 : 2;
+            for (int Variant = 0; Variant < Variants; ++Variant)
+            {
+                restartScriptedRope(Ropes[Variant], Points);
+                for (int I = 0; I < RopeScriptedUpdates; ++I)
+                {
+                    updateScriptedRope(Ropes[Variant], I, Settings, *Targets[Variant]);
+                }
+            }
+
+            const std::vector<float>& Error = Ropes[0].IterationError;
+            const bool Converging = std::is_sorted(Error.rbegin(), Error.rend());
+            const bool Within = Error.back() <= RopeScriptedResidualTolerance;
+            const bool Same = Variants == 1 || Ropes[0].Position == Ropes[1].Position;
+            std::cerr << "  " << Points << " points, " << ropeSolverName(Solver) << ": by iteration";
+            for (const float Value : Error)
+            {
+                std::cerr << ' ' << Value;
+            }
+            std::cerr << " px, limit " << RopeScriptedResidualTolerance << " px" << (Converging ? "" : ", growing") << (Same ? "" : ", thread dependent")
+                << (Converging && Within && Same ? "" : " FAILED") << std::endl;
+            Passed = Passed && Converging && Within && Same;
+        }
+    }
+    return Passed;
+}
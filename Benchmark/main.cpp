@@ -0,0 +1,243 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+
+std::vector<std::size_t> sizeSweep(const std::size_t Min, const std::size_t Max)
+{
+    std::vector<std::size_t> Sizes;
+    for (std::size_t Size = Min; Size < Max; Size *= 10)
+    {
+        Sizes.push_back(Size);
+    }
+    Sizes.push_back(Max);
+    return Sizes;
+}
+
+void writeBenchmarkJson(std::ostream& Stream, const std::vector<BenchmarkResult>& Results)
+{
+    Stream << std::setprecision(6) << "{\n  \"results\": [\n";
+    for (std::size_t I = 0; I < Results.size(); ++I)
+    {
+        const BenchmarkResult& Result = Results[I];
+        Stream << "    { \"kernel\": \"" << Result.Kernel << "\", \"variant\": \"" << Result.Variant << "\""
+            << ", \"size\": " << Result.Size
+            << ", \"elements\": " << Result.Elements
+            << ", \"iterations\": " << Result.Iterations
+            << ", \"ns_per_element\": " << Result.NsPerElement
+            << ", \"elements_per_second\": " << Result.ElementsPerSecond
+            << ", \"p50_ns\": " << Result.P50Ns
+            << ", \"p99_ns\": " << Result.P99Ns << " }"
+            << (I + 1 < Results.size() ? ",\n" : "\n");
+    }
+    Stream << "  ]\n}\n";
+}
+
+namespace
+{
+    // Every kernel --kernel accepts, in the order a full run goes through them
+    constexpr const char* KernelNames[] = { "grass", "grass_segments", "grass_pose_cache", "grass_wind", "grass_dynamics", "grass_time_slice",
+        "grass_displacement", "grass_snapshot", "grass_world", "worm", "worm_swarm", "worm_collision", "worm_rope", "arm", "bezier", "raster",
+        "vector_math" };
+
+    void printUsage()
+    {
+        std::cerr << "Usage: KernelBenchmark [--quick] [--kernel ";
+        for (std::size_t I = 0; I < std::size(KernelNames); ++I)
+        {
+            std::cerr << (I == 0 ? "" : "|") << KernelNames[I];
+        }
+        std::cerr << "] [--min-time seconds] [--out file.json] [--verify]" << std::endl;
+    }
+}
+
+int main(int Argc, char* Argv[])
+{
+    BenchmarkOptions Options;
+    const char* Only = nullptr;
+    const char* OutputPath = nullptr;
+    bool Verify = false;
+    for (int I = 1; I < Argc; ++I)
+    {
+        if (std::strcmp(Argv[I], "--quick") == 0)
+        {
+            Options.Quick = true;
+            Options.MinSeconds = 0.02;
+            Options.MinIterations = 3;
+        }
+        else if (std::strcmp(Argv[I], "--kernel") == 0 && I + 1 < Argc)
+        {
+            Only = Argv[++I];
+        }
+        else if (std::strcmp(Argv[I], "--out") == 0 && I + 1 < Argc)
+        {
+            OutputPath = Argv[++I];
+        }
+        else if (std::strcmp(Argv[I], "--verify") == 0)
+        {
+            Verify = true;
+        }
+        else if (std::strcmp(Argv[I], "--min-time") == 0 && I + 1 < Argc)
+        {
+            Options.MinSeconds = std::atof(Argv[++I]);
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    // A mistyped kernel would otherwise select nothing, and --verify would pass without checking anything
+    if (Only != nullptr && std::none_of(std::begin(KernelNames), std::end(KernelNames), [Only](const char* Kernel) { return std::strcmp(Only, Kernel) == 0; }))
+    {
+        std::cerr << "Unknown kernel " << Only << std::endl;
+        printUsage();
+        return 1;
+    }
+
+    const auto Selected = [Only](const char* Kernel) { return Only == nullptr || std::strcmp(Only, Kernel) == 0; };
+
+    // Pass/fail accuracy of the vector kernels against their scalar references and of the order-sensitive
+    // solvers, for CTest
+    if (Verify)
+    {
+        bool Passed = true;
+        int Checked = 0;
+        if (Selected("grass"))
+        {
+            std::cerr << "Verifying grass..." << std::endl;
+            Passed = verifyGrassKernels() && Passed;
+            ++Checked;
+        }
+        if (Selected("worm_swarm"))
+        {
+            std::cerr << "Verifying worm_swarm..." << std::endl;
+            Passed = verifyWormSwarmKernels() && Passed;
+            ++Checked;
+        }
+        if (Selected("worm_collision"))
+        {
+            std::cerr << "Verifying worm_collision..." << std::endl;
+            Passed = verifyWormCollisions() && Passed;
+            ++Checked;
+        }
+        if (Selected("worm_rope"))
+        {
+            std::cerr << "Verifying worm_rope..." << std::endl;
+            Passed = verifyWormRopeSolvers() && Passed;
+            ++Checked;
+        }
+        if (Checked == 0)
+        {
+            std::cerr << "No accuracy check for kernel " << Only << std::endl;
+            return 1;
+        }
+        std::cerr << (Passed ? "All kernels within their bounds" : "Kernel accuracy check FAILED") << std::endl;
+        return Passed ? 0 : 1;
+    }
+
+    // Progress goes to stderr so stdout stays valid JSON
+    std::vector<BenchmarkResult> Results;
+    if (Selected("grass"))
+    {
+        std::cerr << "Running grass..." << std::endl;
+        benchmarkGrass(Options, Results);
+    }
+    if (Selected("grass_segments"))
+    {
+        std::cerr << "Running grass_segments..." << std::endl;
+        benchmarkGrassSegments(Options, Results);
+    }
+    if (Selected("grass_pose_cache"))
+    {
+        std::cerr << "Running grass_pose_cache..." << std::endl;
+        benchmarkGrassPoseCache(Options, Results);
+    }
+    if (Selected("grass_wind"))
+    {
+        std::cerr << "Running grass_wind..." << std::endl;
+        benchmarkGrassWind(Options, Results);
+    }
+    if (Selected("grass_dynamics"))
+    {
+        std::cerr << "Running grass_dynamics..." << std::endl;
+        benchmarkGrassDynamics(Options, Results);
+    }
+    if (Selected("grass_time_slice"))
+    {
+        std::cerr << "Running grass_time_slice..." << std::endl;
+        benchmarkGrassTimeSlice(Options, Results);
+    }
+    if (Selected("grass_displacement"))
+    {
+        std::cerr << "Running grass_displacement..." << std::endl;
+        benchmarkGrassDisplacement(Options, Results);
+    }
+    if (Selected("grass_snapshot"))
+    {
+        std::cerr << "Running grass_snapshot..." << std::endl;
+        benchmarkGrassSnapshot(Options, Results);
+    }
+    if (Selected("grass_world"))
+    {
+        std::cerr << "Running grass_world..." << std::endl;
+        benchmarkGrassWorld(Options, Results);
+    }
+    if (Selected("worm"))
+    {
+        std::cerr << "Running worm..." << std::endl;
+        benchmarkWorm(Options, Results);
+    }
+    if (Selected("worm_swarm"))
+    {
+        std::cerr << "Running worm_swarm..." << std::endl;
+        benchmarkWormSwarm(Options, Results);
+    }
+    if (Selected("worm_collision"))
+    {
+        std::cerr << "Running worm_collision..." << std::endl;
+        benchmarkWormCollision(Options, Results);
+    }
+    if (Selected("worm_rope"))
+    {
+        std::cerr << "Running worm_rope..." << std::endl;
+        benchmarkWormRope(Options, Results);
+    }
+    if (Selected("arm"))
+    {
+        std::cerr << "Running arm..." << std::endl;
+        benchmarkArm(Options, Results);
+    }
+    if (Selected("bezier"))
+    {
+        std::cerr << "Running bezier..." << std::endl;
+        benchmarkBezier(Options, Results);
+    }
+    if (Selected("raster"))
+    {
+        std::cerr << "Running raster..." << std::endl;
+        benchmarkSoftwareRaster(Options, Results);
+    }
+    if (Selected("vector_math"))
+    {
+        std::cerr << "Running vector_math..." << std::endl;
+        benchmarkVectorMath(Options, Results);
+    }
+
+    if (OutputPath != nullptr)
+    {
+        std::ofstream File(OutputPath);
+        writeBenchmarkJson(File, Results);
+    }
+    else
+    {
+        writeBenchmarkJson(std::cout, Results);
+    }
+    return 0;
+}
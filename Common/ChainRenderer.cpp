@@ -0,0 +1,119 @@
+#include "ChainRenderer.h"
+
+#include "VectorMath.h"
+
+namespace
+{
+    // Points on every arc: the two ends and three bisections, so no step is wider than 45 degrees
+    constexpr std::size_t ArcPoints = 5;
+
+    // Unit vector 90 degrees clockwise from the segment A to B, or straight down for a zero-length segment,
+    // matching the side the rectangles were thickened towards
+    sf::Vector2f segmentNormal(const sf::Vector2f A, const sf::Vector2f B)
+    {
+        const sf::Vector2f Direction = B - A;
+        const float LengthSquared = Direction.x * Direction.x + Direction.y * Direction.y;
+        return LengthSquared > FastMinLengthSquared ? sf::Vector2f(-Direction.y, Direction.x) * fastInverseSqrt(LengthSquared) : sf::Vector2f(0.0f, 1.0f);
+    }
+
+    // Direction along the segment whose normal is Normal
+    sf::Vector2f normalDirection(const sf::Vector2f Normal)
+    {
+        return sf::Vector2f(Normal.y, -Normal.x);
+    }
+
+    // Unit vector halfway round the shorter arc from U to V. Opposite vectors have no shorter arc, so those
+    // go round through the direction of U's segment, the outside of a hairpin.
+    sf::Vector2f bisect(const sf::Vector2f U, const sf::Vector2f V)
+    {
+        const sf::Vector2f Sum = U + V;
+        return Sum.x * Sum.x + Sum.y * Sum.y > 1e-6f ? fastNormalize(Sum) : normalDirection(U);
+    }
+
+    void writePair(sf::Vertex*& Out, const sf::Vector2f A, const sf::Vector2f B, const sf::Color Color)
+    {
+        Out->position = A;
+        Out->color = Color;
+        ++Out;
+        Out->position = B;
+        Out->color = Color;
+        ++Out;
+    }
+
+    // A fan around Centre from Radius * From through Radius * Middle to Radius * To, as strip pairs that each
+    // repeat the centre. Middle must be within 90 degrees of both ends.
+    void writeArc(sf::Vertex*& Out, const sf::Vector2f Centre, const float Radius, const sf::Vector2f From, const sf::Vector2f Middle,
+        const sf::Vector2f To, const sf::Color Color)
+    {
+        const sf::Vector2f Arc[ArcPoints] = { From, bisect(From, Middle), Middle, bisect(Middle, To), To };
+        for (const sf::Vector2f Unit : Arc)
+        {
+            writePair(Out, Centre, Centre + Unit * Radius, Color);
+        }
+    }
+}
+
+std::size_t chainStripVertexCount(const std::size_t Points, const ChainStyle& Style)
+{
+    if (Points < 2)
+    {
+        return 0;
+    }
+    const std::size_t PerJoint = Style.Join == ChainJoin::Round ? ArcPoints * 2 : 4;
+    const std::size_t PerCap = Style.Cap == ChainCap::Round ? ArcPoints * 2 : 0;
+    return 4 + (Points - 2) * PerJoint + 2 * PerCap;
+}
+
+void writeChainStrip(sf::Vertex* Out, const sf::Vector2f* Points, const std::size_t Count, const ChainStyle& Style)
+{
+    if (Count < 2)
+    {
+        return;
+    }
+    const float Thickness = Style.Thickness;
+    const float CapRadius = Thickness * 0.5f;
+
+    // Each segment is the quad between the pair at its start and the pair at its end, the point and the
+    // point pushed out along the segment's normal. A joint's pairs turn from one normal to the next.
+    sf::Vector2f Normal = segmentNormal(Points[0], Points[1]);
+    if (Style.Cap == ChainCap::Round)
+    {
+        const sf::Vector2f Back = -normalDirection(Normal);
+        writeArc(Out, Points[0] + Normal * CapRadius, CapRadius, -Normal, Back, Normal, Style.Color);
+    }
+    writePair(Out, Points[0], Points[0] + Normal * Thickness, Style.Color);
+
+    for (std::size_t I = 1; I + 1 < Count; ++I)
+    {
+        const sf::Vector2f Point = Points[I];
+        const sf::Vector2f Next = segmentNormal(Point, Points[I + 1]);
+        if (Style.Join == ChainJoin::Round)
+        {
+            writeArc(Out, Point, Thickness, Normal, bisect(Normal, Next), Next, Style.Color);
+        }
+        else
+        {
+            // The edges meet Thickness / cos(half the turn) from the point, along the sum of the normals
+            const float CosTurn = Normal.x * Next.x + Normal.y * Next.y;
+            if (1.0f + CosTurn > 2.0f / (ChainMiterLimit * ChainMiterLimit))
+            {
+                const sf::Vector2f Miter = Point + (Normal + Next) * (Thickness / (1.0f + CosTurn));
+                writePair(Out, Point, Miter, Style.Color);
+                writePair(Out, Point, Miter, Style.Color);
+            }
+            else
+            {
+                writePair(Out, Point, Point + Normal * Thickness, Style.Color);
+                writePair(Out, Point, Point + Next * Thickness, Style.Color);
+            }
+        }
+        Normal = Next;
+    }
+
+    const sf::Vector2f Last = Points[Count - 1];
+    writePair(Out, Last, Last + Normal * Thickness, Style.Color);
+    if (Style.Cap == ChainCap::Round)
+    {
+        writeArc(Out, Last + Normal * CapRadius, CapRadius, Normal, normalDirection(Normal), -Normal, Style.Color);
+    }
+}
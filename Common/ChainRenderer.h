@@ -0,0 +1,125 @@
+#pragma once
+
+#include "FrameArena.h"
+#include "WorkerPool.h"
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <cstddef>
+#include <span>
+
+// How the band turns at a point between two segments. Both close the wedge the separate rectangles left on
+// the outside of a bend. Round fills it with an arc around the point and keeps every pixel the rectangles
+// covered. Miter extends both edges until they meet, which also trims the rectangles' corners on the inside
+// of a bend, and cuts the corner off where the edges would meet more than ChainMiterLimit thicknesses away.
+enum class ChainJoin
+{
+    Round,
+    Miter
+};
+
+// How the band ends at the first and last point: Butt stops square at the point as the rectangles did, Round
+// adds a half disc across the band's width
+enum class ChainCap
+{
+    Butt,
+    Round
+};
+
+struct ChainStyle
+{
+    float Thickness = 6.0f; // Extends 90 degrees clockwise from every segment, like a rotated rectangle at its start
+    sf::Color Color = sf::Color::White;
+    ChainJoin Join = ChainJoin::Round;
+    ChainCap Cap = ChainCap::Butt;
+};
+
+constexpr float ChainMiterLimit = 4.0f;
+
+// Strip vertices of one chain of Points points, the same for any shape, so every chain's place in a batch is
+// known up front
+std::size_t chainStripVertexCount(std::size_t Points, const ChainStyle& Style);
+
+// Writes one chain as a triangle strip over chainStripVertexCount(Count, Style) vertices at Out, in one pass
+// over the points. Only the position and colour of each vertex are set.
+void writeChainStrip(sf::Vertex* Out, const sf::Vector2f* Points, std::size_t Count, const ChainStyle& Style);
+
+// Builds Chains chains of PointsPerChain points each, Position(Chain, Point), into one sf::TriangleStrip from
+// the frame arena. Consecutive chains are stitched with a repeated vertex at either side, whose zero-area
+// triangles draw nothing, so any number of chains is a single draw call.
+template <class PositionFn>
+std::span<const sf::Vertex> buildChainStrip(const std::size_t Chains, const std::size_t PointsPerChain, const ChainStyle& Style, FrameArena& Arena,
+    PositionFn&& Position)
+{
+    if (Chains == 0 || PointsPerChain < 2)
+    {
+        return {};
+    }
+    const std::size_t PerChain = chainStripVertexCount(PointsPerChain, Style);
+    const std::span<sf::Vertex> Vertices = Arena.allocate<sf::Vertex>(Chains * PerChain + (Chains - 1) * 2);
+    const std::span<sf::Vector2f> Points = Arena.allocate<sf::Vector2f>(PointsPerChain);
+
+    sf::Vertex* Out = Vertices.data();
+    for (std::size_t Chain = 0; Chain < Chains; ++Chain)
+    {
+        for (std::size_t Point = 0; Point < PointsPerChain; ++Point)
+        {
+            Points[Point] = Position(Chain, Point);
+        }
+        if (Chain == 0)
+        {
+            writeChainStrip(Out, Points.data(), PointsPerChain, Style);
+        }
+        else
+        {
+            // The previous chain's last vertex, then this chain's first
+            Out += 2;
+            writeChainStrip(Out, Points.data(), PointsPerChain, Style);
+            Out[-2] = Out[-3];
+            Out[-1] = Out[0];
+        }
+        Out += PerChain;
+    }
+    return Vertices;
+}
+
+// Same, with the chains split across the pool and Position called from any of its threads. Every chain's
+// place in the batch is known up front, so each one writes its own vertices and both stitch vertices around
+// it without waiting on its neighbours.
+template <class PositionFn>
+std::span<const sf::Vertex> buildChainStrip(const std::size_t Chains, const std::size_t PointsPerChain, const ChainStyle& Style, FrameArena& Arena,
+    WorkerPool& Pool, PositionFn&& Position)
+{
+    if (Chains == 0 || PointsPerChain < 2)
+    {
+        return {};
+    }
+    const std::size_t PerChain = chainStripVertexCount(PointsPerChain, Style);
+    const std::span<sf::Vertex> Vertices = Arena.allocate<sf::Vertex>(Chains * PerChain + (Chains - 1) * 2);
+    const std::span<sf::Vector2f> Points = Arena.allocate<sf::Vector2f>(Chains * PointsPerChain);
+
+    Pool.parallelFor(Chains, [&](const std::size_t Begin, const std::size_t End)
+    {
+        for (std::size_t Chain = Begin; Chain < End; ++Chain)
+        {
+            sf::Vector2f* ChainPoints = Points.data() + Chain * PointsPerChain;
+            for (std::size_t Point = 0; Point < PointsPerChain; ++Point)
+            {
+                ChainPoints[Point] = Position(Chain, Point);
+            }
+            sf::Vertex* Out = Vertices.data() + Chain * (PerChain + 2);
+            writeChainStrip(Out, ChainPoints, PointsPerChain, Style);
+
+            // This chain's first vertex repeated before it, and its last after it
+            if (Chain > 0)
+            {
+                Out[-1] = Out[0];
+            }
+            if (Chain + 1 < Chains)
+            {
+                Out[PerChain] = Out[PerChain - 1];
+            }
+        }
+    });
+    return Vertices;
+}
@@ -0,0 +1,60 @@
+#include "CpuFeatures.h"
+
+#if CPU_FEATURES_X86 && defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+#if CPU_FEATURES_X86 && defined(_MSC_VER)
+namespace
+{
+    // XCR0 bits the OS must have enabled, or 0 when it does not use XSAVE at all
+    unsigned long long enabledRegisterState()
+    {
+        int Info[4];
+        __cpuid(Info, 1);
+        const bool OsSaves = (Info[2] & (1 << 27)) != 0;
+        return OsSaves ? _xgetbv(0) : 0;
+    }
+}
+
+bool cpuHasAvx2()
+{
+    int Info[4];
+    __cpuid(Info, 1);
+    const bool HasFma = (Info[2] & (1 << 12)) != 0;
+    __cpuidex(Info, 7, 0);
+    return (enabledRegisterState() & 0x6) == 0x6 && HasFma && (Info[1] & (1 << 5)) != 0;
+}
+
+bool cpuHasAvx512()
+{
+    // The opmask and ZMM state as well as YMM
+    int Info[4];
+    __cpuidex(Info, 7, 0);
+    return (enabledRegisterState() & 0xE6) == 0xE6 && (Info[1] & (1 << 16)) != 0;
+}
+#elif CPU_FEATURES_X86
+// __builtin_cpu_supports also checks that the OS has enabled the extended register state
+bool cpuHasAvx2()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+}
+
+bool cpuHasAvx512()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f");
+}
+#else
+bool cpuHasAvx2()
+{
+    return false;
+}
+
+bool cpuHasAvx512()
+{
+    return false;
+}
+#endif
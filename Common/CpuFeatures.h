@@ -0,0 +1,13 @@
+#pragma once
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CPU_FEATURES_X86 1
+#else
+#define CPU_FEATURES_X86 0
+#endif
+
+// Runtime checks for the instruction set extensions the vector kernels are built for. Each also checks
+// that the OS saves the wider register state on context switches. SSE2 is part of every x86-64 CPU and
+// needs no check; off x86 both are always false.
+bool cpuHasAvx2();   // AVX2 and FMA
+bool cpuHasAvx512(); // AVX-512F
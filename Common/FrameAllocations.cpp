@@ -0,0 +1,100 @@
+#include "FrameAllocations.h"
+
+#include <cassert>
+#include <cstdio>
+
+#ifdef FRAME_ALLOCATION_CHECK
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace
+{
+    thread_local std::uint64_t AllocationCount = 0;
+
+    void* countedAllocate(const std::size_t Size)
+    {
+        ++AllocationCount;
+        if (void* Memory = std::malloc(Size ? Size : 1))
+        {
+            return Memory;
+        }
+        throw std::bad_alloc();
+    }
+
+    void* countedAllocateAligned(const std::size_t Size, const std::align_val_t Alignment)
+    {
+        ++AllocationCount;
+        const std::size_t Bytes = static_cast<std::size_t>(Alignment);
+#ifdef _WIN32
+        void* Memory = _aligned_malloc(Size ? Size : 1, Bytes);
+#else
+        // aligned_alloc wants the size to be a multiple of the alignment
+        void* Memory = std::aligned_alloc(Bytes, std::max(Bytes, (Size + Bytes - 1) / Bytes * Bytes));
+#endif
+        if (Memory)
+        {
+            return Memory;
+        }
+        throw std::bad_alloc();
+    }
+
+    void alignedFree(void* Memory)
+    {
+#ifdef _WIN32
+        _aligned_free(Memory);
+#else
+        std::free(Memory);
+#endif
+    }
+}
+
+std::uint64_t threadAllocationCount()
+{
+    return AllocationCount;
+}
+
+// Replacements for the global allocation functions. The nothrow forms are left to the standard library,
+// which implements them on top of these.
+void* operator new(const std::size_t Size) { return countedAllocate(Size); }
+void* operator new[](const std::size_t Size) { return countedAllocate(Size); }
+void* operator new(const std::size_t Size, const std::align_val_t Alignment) { return countedAllocateAligned(Size, Alignment); }
+void* operator new[](const std::size_t Size, const std::align_val_t Alignment) { return countedAllocateAligned(Size, Alignment); }
+
+void operator delete(void* Memory) noexcept { std::free(Memory); }
+void operator delete[](void* Memory) noexcept { std::free(Memory); }
+void operator delete(void* Memory, std::size_t) noexcept { std::free(Memory); }
+void operator delete[](void* Memory, std::size_t) noexcept { std::free(Memory); }
+void operator delete(void* Memory, std::align_val_t) noexcept { alignedFree(Memory); }
+void operator delete[](void* Memory, std::align_val_t) noexcept { alignedFree(Memory); }
+void operator delete(void* Memory, std::size_t, std::align_val_t) noexcept { alignedFree(Memory); }
+void operator delete[](void* Memory, std::size_t, std::align_val_t) noexcept { alignedFree(Memory); }
+
+#else
+
+std::uint64_t threadAllocationCount()
+{
+    return 0;
+}
+
+#endif
+
+void FrameAllocationCheck::beginFrame()
+{
+    Allowed = false;
+    StartCount = threadAllocationCount();
+}
+
+void FrameAllocationCheck::endFrame()
+{
+    const std::uint64_t Allocations = threadAllocationCount() - StartCount;
+    if (++Frame > WarmupFrames && !Allowed && Allocations != 0)
+    {
+        std::fprintf(stderr, "Frame %lld made %llu heap allocation(s) in steady state\n", Frame, static_cast<unsigned long long>(Allocations));
+        assert(Allocations == 0 && "steady-state frame allocated");
+    }
+}
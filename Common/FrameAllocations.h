@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+
+// Heap allocation counting for the frame loops. Built with FRAME_ALLOCATION_CHECK defined, the global
+// operator new is replaced by one that counts every allocation made on the calling thread; without it the
+// counter always reads 0 and the check below does nothing.
+std::uint64_t threadAllocationCount();
+
+// Asserts that a steady-state frame made no heap allocations on the main thread. The first WarmupFrames
+// frames are skipped while persistent buffers grow to size, and a frame that knowingly allocates (window
+// title update, newly generated chunks, text in the debug overlay) calls allowAllocations() to be skipped too.
+class FrameAllocationCheck
+{
+public:
+    explicit FrameAllocationCheck(int WarmupFrames = 120) : WarmupFrames(WarmupFrames) {}
+
+    void beginFrame();
+    void allowAllocations() { Allowed = true; }
+    void endFrame();
+
+private:
+    int WarmupFrames;
+    long long Frame = 0;
+    std::uint64_t StartCount = 0;
+    bool Allowed = false;
+};
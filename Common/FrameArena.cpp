@@ -0,0 +1,50 @@
+#include "FrameArena.h"
+
+#include <algorithm>
+
+FrameArena::FrameArena(const std::size_t InitialBytes)
+{
+    Blocks.reserve(8);
+    Blocks.push_back(Block{ std::make_unique<std::byte[]>(InitialBytes), InitialBytes });
+}
+
+void FrameArena::reset()
+{
+    PeakBytes = std::max(PeakBytes, FrameBytes);
+    if (Blocks.size() > 1)
+    {
+        // Last frame overflowed: swap all its blocks for one that holds the largest frame seen so far
+        const std::size_t Size = std::max(PeakBytes, capacity());
+        Blocks.clear();
+        Blocks.push_back(Block{ std::make_unique<std::byte[]>(Size), Size });
+    }
+    Offset = 0;
+    FrameBytes = 0;
+}
+
+std::size_t FrameArena::capacity() const
+{
+    std::size_t Total = 0;
+    for (const Block& Current : Blocks)
+    {
+        Total += Current.Size;
+    }
+    return Total;
+}
+
+void* FrameArena::allocateBytes(const std::size_t Bytes, const std::size_t Alignment)
+{
+    // Blocks come from new[], so their start is aligned for any fundamental type and only the offset needs rounding
+    std::size_t Aligned = (Offset + Alignment - 1) / Alignment * Alignment;
+    if (Aligned + Bytes > Blocks.back().Size)
+    {
+        const std::size_t Size = std::max(Bytes, Blocks.back().Size);
+        Blocks.push_back(Block{ std::make_unique<std::byte[]>(Size), Size });
+        Offset = 0;
+        Aligned = 0;
+    }
+
+    FrameBytes += Aligned - Offset + Bytes;
+    Offset = Aligned + Bytes;
+    return Blocks.back().Memory.get() + Aligned;
+}
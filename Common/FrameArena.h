@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+// Bump allocator for geometry that only lives for one frame. Everything handed out is released at once by
+// reset() at the start of the next frame. A frame that needs more than the current block spills into extra
+// blocks, and the next reset() replaces them with a single block big enough for that whole frame, so once
+// the loop has seen its largest frame it never touches the heap again.
+class FrameArena
+{
+public:
+    explicit FrameArena(std::size_t InitialBytes = 64 * 1024);
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // Starts a new frame; every span handed out since the last reset becomes invalid
+    void reset();
+
+    // Count default-constructed elements of a type that needs no destructor
+    template <typename T>
+    std::span<T> allocate(const std::size_t Count)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "FrameArena never runs destructors");
+        T* Elements = static_cast<T*>(allocateBytes(Count * sizeof(T), alignof(T)));
+        for (std::size_t I = 0; I < Count; ++I)
+        {
+            ::new (static_cast<void*>(Elements + I)) T();
+        }
+        return std::span<T>(Elements, Count);
+    }
+
+    std::size_t capacity() const; // Bytes currently reserved across all blocks
+    std::size_t peakBytes() const { return PeakBytes; } // Most bytes any single frame has used
+
+private:
+    struct Block
+    {
+        std::unique_ptr<std::byte[]> Memory;
+        std::size_t Size = 0;
+    };
+
+    void* allocateBytes(std::size_t Bytes, std::size_t Alignment);
+
+    std::vector<Block> Blocks;
+    std::size_t Offset = 0;     // Bytes used in the last block
+    std::size_t FrameBytes = 0; // Bytes used this frame across all blocks, including alignment padding
+    std::size_t PeakBytes = 0;
+};
@@ -0,0 +1,107 @@
+#include "FrameOverlay.h"
+
+#include <SFML/Graphics/RectangleShape.hpp>
+#include <SFML/Graphics/Text.hpp>
+#include <SFML/Graphics/View.hpp>
+#include <algorithm>
+#include <cstdio>
+
+namespace
+{
+    constexpr float OverlayLeft = 10.0f;
+    constexpr float OverlayTop = 10.0f;
+    constexpr float RowHeight = 18.0f;
+    constexpr float LabelWidth = 330.0f;
+    constexpr float BarWidth = 200.0f;
+    constexpr unsigned TextSize = 13;
+
+    const char* const FontPaths[] = {
+        "C:/Windows/Fonts/consola.ttf",
+        "C:/Windows/Fonts/arial.ttf",
+        "/usr/share/fonts/truetype/dejavu/DejaVuSansMono.ttf",
+        "/usr/share/fonts/TTF/DejaVuSansMono.ttf",
+        "/usr/share/fonts/dejavu/DejaVuSansMono.ttf",
+        "/System/Library/Fonts/Menlo.ttc",
+    };
+}
+
+bool loadFrameOverlayFont(FrameOverlay& Overlay)
+{
+    for (const char* Path : FontPaths)
+    {
+        if (Overlay.Font.loadFromFile(Path))
+        {
+            Overlay.HasFont = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+void handleFrameOverlayEvent(FrameOverlay& Overlay, const sf::Event& Event)
+{
+    if (Event.type == sf::Event::KeyPressed && Event.key.code == sf::Keyboard::F3)
+    {
+        Overlay.Visible = !Overlay.Visible;
+    }
+}
+
+void drawFrameOverlay(sf::RenderTarget& Target, const FrameOverlay& Overlay, const FrameProfiler& Profiler)
+{
+    if (!Overlay.Visible)
+    {
+        return;
+    }
+
+    const sf::View PreviousView = Target.getView();
+    Target.setView(Target.getDefaultView());
+
+    // The whole frame is the last row and sets the bar scale
+    const int Rows = Profiler.phaseCount() + 1;
+    const FrameProfiler::PhaseStats Frame = Profiler.phaseStats(Profiler.phaseCount());
+    const float MsToPixels = BarWidth / static_cast<float>(std::max(Frame.P99Ms, 1.0));
+    const float TextWidth = Overlay.HasFont ? LabelWidth : 0.0f;
+
+    sf::RectangleShape Background(sf::Vector2f(TextWidth + BarWidth + 20.0f, static_cast<float>(Rows) * RowHeight + 10.0f));
+    Background.setPosition(OverlayLeft, OverlayTop);
+    Background.setFillColor(sf::Color(0, 0, 0, 170));
+    Target.draw(Background);
+
+    sf::RectangleShape Bar;
+    sf::Text Label;
+    if (Overlay.HasFont)
+    {
+        Label.setFont(Overlay.Font);
+        Label.setCharacterSize(TextSize);
+        Label.setFillColor(sf::Color::White);
+    }
+
+    for (int Row = 0; Row < Rows; ++Row)
+    {
+        const FrameProfiler::PhaseStats Stats = Row == Profiler.phaseCount() ? Frame : Profiler.phaseStats(Row);
+        const float Y = OverlayTop + 5.0f + static_cast<float>(Row) * RowHeight;
+
+        if (Overlay.HasFont)
+        {
+            char Line[128];
+            std::snprintf(Line, sizeof(Line), "%-8s min %6.2f  avg %6.2f  p99 %6.2f ms",
+                Row == Profiler.phaseCount() ? "frame" : Profiler.phaseName(Row).c_str(), Stats.MinMs, Stats.AvgMs, Stats.P99Ms);
+            Label.setString(Line);
+            Label.setPosition(OverlayLeft + 5.0f, Y);
+            Target.draw(Label);
+        }
+
+        const float BarLeft = OverlayLeft + 10.0f + TextWidth;
+        Bar.setPosition(BarLeft, Y + 3.0f);
+        Bar.setSize(sf::Vector2f(std::min(BarWidth, static_cast<float>(Stats.AvgMs) * MsToPixels), RowHeight - 6.0f));
+        Bar.setFillColor(Row == Profiler.phaseCount() ? sf::Color(230, 230, 230) : sf::Color(90, 200, 90));
+        Target.draw(Bar);
+
+        Bar.setPosition(BarLeft + std::min(BarWidth, static_cast<float>(Stats.P99Ms) * MsToPixels), Y + 1.0f);
+        Bar.setSize(sf::Vector2f(2.0f, RowHeight - 2.0f));
+        Bar.setFillColor(sf::Color(230, 80, 60));
+        Target.draw(Bar);
+    }
+
+    Target.setView(PreviousView);
+}
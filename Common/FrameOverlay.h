@@ -0,0 +1,25 @@
+#pragma once
+
+#include "FrameProfiler.h"
+
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Window/Event.hpp>
+
+// Rolling min/avg/p99 of every profiler phase drawn in the top-left corner, toggled with F3. Each phase
+// gets a bar for its average and a tick at its p99. The numbers are only drawn when a system font could
+// be loaded, since the exercises ship without one.
+struct FrameOverlay
+{
+    bool Visible = false;
+    bool HasFont = false;
+    sf::Font Font;
+};
+
+// Tries a few common system monospace and sans fonts; returns false if none could be loaded
+bool loadFrameOverlayFont(FrameOverlay& Overlay);
+
+void handleFrameOverlayEvent(FrameOverlay& Overlay, const sf::Event& Event);
+
+// Draws in screen space, restoring the target's view afterwards
+void drawFrameOverlay(sf::RenderTarget& Target, const FrameOverlay& Overlay, const FrameProfiler& Profiler);
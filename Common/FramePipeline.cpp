@@ -0,0 +1,86 @@
+#include "FramePipeline.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+
+FramePipeline::FramePipeline(WorkerPool& Pool, const bool Pipelined, const std::size_t HistoryFrames)
+    : Pool(Pool)
+    , Pipelined(Pipelined)
+    , History(std::max<std::size_t>(1, HistoryFrames), 0.0)
+{
+}
+
+FramePipeline::~FramePipeline()
+{
+    Pool.wait(Group);
+}
+
+void FramePipeline::launch(const WorkerPool::Job& Step)
+{
+    const int Target = back();
+    LaunchTime[Target] = Clock::now();
+    Launched[Target] = true;
+    if (Pipelined)
+    {
+        Pool.submit(Group, Step);
+    }
+    else
+    {
+        Step(0, 0);
+    }
+}
+
+void FramePipeline::presented()
+{
+    // The first pipelined frame shows the initial state, which no step produced
+    if (!Launched[Front])
+    {
+        return;
+    }
+
+    const Clock::time_point Now = Clock::now();
+    const double LatencyMs = std::chrono::duration<double, std::milli>(Now - LaunchTime[Front]).count();
+    History[Frames % History.size()] = LatencyMs;
+    TotalLatencyMs += LatencyMs;
+    if (Frames == 0)
+    {
+        FirstPresent = Now;
+    }
+    LastPresent = Now;
+    ++Frames;
+}
+
+void FramePipeline::swap()
+{
+    Pool.wait(Group);
+    Front = back();
+}
+
+FramePipeline::Stats FramePipeline::stats() const
+{
+    Stats Result;
+    Result.Frames = Frames;
+    if (Frames == 0)
+    {
+        return Result;
+    }
+
+    const double Seconds = std::chrono::duration<double>(LastPresent - FirstPresent).count();
+    Result.FramesPerSecond = Seconds > 0.0 ? static_cast<double>(Frames - 1) / Seconds : 0.0;
+    Result.AvgLatencyMs = TotalLatencyMs / static_cast<double>(Frames);
+
+    Scratch.assign(History.begin(), History.begin() + static_cast<std::ptrdiff_t>(std::min(Frames, History.size())));
+    const std::size_t Index = std::min(Scratch.size() - 1, static_cast<std::size_t>(0.99 * static_cast<double>(Scratch.size())));
+    std::nth_element(Scratch.begin(), Scratch.begin() + static_cast<std::ptrdiff_t>(Index), Scratch.end());
+    Result.P99LatencyMs = Scratch[Index];
+    return Result;
+}
+
+void printFramePipelineReport(const FramePipeline& Pipeline, std::ostream& Stream)
+{
+    const FramePipeline::Stats Stats = Pipeline.stats();
+    Stream << (Pipeline.pipelined() ? "Pipelined" : "Serial") << " loop: " << Stats.Frames << " frames, " << std::fixed
+        << std::setprecision(1) << Stats.FramesPerSecond << " frames/s, input-to-present latency avg "
+        << std::setprecision(2) << Stats.AvgLatencyMs << " ms, p99 " << Stats.P99LatencyMs << " ms" << std::endl;
+}
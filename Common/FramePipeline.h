@@ -0,0 +1,68 @@
+#pragma once
+
+#include "WorkerPool.h"
+
+#include <chrono>
+#include <cstddef>
+#include <iosfwd>
+#include <vector>
+
+// Runs each frame's simulation step either inline (serial) or overlapped with drawing (pipelined). The
+// pipelined loop launches the step for frame N + 1 as a task on the pool, writing buffer back(), while the
+// main thread draws and presents frame N from buffer front(); swap() waits for the step at the frame
+// boundary and flips the buffers. Serial mode uses a single buffer and runs the step inside launch(), so
+// the same loop serves both. What reaches the screen in pipelined mode is one step older, so both modes
+// measure input-to-present latency (from launch() to presented()) and throughput for comparison.
+class FramePipeline
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Stats
+    {
+        std::size_t Frames = 0;     // Frames presented with a simulated step behind them
+        double FramesPerSecond = 0.0;
+        double AvgLatencyMs = 0.0;  // Over the whole run
+        double P99LatencyMs = 0.0;  // Over the last HistoryFrames frames
+    };
+
+    FramePipeline(WorkerPool& Pool, bool Pipelined, std::size_t HistoryFrames = 240);
+    ~FramePipeline();
+
+    FramePipeline(const FramePipeline&) = delete;
+    FramePipeline& operator=(const FramePipeline&) = delete;
+
+    bool pipelined() const { return Pipelined; }
+    int front() const { return Front; }
+    int back() const { return Pipelined ? 1 - Front : Front; }
+
+    // Starts the step for the next frame; it may only write state belonging to buffer back(). Step must stay
+    // alive until swap().
+    void launch(const WorkerPool::Job& Step);
+
+    // Call once the frame drawn from front() has been presented
+    void presented();
+
+    // Waits for the launched step and makes its buffer the front one
+    void swap();
+
+    Stats stats() const;
+
+private:
+    WorkerPool& Pool;
+    bool Pipelined = false;
+    WorkerPool::TaskGroup Group;
+    int Front = 0;
+    Clock::time_point LaunchTime[2];
+    bool Launched[2] = { false, false };
+
+    std::vector<double> History; // Latency of the last HistoryFrames frames, used as a ring
+    std::size_t Frames = 0;
+    double TotalLatencyMs = 0.0;
+    Clock::time_point FirstPresent;
+    Clock::time_point LastPresent;
+    mutable std::vector<double> Scratch;
+};
+
+// One line with the mode, frames per second and input-to-present latency
+void printFramePipelineReport(const FramePipeline& Pipeline, std::ostream& Stream);
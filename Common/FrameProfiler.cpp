@@ -0,0 +1,148 @@
+#include "FrameProfiler.h"
+
+#include <algorithm>
+#include <cstring>
+
+FrameProfiler::FrameProfiler(std::vector<std::string> PhaseNames, const std::size_t HistoryFrames)
+    : PhaseNames(std::move(PhaseNames)), HistoryFrames(std::max<std::size_t>(1, HistoryFrames))
+{
+    Columns = this->PhaseNames.size() + 1;
+    History.assign(this->HistoryFrames * Columns, 0.0);
+    Current.assign(Columns, 0.0);
+    FrameStart = Clock::now();
+}
+
+FrameProfiler::~FrameProfiler()
+{
+    if (Writer.joinable())
+    {
+        {
+            std::lock_guard Lock(WriterMutex);
+            StopWriter = true;
+        }
+        WriterCondition.notify_one();
+        Writer.join();
+    }
+}
+
+void FrameProfiler::beginFrame()
+{
+    std::fill(Current.begin(), Current.end(), 0.0);
+    FrameStart = Clock::now();
+}
+
+void FrameProfiler::endFrame()
+{
+    Current[Columns - 1] = std::chrono::duration<double, std::milli>(Clock::now() - FrameStart).count();
+    std::copy(Current.begin(), Current.end(), History.begin() + static_cast<std::ptrdiff_t>((FrameIndex % HistoryFrames) * Columns));
+    RecordedFrames = std::min(RecordedFrames + 1, HistoryFrames);
+
+    if (Writer.joinable())
+    {
+        {
+            std::lock_guard Lock(WriterMutex);
+            Pending.push_back(static_cast<double>(FrameIndex));
+            Pending.insert(Pending.end(), Current.begin(), Current.end());
+        }
+        WriterCondition.notify_one();
+    }
+    ++FrameIndex;
+}
+
+void FrameProfiler::addTime(const int Phase, const double Ms)
+{
+    Current[static_cast<std::size_t>(Phase)] += Ms;
+}
+
+bool FrameProfiler::startCsv(const std::string& Path)
+{
+    if (Writer.joinable())
+    {
+        return false;
+    }
+    Csv.open(Path, std::ios::trunc);
+    if (!Csv)
+    {
+        return false;
+    }
+
+    Csv << "frame";
+    for (const std::string& Name : PhaseNames)
+    {
+        Csv << ',' << Name << "_ms";
+    }
+    Csv << ",frame_ms\n";
+    Writer = std::thread(&FrameProfiler::writerLoop, this);
+    return true;
+}
+
+FrameProfiler::PhaseStats FrameProfiler::phaseStats(const int Phase) const
+{
+    PhaseStats Stats;
+    if (RecordedFrames == 0)
+    {
+        return Stats;
+    }
+
+    Scratch.resize(RecordedFrames);
+    for (std::size_t Frame = 0; Frame < RecordedFrames; ++Frame)
+    {
+        Scratch[Frame] = History[Frame * Columns + static_cast<std::size_t>(Phase)];
+    }
+
+    double Sum = 0.0;
+    for (const double Ms : Scratch)
+    {
+        Sum += Ms;
+    }
+    Stats.AvgMs = Sum / static_cast<double>(RecordedFrames);
+    Stats.MinMs = *std::min_element(Scratch.begin(), Scratch.end());
+    const std::size_t Index = std::min(RecordedFrames - 1, static_cast<std::size_t>(0.99 * static_cast<double>(RecordedFrames)));
+    std::nth_element(Scratch.begin(), Scratch.begin() + static_cast<std::ptrdiff_t>(Index), Scratch.end());
+    Stats.P99Ms = Scratch[Index];
+    return Stats;
+}
+
+void FrameProfiler::writerLoop()
+{
+    std::vector<double> Rows;
+    while (true)
+    {
+        bool Stopping = false;
+        {
+            std::unique_lock Lock(WriterMutex);
+            WriterCondition.wait(Lock, [this] { return StopWriter || !Pending.empty(); });
+            Rows.swap(Pending);
+            Stopping = StopWriter;
+        }
+
+        for (std::size_t Row = 0; Row < Rows.size(); Row += Columns + 1)
+        {
+            Csv << static_cast<unsigned long long>(Rows[Row]);
+            for (std::size_t Column = 1; Column <= Columns; ++Column)
+            {
+                Csv << ',' << Rows[Row + Column];
+            }
+            Csv << '\n';
+        }
+        Rows.clear();
+
+        if (Stopping)
+        {
+            Csv.flush();
+            return;
+        }
+    }
+}
+
+std::string frameProfilerCsvPath(const int Argc, char* Argv[])
+{
+    for (int I = 1; I + 1 < Argc; ++I)
+    {
+        if (std::strcmp(Argv[I], "--profile-csv") == 0)
+        {
+            return Argv[I + 1];
+        }
+    }
+    return {};
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Per-phase frame timing shared by all the exercises. Each frame is bracketed by beginFrame/endFrame and
+// the phases inside it are timed with scope(). The last HistoryFrames frames are kept for rolling
+// statistics, and every frame can also be streamed to a CSV file by a background thread, so the frame
+// being measured only pays for appending one row to a buffer.
+class FrameProfiler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct PhaseStats
+    {
+        double MinMs = 0.0;
+        double AvgMs = 0.0;
+        double P99Ms = 0.0;
+    };
+
+    // Adds the time from construction to destruction to one phase of the current frame
+    class Scope
+    {
+    public:
+        Scope(FrameProfiler& Profiler, const int Phase) : Profiler(Profiler), Phase(Phase), Start(Clock::now()) {}
+        ~Scope() { Profiler.addTime(Phase, std::chrono::duration<double, std::milli>(Clock::now() - Start).count()); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        FrameProfiler& Profiler;
+        int Phase;
+        Clock::time_point Start;
+    };
+
+    explicit FrameProfiler(std::vector<std::string> PhaseNames, std::size_t HistoryFrames = 240);
+    ~FrameProfiler();
+
+    FrameProfiler(const FrameProfiler&) = delete;
+    FrameProfiler& operator=(const FrameProfiler&) = delete;
+
+    void beginFrame();
+    void endFrame();
+    void addTime(int Phase, double Ms);
+    Scope scope(const int Phase) { return Scope(*this, Phase); }
+
+    // Starts streaming one row per frame to Path. Returns false if the file could not be opened.
+    bool startCsv(const std::string& Path);
+
+    int phaseCount() const { return static_cast<int>(PhaseNames.size()); }
+    const std::string& phaseName(const int Phase) const { return PhaseNames[static_cast<std::size_t>(Phase)]; }
+
+    // Statistics over the recorded history. Phase == phaseCount() gives the whole frame.
+    PhaseStats phaseStats(int Phase) const;
+
+private:
+    void writerLoop();
+
+    std::vector<std::string> PhaseNames;
+    std::size_t Columns = 0;        // One per phase plus the whole frame
+    std::size_t HistoryFrames = 0;
+    std::vector<double> History;    // HistoryFrames rows of Columns, used as a ring
+    std::size_t RecordedFrames = 0;
+    std::vector<double> Current;    // Phase times of the frame in progress
+    Clock::time_point FrameStart;
+    unsigned long long FrameIndex = 0;
+    mutable std::vector<double> Scratch;
+
+    // CSV writer: endFrame appends to Pending under the lock, the writer swaps it out and writes it
+    std::ofstream Csv;
+    std::thread Writer;
+    std::mutex WriterMutex;
+    std::condition_variable WriterCondition;
+    std::vector<double> Pending;    // Rows of Columns + 1, the first value being the frame index
+    bool StopWriter = false;
+};
+
+// Path following --profile-csv on the command line, or empty
+std::string frameProfilerCsvPath(int Argc, char* Argv[]);
@@ -0,0 +1,477 @@
+#include "SoftwareRasterizer.h"
+
+#include "VectorMath.h"
+#include "WorkerPool.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+    // Square screen tiles, small enough that a tile's pixels stay in L2 while its triangles are drawn
+    constexpr int TileSize = 64;
+
+    // Points on the rim of a circle, the sf::CircleShape default
+    constexpr int CirclePoints = 30;
+
+    const std::uint32_t AlphaMask = softwareColor(0, 0, 0, 255);
+
+    // Span filling: plain 32-bit stores for opaque colours, otherwise a blend done two channels at a time
+    // (red and blue in one register, green and alpha in another) so every lane is a 32-bit integer and
+    // both loops vectorize. Blending keeps the destination's alpha, the framebuffer being opaque.
+    void fillSpan(std::uint32_t* Row, const int Begin, const int End, const std::uint32_t Color)
+    {
+        for (int X = Begin; X < End; ++X)
+        {
+            Row[X] = Color;
+        }
+    }
+
+    void blendSpan(std::uint32_t* Row, const int Begin, const int End, const std::uint32_t Color)
+    {
+        std::uint8_t Bytes[4];
+        std::memcpy(Bytes, &Color, sizeof(Color));
+        const std::uint32_t Weight = Bytes[3] + (Bytes[3] >> 7); // 0..256
+        const std::uint32_t SourceEven = (Color & 0x00FF00FFu) * Weight;
+        const std::uint32_t SourceOdd = ((Color >> 8) & 0x00FF00FFu) * Weight;
+        for (int X = Begin; X < End; ++X)
+        {
+            const std::uint32_t Destination = Row[X];
+            const std::uint32_t Even = ((SourceEven + (Destination & 0x00FF00FFu) * (256 - Weight)) >> 8) & 0x00FF00FFu;
+            const std::uint32_t Odd = (SourceOdd + ((Destination >> 8) & 0x00FF00FFu) * (256 - Weight)) & 0xFF00FF00u;
+            Row[X] = ((Even | Odd) & ~AlphaMask) | (Destination & AlphaMask);
+        }
+    }
+
+    // std::ceil is a library call without SSE4.1; truncation rounds towards zero, so step up when it fell short
+    int ceilToInt(const float Value)
+    {
+        const int Truncated = static_cast<int>(Value);
+        return Truncated + (static_cast<float>(Truncated) < Value);
+    }
+
+    // Covers the pixels inside the tile whose centres lie inside the triangle. Each edge's crossing of a
+    // row is a linear function of y set up once, so a row costs a few multiply-adds to find the span
+    // between the edges, which is then filled in one go.
+    void rasterizeTriangle(SoftwareFramebuffer& Framebuffer, const float (&X)[3], const float (&Y)[3], const std::uint32_t Color,
+        const int TileX0, const int TileY0, const int TileX1, const int TileY1)
+    {
+        const float Area = (X[1] - X[0]) * (Y[2] - Y[0]) - (X[2] - X[0]) * (Y[1] - Y[0]);
+        if (Area == 0.0f)
+        {
+            return;
+        }
+
+        // Walking the edges in a consistent winding, an edge going up the screen bounds the span on the
+        // left and one going down bounds it on the right. Horizontal edges only bound the rows, which the
+        // bounding box already does.
+        float LeftSlope[2];
+        float LeftOffset[2];
+        float RightSlope[2];
+        float RightOffset[2];
+        int LeftEdges = 0;
+        int RightEdges = 0;
+        const int Order[3] = { 0, Area > 0.0f ? 1 : 2, Area > 0.0f ? 2 : 1 };
+        for (int Edge = 0; Edge < 3; ++Edge)
+        {
+            const int From = Order[Edge];
+            const int To = Order[(Edge + 1) % 3];
+            if (Y[From] == Y[To])
+            {
+                continue;
+            }
+            const float Slope = (X[To] - X[From]) / (Y[To] - Y[From]);
+            const float Offset = X[From] - Slope * Y[From];
+            if (Y[To] < Y[From])
+            {
+                LeftSlope[LeftEdges] = Slope;
+                LeftOffset[LeftEdges++] = Offset;
+            }
+            else
+            {
+                RightSlope[RightEdges] = Slope;
+                RightOffset[RightEdges++] = Offset;
+            }
+        }
+
+        const float MinX = std::min({ X[0], X[1], X[2] });
+        const float MaxX = std::max({ X[0], X[1], X[2] });
+        const int RowBegin = std::max(TileY0, ceilToInt(std::min({ Y[0], Y[1], Y[2] }) - 0.5f));
+        const int RowEnd = std::min(TileY1, ceilToInt(std::max({ Y[0], Y[1], Y[2] }) - 0.5f));
+        const bool Opaque = (Color & AlphaMask) == AlphaMask;
+        for (int Row = RowBegin; Row < RowEnd; ++Row)
+        {
+            const float CenterY = static_cast<float>(Row) + 0.5f;
+            float Left = MinX;
+            float Right = MaxX;
+            for (int Edge = 0; Edge < LeftEdges; ++Edge)
+            {
+                Left = std::max(Left, LeftSlope[Edge] * CenterY + LeftOffset[Edge]);
+            }
+            for (int Edge = 0; Edge < RightEdges; ++Edge)
+            {
+                Right = std::min(Right, RightSlope[Edge] * CenterY + RightOffset[Edge]);
+            }
+
+            // Pixel X is covered when its centre X + 0.5 lies in [Left, Right)
+            const int Begin = std::max(TileX0, ceilToInt(Left - 0.5f));
+            const int End = std::min(TileX1, ceilToInt(Right - 0.5f));
+            if (Begin >= End)
+            {
+                continue;
+            }
+            std::uint32_t* Pixels = Framebuffer.Pixels.data() + static_cast<std::size_t>(Row) * Framebuffer.Width;
+            if (Opaque)
+            {
+                fillSpan(Pixels, Begin, End, Color);
+            }
+            else
+            {
+                blendSpan(Pixels, Begin, End, Color);
+            }
+        }
+    }
+
+    // CRC-32 as used by PNG chunks
+    std::uint32_t crc32(const std::uint8_t* Data, const std::size_t Size, std::uint32_t Crc = 0)
+    {
+        static const std::array<std::uint32_t, 256> Table = []
+        {
+            std::array<std::uint32_t, 256> Values{};
+            for (std::uint32_t I = 0; I < 256; ++I)
+            {
+                std::uint32_t Value = I;
+                for (int Bit = 0; Bit < 8; ++Bit)
+                {
+                    Value = (Value & 1) ? 0xEDB88320u ^ (Value >> 1) : Value >> 1;
+                }
+                Values[I] = Value;
+            }
+            return Values;
+        }();
+
+        Crc = ~Crc;
+        for (std::size_t I = 0; I < Size; ++I)
+        {
+            Crc = Table[(Crc ^ Data[I]) & 0xFF] ^ (Crc >> 8);
+        }
+        return ~Crc;
+    }
+
+    void appendBigEndian(std::vector<std::uint8_t>& Out, const std::uint32_t Value)
+    {
+        for (int Shift = 24; Shift >= 0; Shift -= 8)
+        {
+            Out.push_back(static_cast<std::uint8_t>(Value >> Shift));
+        }
+    }
+
+    void appendPngChunk(std::vector<std::uint8_t>& Out, const char (&Type)[5], const std::vector<std::uint8_t>& Data)
+    {
+        appendBigEndian(Out, static_cast<std::uint32_t>(Data.size()));
+        const std::size_t TypeStart = Out.size();
+        Out.insert(Out.end(), Type, Type + 4);
+        Out.insert(Out.end(), Data.begin(), Data.end());
+        appendBigEndian(Out, crc32(Out.data() + TypeStart, Out.size() - TypeStart));
+    }
+
+    // PNG with its image data in stored (uncompressed) deflate blocks: larger than a real encoder's output
+    // but needs no zlib, and any viewer reads it
+    std::vector<std::uint8_t> encodePng(const SoftwareFramebuffer& Framebuffer)
+    {
+        const std::size_t RowBytes = static_cast<std::size_t>(Framebuffer.Width) * 4;
+        std::vector<std::uint8_t> Raw;
+        Raw.reserve((RowBytes + 1) * Framebuffer.Height);
+        const std::uint8_t* Pixels = reinterpret_cast<const std::uint8_t*>(Framebuffer.Pixels.data());
+        for (int Row = 0; Row < Framebuffer.Height; ++Row)
+        {
+            Raw.push_back(0); // No filter
+            Raw.insert(Raw.end(), Pixels + Row * RowBytes, Pixels + (Row + 1) * RowBytes);
+        }
+
+        std::vector<std::uint8_t> Deflate = { 0x78, 0x01 };
+        for (std::size_t Offset = 0; Offset < Raw.size() || Offset == 0; Offset += 65535)
+        {
+            const std::size_t Size = std::min<std::size_t>(65535, Raw.size() - Offset);
+            Deflate.push_back(Offset + Size == Raw.size() ? 1 : 0);
+            Deflate.push_back(static_cast<std::uint8_t>(Size));
+            Deflate.push_back(static_cast<std::uint8_t>(Size >> 8));
+            Deflate.push_back(static_cast<std::uint8_t>(~Size));
+            Deflate.push_back(static_cast<std::uint8_t>(~Size >> 8));
+            Deflate.insert(Deflate.end(), Raw.begin() + Offset, Raw.begin() + Offset + Size);
+        }
+        std::uint32_t AdlerA = 1;
+        std::uint32_t AdlerB = 0;
+        for (const std::uint8_t Byte : Raw)
+        {
+            AdlerA = (AdlerA + Byte) % 65521;
+            AdlerB = (AdlerB + AdlerA) % 65521;
+        }
+        appendBigEndian(Deflate, (AdlerB << 16) | AdlerA);
+
+        std::vector<std::uint8_t> Header;
+        appendBigEndian(Header, static_cast<std::uint32_t>(Framebuffer.Width));
+        appendBigEndian(Header, static_cast<std::uint32_t>(Framebuffer.Height));
+        Header.insert(Header.end(), { 8, 6, 0, 0, 0 }); // 8-bit RGBA, no interlace
+
+        std::vector<std::uint8_t> Png = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        appendPngChunk(Png, "IHDR", Header);
+        appendPngChunk(Png, "IDAT", Deflate);
+        appendPngChunk(Png, "IEND", {});
+        return Png;
+    }
+}
+
+SoftwareRenderOptions softwareRenderOptions(const int Argc, char* Argv[])
+{
+    SoftwareRenderOptions Options;
+    for (int I = 1; I + 1 < Argc; ++I)
+    {
+        if (std::strcmp(Argv[I], "--software") == 0)
+        {
+            Options.OutputPath = Argv[++I];
+        }
+        else if (std::strcmp(Argv[I], "--frames") == 0)
+        {
+            Options.Frames = std::max(1, std::atoi(Argv[++I]));
+        }
+    }
+    return Options;
+}
+
+std::uint32_t softwareColor(const std::uint8_t R, const std::uint8_t G, const std::uint8_t B, const std::uint8_t A)
+{
+    const std::uint8_t Bytes[4] = { R, G, B, A };
+    std::uint32_t Color;
+    std::memcpy(&Color, Bytes, sizeof(Color));
+    return Color;
+}
+
+SoftwareRasterizer::SoftwareRasterizer(const int Width, const int Height, WorkerPool& Pool)
+    : Pool(Pool)
+{
+    Framebuffer.Width = Width;
+    Framebuffer.Height = Height;
+    Framebuffer.Pixels.assign(static_cast<std::size_t>(Width) * Height, 0);
+    TilesX = (Width + TileSize - 1) / TileSize;
+    TilesY = (Height + TileSize - 1) / TileSize;
+    BinChunks = Pool.threadCount();
+    Bins.resize(BinChunks * TilesX * TilesY);
+    setView(sf::Vector2f(Width / 2.0f, Height / 2.0f), sf::Vector2f(static_cast<float>(Width), static_cast<float>(Height)));
+}
+
+void SoftwareRasterizer::setView(const sf::Vector2f Center, const sf::Vector2f Size)
+{
+    ViewSize = Size;
+    ViewOrigin = Center - Size / 2.0f;
+    Scale = sf::Vector2f(Framebuffer.Width / Size.x, Framebuffer.Height / Size.y);
+}
+
+void SoftwareRasterizer::clear(const std::uint32_t Color)
+{
+    ClearColor = Color;
+    Triangles.clear();
+}
+
+sf::Vector2f SoftwareRasterizer::toPixels(const sf::Vector2f Point) const
+{
+    return sf::Vector2f((Point.x - ViewOrigin.x) * Scale.x, (Point.y - ViewOrigin.y) * Scale.y);
+}
+
+void SoftwareRasterizer::queuePixelTriangle(const sf::Vector2f A, const sf::Vector2f B, const sf::Vector2f C, const std::uint32_t Color)
+{
+    Triangles.push_back(Triangle{ { A.x, B.x, C.x }, { A.y, B.y, C.y }, Color });
+}
+
+// One pixel wide quad centred on the line, in pixel space so it stays one pixel at any zoom
+void SoftwareRasterizer::queueLine(const sf::Vector2f A, const sf::Vector2f B, const std::uint32_t Color)
+{
+    const sf::Vector2f Direction = B - A;
+    const float LengthSquared = Direction.x * Direction.x + Direction.y * Direction.y;
+    if (LengthSquared <= FastMinLengthSquared)
+    {
+        return;
+    }
+    const sf::Vector2f Side = sf::Vector2f(-Direction.y, Direction.x) * (0.5f * fastInverseSqrt(LengthSquared));
+    queuePixelTriangle(A + Side, B + Side, B - Side, Color);
+    queuePixelTriangle(A + Side, B - Side, A - Side, Color);
+}
+
+void SoftwareRasterizer::drawTriangle(const sf::Vector2f A, const sf::Vector2f B, const sf::Vector2f C, const std::uint32_t Color)
+{
+    queuePixelTriangle(toPixels(A), toPixels(B), toPixels(C), Color);
+}
+
+void SoftwareRasterizer::draw(const sf::Vertex* Vertices, const std::size_t Count, const sf::PrimitiveType Type)
+{
+    const auto position = [this, Vertices](const std::size_t I) { return toPixels(Vertices[I].position); };
+    const auto color = [Vertices](const std::size_t I) { return softwareColor(Vertices[I].color); };
+    switch (Type)
+    {
+    case sf::Points:
+        for (std::size_t I = 0; I < Count; ++I)
+        {
+            const sf::Vector2f Point = position(I);
+            queueLine(Point - sf::Vector2f(0.5f, 0.0f), Point + sf::Vector2f(0.5f, 0.0f), color(I));
+        }
+        break;
+    case sf::Lines:
+        for (std::size_t I = 0; I + 1 < Count; I += 2)
+        {
+            queueLine(position(I), position(I + 1), color(I));
+        }
+        break;
+    case sf::LineStrip:
+        for (std::size_t I = 0; I + 1 < Count; ++I)
+        {
+            queueLine(position(I), position(I + 1), color(I));
+        }
+        break;
+    case sf::Triangles:
+        for (std::size_t I = 0; I + 2 < Count; I += 3)
+        {
+            queuePixelTriangle(position(I), position(I + 1), position(I + 2), color(I));
+        }
+        break;
+    case sf::TriangleStrip:
+        for (std::size_t I = 0; I + 2 < Count; ++I)
+        {
+            queuePixelTriangle(position(I), position(I + 1), position(I + 2), color(I));
+        }
+        break;
+    case sf::TriangleFan:
+        for (std::size_t I = 1; I + 1 < Count; ++I)
+        {
+            queuePixelTriangle(position(0), position(I), position(I + 1), color(0));
+        }
+        break;
+    case sf::Quads:
+        for (std::size_t I = 0; I + 3 < Count; I += 4)
+        {
+            queuePixelTriangle(position(I), position(I + 1), position(I + 2), color(I));
+            queuePixelTriangle(position(I), position(I + 2), position(I + 3), color(I));
+        }
+        break;
+    }
+}
+
+void SoftwareRasterizer::drawCircle(const sf::Vector2f Center, const float Radius, const std::uint32_t Color)
+{
+    sf::Vector2f Previous = Center + sf::Vector2f(Radius, 0.0f);
+    for (int Point = 1; Point <= CirclePoints; ++Point)
+    {
+        const float Angle = 6.2831853f * static_cast<float>(Point) / CirclePoints;
+        const sf::Vector2f Next = Center + sf::Vector2f(std::cos(Angle), std::sin(Angle)) * Radius;
+        drawTriangle(Center, Previous, Next, Color);
+        Previous = Next;
+    }
+}
+
+// Appends every triangle of one contiguous chunk of the queue to the bins of the tiles its bounds touch
+void SoftwareRasterizer::binTriangles(const std::size_t Chunk)
+{
+    const std::size_t TileCount = static_cast<std::size_t>(TilesX) * TilesY;
+    std::vector<std::uint32_t>* ChunkBins = Bins.data() + Chunk * TileCount;
+    for (std::size_t Tile = 0; Tile < TileCount; ++Tile)
+    {
+        ChunkBins[Tile].clear();
+    }
+
+    const std::size_t PerChunk = (Triangles.size() + BinChunks - 1) / BinChunks;
+    const std::size_t Begin = std::min(Triangles.size(), Chunk * PerChunk);
+    const std::size_t End = std::min(Triangles.size(), Begin + PerChunk);
+    for (std::size_t Index = Begin; Index < End; ++Index)
+    {
+        // Same pixel-centre bounds as the rasterizer, so a triangle covering no pixel centre is never binned
+        const Triangle& Current = Triangles[Index];
+        const int X0 = std::max(0, ceilToInt(std::min({ Current.X[0], Current.X[1], Current.X[2] }) - 0.5f));
+        const int X1 = std::min(Framebuffer.Width, ceilToInt(std::max({ Current.X[0], Current.X[1], Current.X[2] }) - 0.5f));
+        const int Y0 = std::max(0, ceilToInt(std::min({ Current.Y[0], Current.Y[1], Current.Y[2] }) - 0.5f));
+        const int Y1 = std::min(Framebuffer.Height, ceilToInt(std::max({ Current.Y[0], Current.Y[1], Current.Y[2] }) - 0.5f));
+        if (X0 >= X1 || Y0 >= Y1)
+        {
+            continue;
+        }
+        for (int TileY = Y0 / TileSize; TileY <= (Y1 - 1) / TileSize; ++TileY)
+        {
+            for (int TileX = X0 / TileSize; TileX <= (X1 - 1) / TileSize; ++TileX)
+            {
+                ChunkBins[static_cast<std::size_t>(TileY) * TilesX + TileX].push_back(static_cast<std::uint32_t>(Index));
+            }
+        }
+    }
+}
+
+void SoftwareRasterizer::fillTile(const std::size_t Tile)
+{
+    const int TileX0 = static_cast<int>(Tile % TilesX) * TileSize;
+    const int TileY0 = static_cast<int>(Tile / TilesX) * TileSize;
+    const int TileX1 = std::min(Framebuffer.Width, TileX0 + TileSize);
+    const int TileY1 = std::min(Framebuffer.Height, TileY0 + TileSize);
+    for (int Row = TileY0; Row < TileY1; ++Row)
+    {
+        fillSpan(Framebuffer.Pixels.data() + static_cast<std::size_t>(Row) * Framebuffer.Width, TileX0, TileX1, ClearColor);
+    }
+
+    // Chunks hold consecutive runs of the queue, so walking them in order keeps submission order
+    const std::size_t TileCount = static_cast<std::size_t>(TilesX) * TilesY;
+    for (std::size_t Chunk = 0; Chunk < BinChunks; ++Chunk)
+    {
+        for (const std::uint32_t Index : Bins[Chunk * TileCount + Tile])
+        {
+            const Triangle& Current = Triangles[Index];
+            rasterizeTriangle(Framebuffer, Current.X, Current.Y, Current.Color, TileX0, TileY0, TileX1, TileY1);
+        }
+    }
+}
+
+void SoftwareRasterizer::finish()
+{
+    Pool.parallelFor(BinChunks, 1, [this](const std::size_t Begin, const std::size_t End)
+    {
+        for (std::size_t Chunk = Begin; Chunk < End; ++Chunk)
+        {
+            binTriangles(Chunk);
+        }
+    });
+    Pool.parallelFor(static_cast<std::size_t>(TilesX) * TilesY, 1, [this](const std::size_t Begin, const std::size_t End)
+    {
+        for (std::size_t Tile = Begin; Tile < End; ++Tile)
+        {
+            fillTile(Tile);
+        }
+    });
+}
+
+bool saveSoftwareFramebuffer(const SoftwareFramebuffer& Framebuffer, const std::string& Path)
+{
+    std::ofstream Stream(Path, std::ios::binary | std::ios::trunc);
+    if (!Stream)
+    {
+        return false;
+    }
+
+    const bool Png = Path.size() >= 4 && Path.compare(Path.size() - 4, 4, ".png") == 0;
+    if (Png)
+    {
+        const std::vector<std::uint8_t> Encoded = encodePng(Framebuffer);
+        Stream.write(reinterpret_cast<const char*>(Encoded.data()), static_cast<std::streamsize>(Encoded.size()));
+    }
+    else
+    {
+        Stream << "P6\n" << Framebuffer.Width << ' ' << Framebuffer.Height << "\n255\n";
+        std::vector<std::uint8_t> Rgb;
+        Rgb.reserve(Framebuffer.Pixels.size() * 3);
+        const std::uint8_t* Pixels = reinterpret_cast<const std::uint8_t*>(Framebuffer.Pixels.data());
+        for (std::size_t Pixel = 0; Pixel < Framebuffer.Pixels.size(); ++Pixel)
+        {
+            Rgb.insert(Rgb.end(), Pixels + Pixel * 4, Pixels + Pixel * 4 + 3);
+        }
+        Stream.write(reinterpret_cast<const char*>(Rgb.data()), static_cast<std::streamsize>(Rgb.size()));
+    }
+    return static_cast<bool>(Stream);
+}
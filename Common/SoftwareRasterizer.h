@@ -0,0 +1,106 @@
+#pragma once
+
+#include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class WorkerPool;
+
+// --software <file> renders every exercise on the CPU without opening a window, for machines with no GPU
+// or display: the program runs --frames frames at a fixed 60 Hz with scripted input and writes the last one
+// to <file>, as PNG if the name ends in .png and binary PPM otherwise.
+struct SoftwareRenderOptions
+{
+    std::string OutputPath; // Empty renders through the SFML window as usual
+    int Frames = 120;
+
+    bool enabled() const { return !OutputPath.empty(); }
+};
+
+SoftwareRenderOptions softwareRenderOptions(int Argc, char* Argv[]);
+
+// RGBA with 8 bits per channel, in the byte order of sf::Color and sf::Image
+std::uint32_t softwareColor(std::uint8_t R, std::uint8_t G, std::uint8_t B, std::uint8_t A = 255);
+inline std::uint32_t softwareColor(const sf::Color& Color) { return softwareColor(Color.r, Color.g, Color.b, Color.a); }
+
+struct SoftwareFramebuffer
+{
+    int Width = 0;
+    int Height = 0;
+    std::vector<std::uint32_t> Pixels; // Row-major, top row first
+};
+
+// CPU stand-in for sf::RenderWindow that takes the same vertex arrays the exercises draw. Primitives are
+// only queued by draw(); finish() bins them into screen tiles and fills the tiles in parallel on the pool,
+// each tile clearing its own pixels and then drawing its triangles in submission order, so overlapping
+// primitives stack exactly as they were drawn. Every primitive is filled flat with the colour of its first
+// vertex, which is all the exercises use, and lines and points are drawn one pixel wide like OpenGL does.
+// Queues and bins keep their capacity, so a steady-state frame makes no heap allocations.
+class SoftwareRasterizer
+{
+public:
+    SoftwareRasterizer(int Width, int Height, WorkerPool& Pool);
+
+    // Maps world coordinates to the framebuffer like an sf::View with this centre and size
+    void setView(sf::Vector2f Center, sf::Vector2f Size);
+    sf::Vector2f viewSize() const { return ViewSize; }
+
+    // Starts a frame: drops everything queued and fills the framebuffer with Color on the next finish()
+    void clear(std::uint32_t Color);
+    void clear(const sf::Color& Color) { clear(softwareColor(Color)); }
+
+    void draw(const sf::Vertex* Vertices, std::size_t Count, sf::PrimitiveType Type);
+    void draw(const sf::VertexArray& Vertices)
+    {
+        if (Vertices.getVertexCount() > 0)
+        {
+            draw(&Vertices[0], Vertices.getVertexCount(), Vertices.getPrimitiveType());
+        }
+    }
+
+    // Triangle fan approximating a filled circle, with as many points as an sf::CircleShape
+    void drawCircle(sf::Vector2f Center, float Radius, std::uint32_t Color);
+
+    // World-space triangle in a packed colour, the building block of everything above
+    void drawTriangle(sf::Vector2f A, sf::Vector2f B, sf::Vector2f C, std::uint32_t Color);
+
+    // Rasterizes everything queued since clear() into the framebuffer
+    void finish();
+
+    const SoftwareFramebuffer& framebuffer() const { return Framebuffer; }
+    std::size_t triangleCount() const { return Triangles.size(); }
+
+private:
+    struct Triangle
+    {
+        float X[3];
+        float Y[3];
+        std::uint32_t Color;
+    };
+
+    sf::Vector2f toPixels(sf::Vector2f Point) const;
+    void queuePixelTriangle(sf::Vector2f A, sf::Vector2f B, sf::Vector2f C, std::uint32_t Color);
+    void queueLine(sf::Vector2f A, sf::Vector2f B, std::uint32_t Color);
+    void binTriangles(std::size_t Chunk);
+    void fillTile(std::size_t Tile);
+
+    WorkerPool& Pool;
+    SoftwareFramebuffer Framebuffer;
+    sf::Vector2f ViewOrigin;
+    sf::Vector2f ViewSize;
+    sf::Vector2f Scale{ 1.0f, 1.0f };
+    std::uint32_t ClearColor = 0;
+
+    int TilesX = 0;
+    int TilesY = 0;
+    std::size_t BinChunks = 0;
+    std::vector<Triangle> Triangles;
+    std::vector<std::vector<std::uint32_t>> Bins; // BinChunks rows of one triangle list per tile
+};
+
+// Writes the framebuffer as PNG (stored, uncompressed) when Path ends in .png and as binary PPM otherwise
+bool saveSoftwareFramebuffer(const SoftwareFramebuffer& Framebuffer, const std::string& Path);
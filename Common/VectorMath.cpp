@@ -0,0 +1,122 @@
+#include "VectorMath.h"
+
+#include <cmath>
+
+VectorMathIsa detectVectorMathIsa()
+{
+#if CPU_FEATURES_X86
+    if (cpuHasAvx512())
+    {
+        return VectorMathIsa::Avx512;
+    }
+    if (cpuHasAvx2())
+    {
+        return VectorMathIsa::Avx2;
+    }
+    return VectorMathIsa::Sse2;
+#else
+    return VectorMathIsa::Scalar;
+#endif
+}
+
+const char* vectorMathIsaName(const VectorMathIsa Isa)
+{
+    switch (Isa)
+    {
+    case VectorMathIsa::Sse2:
+        return "SSE2";
+    case VectorMathIsa::Avx2:
+        return "AVX2";
+    case VectorMathIsa::Avx512:
+        return "AVX-512";
+    default:
+        return "Scalar";
+    }
+}
+
+NormalizeBatchKernel normalizeBatchKernel(const VectorMathIsa Isa)
+{
+    switch (Isa)
+    {
+#if CPU_FEATURES_X86
+    case VectorMathIsa::Sse2:
+        return fastNormalizeBatchSse2;
+    case VectorMathIsa::Avx2:
+        return fastNormalizeBatchAvx2;
+    case VectorMathIsa::Avx512:
+        return fastNormalizeBatchAvx512;
+#endif
+    default:
+        return fastNormalizeBatchScalar;
+    }
+}
+
+LengthBatchKernel lengthBatchKernel(const VectorMathIsa Isa)
+{
+    switch (Isa)
+    {
+#if CPU_FEATURES_X86
+    case VectorMathIsa::Sse2:
+        return fastLengthBatchSse2;
+    case VectorMathIsa::Avx2:
+        return fastLengthBatchAvx2;
+    case VectorMathIsa::Avx512:
+        return fastLengthBatchAvx512;
+#endif
+    default:
+        return fastLengthBatchScalar;
+    }
+}
+
+void fastNormalizeBatch(const float* X, const float* Y, float* OutX, float* OutY, float* OutLength, const std::size_t Count)
+{
+    static const NormalizeBatchKernel Kernel = normalizeBatchKernel(detectVectorMathIsa());
+    Kernel(X, Y, OutX, OutY, OutLength, Count);
+}
+
+void fastLengthBatch(const float* X, const float* Y, float* OutLength, const std::size_t Count)
+{
+    static const LengthBatchKernel Kernel = lengthBatchKernel(detectVectorMathIsa());
+    Kernel(X, Y, OutLength, Count);
+}
+
+void fastNormalizeBatchScalar(const float* X, const float* Y, float* OutX, float* OutY, float* OutLength, const std::size_t Count)
+{
+    for (std::size_t I = 0; I < Count; ++I)
+    {
+        const float LengthSquared = X[I] * X[I] + Y[I] * Y[I];
+        const float Inverse = LengthSquared > FastMinLengthSquared ? fastInverseSqrt(LengthSquared) : 0.0f;
+        OutX[I] = X[I] * Inverse;
+        OutY[I] = Y[I] * Inverse;
+        OutLength[I] = LengthSquared * Inverse;
+    }
+}
+
+void fastLengthBatchScalar(const float* X, const float* Y, float* OutLength, const std::size_t Count)
+{
+    for (std::size_t I = 0; I < Count; ++I)
+    {
+        OutLength[I] = fastLength(sf::Vector2f(X[I], Y[I]));
+    }
+}
+
+void exactNormalizeBatch(const float* X, const float* Y, float* OutX, float* OutY, float* OutLength, const std::size_t Count)
+{
+    for (std::size_t I = 0; I < Count; ++I)
+    {
+        const float Length = std::sqrt(X[I] * X[I] + Y[I] * Y[I]);
+        const float VectorX = X[I];
+        const float VectorY = Y[I];
+        OutX[I] = Length > 0.0f ? VectorX / Length : 0.0f;
+        OutY[I] = Length > 0.0f ? VectorY / Length : 0.0f;
+        OutLength[I] = Length;
+    }
+}
+
+void exactLengthBatch(const float* X, const float* Y, float* OutLength, const std::size_t Count)
+{
+    for (std::size_t I = 0; I < Count; ++I)
+    {
+        OutLength[I] = std::sqrt(X[I] * X[I] + Y[I] * Y[I]);
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "CpuFeatures.h"
+
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#if CPU_FEATURES_X86
+#include <xmmintrin.h>
+#endif
+
+// Lengths and unit vectors from a reciprocal square root estimate refined by one Newton step, instead of
+// a sqrt and a divide. The x86 estimate has a relative error of at most 1.5 * 2^-12 (2^-14 for AVX-512),
+// which the Newton step squares; with rounding, every result here is within this relative error of the
+// exact one. That is 0.00002 px on a 50 px segment. Measured: 2.9e-7 for SSE/AVX2, 2.0e-7 for AVX-512.
+constexpr float FastInverseSqrtMaxRelativeError = 4e-7f;
+
+// Squared lengths at or below this count as zero. It keeps denormals, which the hardware estimate
+// flushes to an infinite result, away from the Newton step.
+constexpr float FastMinLengthSquared = std::numeric_limits<float>::min();
+
+// One Newton-Raphson step towards 1 / sqrt(Value) from Estimate. The vector kernels repeat these
+// operations in this order, so their lanes match the scalar result for the same estimate.
+inline float refineInverseSqrt(const float Value, const float Estimate)
+{
+    return Estimate * (1.5f - (0.5f * Value) * (Estimate * Estimate));
+}
+
+// 1 / sqrt(Value) for Value above FastMinLengthSquared
+inline float fastInverseSqrt(const float Value)
+{
+#if CPU_FEATURES_X86
+    return refineInverseSqrt(Value, _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(Value))));
+#else
+    // No estimate instruction to rely on: the classic bit-level guess is only within 3.5%, so it takes
+    // three steps to reach the same bound
+    std::uint32_t Bits;
+    std::memcpy(&Bits, &Value, sizeof(Bits));
+    Bits = 0x5f375a86u - (Bits >> 1);
+    float Estimate;
+    std::memcpy(&Estimate, &Bits, sizeof(Estimate));
+    return refineInverseSqrt(Value, refineInverseSqrt(Value, refineInverseSqrt(Value, Estimate)));
+#endif
+}
+
+inline float fastLength(const sf::Vector2f Vector)
+{
+    const float LengthSquared = Vector.x * Vector.x + Vector.y * Vector.y;
+    return LengthSquared > FastMinLengthSquared ? LengthSquared * fastInverseSqrt(LengthSquared) : 0.0f;
+}
+
+// Unit vector along Vector, or zero for a zero vector
+inline sf::Vector2f fastNormalize(const sf::Vector2f Vector)
+{
+    const float LengthSquared = Vector.x * Vector.x + Vector.y * Vector.y;
+    return LengthSquared > FastMinLengthSquared ? Vector * fastInverseSqrt(LengthSquared) : sf::Vector2f();
+}
+
+enum class VectorMathIsa
+{
+    Scalar,
+    Sse2,
+    Avx2,
+    Avx512
+};
+
+// Batched forms over separate X and Y arrays of Count vectors, any alignment. Outputs may alias the
+// inputs they replace. Zero vectors get length zero and a zero unit vector.
+using NormalizeBatchKernel = void (*)(const float* X, const float* Y, float* OutX, float* OutY, float* OutLength, std::size_t Count);
+using LengthBatchKernel = void (*)(const float* X, const float* Y, float* OutLength, std::size_t Count);
+
+// Picks the widest instruction set supported by both the build and the running CPU
+VectorMathIsa detectVectorMathIsa();
+const char* vectorMathIsaName(VectorMathIsa Isa);
+NormalizeBatchKernel normalizeBatchKernel(VectorMathIsa Isa);
+LengthBatchKernel lengthBatchKernel(VectorMathIsa Isa);
+
+// The batched forms on the detected instruction set
+void fastNormalizeBatch(const float* X, const float* Y, float* OutX, float* OutY, float* OutLength, std::size_t Count);
+void fastLengthBatch(const float* X, const float* Y, float* OutLength, std::size_t Count);
+
+// Reference with std::sqrt and a divide per vector, what the fast forms replace
+void exactNormalizeBatch(const float* X, const float* Y, float* OutX, float* OutY, float* OutLength, std::size_t Count);
+void exactLengthBatch(const float* X, const float* Y, float* OutLength, std::size_t Count);
+
+// Kernels built in their own translation units so each can be compiled for its instruction set. Lanes
+// match the scalar fast forms exactly, except AVX-512, whose finer estimate can differ by an ulp.
+void fastNormalizeBatchScalar(const float* X, const float* Y, float* OutX, float* OutY, float* OutLength, std::size_t Count);
+void fastLengthBatchScalar(const float* X, const float* Y, float* OutLength, std::size_t Count);
+void fastNormalizeBatchSse2(const float* X, const float* Y, float* OutX, float* OutY, float* OutLength, std::size_t Count);
+void fastLengthBatchSse2(const float* X, const float* Y, float* OutLength, std::size_t Count);
+void fastNormalizeBatchAvx2(const float* X, const float* Y, float* OutX, float* OutY, float* OutLength, std::size_t Count);
+void fastLengthBatchAvx2(const float* X, const float* Y, float* OutLength, std::size_t Count);
+void fastNormalizeBatchAvx512(const float* X, const float* Y, float* OutX, float* OutY, float* OutLength, std::size_t Count);
+void fastLengthBatchAvx512(const float* X, const float* Y, float* OutLength, std::size_t Count);
@@ -0,0 +1,41 @@
+// Compiled with AVX2 enabled (see the project files); only called after detectVectorMathIsa() has
+// confirmed the CPU supports it.
+
+#include "VectorMath.h"
+#include "VectorMathKernel.h"
+
+#if CPU_FEATURES_X86
+
+#include <immintrin.h>
+
+namespace
+{
+    struct Avx2Lanes
+    {
+        using Float = __m256;
+        using Mask = __m256;
+        static constexpr std::size_t Width = 8;
+
+        static Float set(const float Value) { return _mm256_set1_ps(Value); }
+        static Float loadu(const float* Address) { return _mm256_loadu_ps(Address); }
+        static void storeu(float* Address, const Float Value) { _mm256_storeu_ps(Address, Value); }
+        static Float add(const Float A, const Float B) { return _mm256_add_ps(A, B); }
+        static Float sub(const Float A, const Float B) { return _mm256_sub_ps(A, B); }
+        static Float mul(const Float A, const Float B) { return _mm256_mul_ps(A, B); }
+        static Float rsqrt(const Float Value) { return _mm256_rsqrt_ps(Value); }
+        static Mask greater(const Float A, const Float B) { return _mm256_cmp_ps(A, B, _CMP_GT_OQ); }
+        static Float select(const Mask Condition, const Float IfTrue, const Float IfFalse) { return _mm256_blendv_ps(IfFalse, IfTrue, Condition); }
+    };
+}
+
+void fastNormalizeBatchAvx2(const float* X, const float* Y, float* OutX, float* OutY, float* OutLength, const std::size_t Count)
+{
+    VectorMathDetail::normalizeBatchLanes<Avx2Lanes>(X, Y, OutX, OutY, OutLength, Count);
+}
+
+void fastLengthBatchAvx2(const float* X, const float* Y, float* OutLength, const std::size_t Count)
+{
+    VectorMathDetail::lengthBatchLanes<Avx2Lanes>(X, Y, OutLength, Count);
+}
+
+#endif
@@ -0,0 +1,41 @@
+// Compiled with AVX-512F enabled (see the project files); only called after detectVectorMathIsa() has
+// confirmed the CPU and operating system support it.
+
+#include "VectorMath.h"
+#include "VectorMathKernel.h"
+
+#if CPU_FEATURES_X86
+
+#include <immintrin.h>
+
+namespace
+{
+    struct Avx512Lanes
+    {
+        using Float = __m512;
+        using Mask = __mmask16;
+        static constexpr std::size_t Width = 16;
+
+        static Float set(const float Value) { return _mm512_set1_ps(Value); }
+        static Float loadu(const float* Address) { return _mm512_loadu_ps(Address); }
+        static void storeu(float* Address, const Float Value) { _mm512_storeu_ps(Address, Value); }
+        static Float add(const Float A, const Float B) { return _mm512_add_ps(A, B); }
+        static Float sub(const Float A, const Float B) { return _mm512_sub_ps(A, B); }
+        static Float mul(const Float A, const Float B) { return _mm512_mul_ps(A, B); }
+        static Float rsqrt(const Float Value) { return _mm512_rsqrt14_ps(Value); }
+        static Mask greater(const Float A, const Float B) { return _mm512_cmp_ps_mask(A, B, _CMP_GT_OQ); }
+        static Float select(const Mask Condition, const Float IfTrue, const Float IfFalse) { return _mm512_mask_blend_ps(Condition, IfFalse, IfTrue); }
+    };
+}
+
+void fastNormalizeBatchAvx512(const float* X, const float* Y, float* OutX, float* OutY, float* OutLength, const std::size_t Count)
+{
+    VectorMathDetail::normalizeBatchLanes<Avx512Lanes>(X, Y, OutX, OutY, OutLength, Count);
+}
+
+void fastLengthBatchAvx512(const float* X, const float* Y, float* OutLength, const std::size_t Count)
+{
+    VectorMathDetail::lengthBatchLanes<Avx512Lanes>(X, Y, OutLength, Count);
+}
+
+#endif
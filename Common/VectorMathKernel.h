@@ -0,0 +1,65 @@
+#pragma once
+
+// Instruction-set independent body of the batched vector math kernels, also used by other vector kernels
+// that normalize. Only included by translation units that supply a lane type V wrapping one register width
+// with set, add, sub, mul, rsqrt (the hardware estimate), greater and select, plus loadu and storeu for the
+// batch loops.
+
+#include "VectorMath.h"
+
+#include <cstddef>
+
+namespace VectorMathDetail
+{
+    // 1 / sqrt(Value) in every lane, the same operations as fastInverseSqrt
+    template <class V>
+    inline typename V::Float inverseSqrtLanes(const typename V::Float Value)
+    {
+        using F = typename V::Float;
+        const F Estimate = V::rsqrt(Value);
+        return V::mul(Estimate, V::sub(V::set(1.5f), V::mul(V::mul(V::set(0.5f), Value), V::mul(Estimate, Estimate))));
+    }
+
+    template <class V>
+    inline void normalizeBatchLanes(const float* X, const float* Y, float* OutX, float* OutY, float* OutLength, const std::size_t Count)
+    {
+        using F = typename V::Float;
+
+        const F Zero = V::set(0.0f);
+        const F MinLengthSquared = V::set(FastMinLengthSquared);
+        std::size_t I = 0;
+        for (; I + V::Width <= Count; I += V::Width)
+        {
+            const F VectorX = V::loadu(X + I);
+            const F VectorY = V::loadu(Y + I);
+            const F LengthSquared = V::add(V::mul(VectorX, VectorX), V::mul(VectorY, VectorY));
+
+            // Zero lanes get an infinite estimate and a NaN from the Newton step, which the select discards
+            const auto NonZero = V::greater(LengthSquared, MinLengthSquared);
+            const F Inverse = inverseSqrtLanes<V>(LengthSquared);
+            V::storeu(OutX + I, V::select(NonZero, V::mul(VectorX, Inverse), Zero));
+            V::storeu(OutY + I, V::select(NonZero, V::mul(VectorY, Inverse), Zero));
+            V::storeu(OutLength + I, V::select(NonZero, V::mul(LengthSquared, Inverse), Zero));
+        }
+        fastNormalizeBatchScalar(X + I, Y + I, OutX + I, OutY + I, OutLength + I, Count - I);
+    }
+
+    template <class V>
+    inline void lengthBatchLanes(const float* X, const float* Y, float* OutLength, const std::size_t Count)
+    {
+        using F = typename V::Float;
+
+        const F Zero = V::set(0.0f);
+        const F MinLengthSquared = V::set(FastMinLengthSquared);
+        std::size_t I = 0;
+        for (; I + V::Width <= Count; I += V::Width)
+        {
+            const F VectorX = V::loadu(X + I);
+            const F VectorY = V::loadu(Y + I);
+            const F LengthSquared = V::add(V::mul(VectorX, VectorX), V::mul(VectorY, VectorY));
+            const auto NonZero = V::greater(LengthSquared, MinLengthSquared);
+            V::storeu(OutLength + I, V::select(NonZero, V::mul(LengthSquared, inverseSqrtLanes<V>(LengthSquared)), Zero));
+        }
+        fastLengthBatchScalar(X + I, Y + I, OutLength + I, Count - I);
+    }
+}
@@ -0,0 +1,43 @@
+// Baseline vector kernels: SSE2 is part of x86-64, so these need no runtime check.
+
+#include "VectorMath.h"
+#include "VectorMathKernel.h"
+
+#if CPU_FEATURES_X86
+
+#include <emmintrin.h>
+
+namespace
+{
+    struct Sse2Lanes
+    {
+        using Float = __m128;
+        using Mask = __m128;
+        static constexpr std::size_t Width = 4;
+
+        static Float set(const float Value) { return _mm_set1_ps(Value); }
+        static Float loadu(const float* Address) { return _mm_loadu_ps(Address); }
+        static void storeu(float* Address, const Float Value) { _mm_storeu_ps(Address, Value); }
+        static Float add(const Float A, const Float B) { return _mm_add_ps(A, B); }
+        static Float sub(const Float A, const Float B) { return _mm_sub_ps(A, B); }
+        static Float mul(const Float A, const Float B) { return _mm_mul_ps(A, B); }
+        static Float rsqrt(const Float Value) { return _mm_rsqrt_ps(Value); }
+        static Mask greater(const Float A, const Float B) { return _mm_cmpgt_ps(A, B); }
+        static Float select(const Mask Condition, const Float IfTrue, const Float IfFalse)
+        {
+            return _mm_or_ps(_mm_and_ps(Condition, IfTrue), _mm_andnot_ps(Condition, IfFalse));
+        }
+    };
+}
+
+void fastNormalizeBatchSse2(const float* X, const float* Y, float* OutX, float* OutY, float* OutLength, const std::size_t Count)
+{
+    VectorMathDetail::normalizeBatchLanes<Sse2Lanes>(X, Y, OutX, OutY, OutLength, Count);
+}
+
+void fastLengthBatchSse2(const float* X, const float* Y, float* OutLength, const std::size_t Count)
+{
+    VectorMathDetail::lengthBatchLanes<Sse2Lanes>(X, Y, OutLength, Count);
+}
+
+#endif
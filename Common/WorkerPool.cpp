@@ -0,0 +1,337 @@
+#include "WorkerPool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iomanip>
+#include <ostream>
+
+namespace
+{
+    // Several chunks per thread so a thread that is descheduled briefly does not stall the frame
+    constexpr std::size_t ChunksPerThread = 4;
+
+    // Which pool the current thread works for, so tasks submitted from inside a task go to its own deque
+    thread_local const WorkerPool* CurrentPool = nullptr;
+    thread_local unsigned CurrentThread = 0;
+}
+
+WorkerPool::WorkerPool(const unsigned Threads)
+    : ThreadCount(Threads ? Threads : std::max(1u, std::thread::hardware_concurrency()))
+    , StatsStart(std::chrono::steady_clock::now())
+{
+    Deques = std::make_unique<Deque[]>(ThreadCount);
+    for (unsigned I = 0; I < ThreadCount; ++I)
+    {
+        Deques[I].Ring.resize(MaxTasks);
+    }
+    Tasks = std::make_unique<Task[]>(MaxTasks);
+    FreeSlots.resize(MaxTasks);
+    for (std::uint32_t Slot = 0; Slot < MaxTasks; ++Slot)
+    {
+        FreeSlots[Slot] = MaxTasks - 1 - Slot;
+    }
+
+    Workers.reserve(ThreadCount - 1);
+    for (unsigned I = 1; I < ThreadCount; ++I)
+    {
+        Workers.emplace_back(&WorkerPool::workerLoop, this, I);
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard Lock(WakeMutex);
+        Stopping = true;
+    }
+    WakeCondition.notify_all();
+    for (auto& Worker : Workers)
+    {
+        Worker.join();
+    }
+}
+
+WorkerPool::TaskId WorkerPool::submit(TaskGroup& Group, const Job& Work, const std::initializer_list<TaskId> Dependencies)
+{
+    const std::uint32_t Slot = allocateTask();
+    Task& NewTask = Tasks[Slot];
+    NewTask.Work = Work;
+    NewTask.Begin = 0;
+    NewTask.End = 0;
+    NewTask.Group = &Group;
+    NewTask.Tracked = true;
+    NewTask.SuccessorCount = 0;
+    NewTask.Blockers.store(static_cast<std::uint32_t>(Dependencies.size()) + 1, std::memory_order_relaxed);
+    Group.Pending.fetch_add(1, std::memory_order_relaxed);
+
+    const TaskId Id{ Slot, NewTask.Generation };
+
+    // A dependency that already finished counts as met. One whose successor list is full is waited out
+    // here, running other tasks meanwhile, rather than failing the submit.
+    std::uint32_t Met = 0;
+    for (const TaskId& Dependency : Dependencies)
+    {
+        while (true)
+        {
+            {
+                std::lock_guard Lock(DependencyMutex);
+                Task& Before = Tasks[Dependency.Slot];
+                if (Before.Generation != Dependency.Generation)
+                {
+                    ++Met;
+                    break;
+                }
+                if (Before.SuccessorCount < MaxSuccessors)
+                {
+                    Before.Successors[Before.SuccessorCount++] = Slot;
+                    break;
+                }
+            }
+            if (!runOne(currentThread()))
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    if (NewTask.Blockers.fetch_sub(Met + 1, std::memory_order_acq_rel) == Met + 1)
+    {
+        push(Slot);
+        wake();
+    }
+    return Id;
+}
+
+void WorkerPool::wait(TaskGroup& Group)
+{
+    const unsigned Thread = currentThread();
+    while (!Group.done())
+    {
+        if (!runOne(Thread))
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void WorkerPool::parallelFor(const std::size_t Count, const std::size_t Alignment, const Job& Work)
+{
+    if (Count == 0)
+    {
+        return;
+    }
+
+    const std::size_t Target = (Count + threadCount() * ChunksPerThread - 1) / (threadCount() * ChunksPerThread);
+    const std::size_t Size = std::max(Alignment, (Target + Alignment - 1) / Alignment * Alignment);
+    if (Workers.empty() || Size >= Count)
+    {
+        Work(0, Count);
+        return;
+    }
+
+    TaskGroup Group;
+    for (std::size_t Begin = 0; Begin < Count; Begin += Size)
+    {
+        const std::uint32_t Slot = allocateTask();
+        Task& Chunk = Tasks[Slot];
+        Chunk.Work = Work;
+        Chunk.Begin = Begin;
+        Chunk.End = std::min(Begin + Size, Count);
+        Chunk.Group = &Group;
+        Chunk.Tracked = false;
+        Group.Pending.fetch_add(1, std::memory_order_relaxed);
+        push(Slot);
+    }
+    wake();
+    wait(Group);
+}
+
+WorkerPool::WorkerStats WorkerPool::workerStats(const unsigned Thread) const
+{
+    const Deque& Owner = Deques[Thread];
+    WorkerStats Stats;
+    Stats.Tasks = Owner.Tasks.load(std::memory_order_relaxed);
+    Stats.Steals = Owner.Steals.load(std::memory_order_relaxed);
+    Stats.BusySeconds = static_cast<double>(Owner.BusyNanoseconds.load(std::memory_order_relaxed)) * 1e-9;
+    const double Elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - StatsStart).count();
+    Stats.Utilization = Elapsed > 0.0 ? std::min(1.0, Stats.BusySeconds / Elapsed) : 0.0;
+    return Stats;
+}
+
+void WorkerPool::resetStats()
+{
+    for (unsigned I = 0; I < threadCount(); ++I)
+    {
+        Deques[I].Tasks.store(0, std::memory_order_relaxed);
+        Deques[I].Steals.store(0, std::memory_order_relaxed);
+        Deques[I].BusyNanoseconds.store(0, std::memory_order_relaxed);
+    }
+    StatsStart = std::chrono::steady_clock::now();
+}
+
+unsigned WorkerPool::currentThread() const
+{
+    return CurrentPool == this ? CurrentThread : 0;
+}
+
+std::uint32_t WorkerPool::allocateTask()
+{
+    while (true)
+    {
+        {
+            std::lock_guard Lock(FreeMutex);
+            if (!FreeSlots.empty())
+            {
+                const std::uint32_t Slot = FreeSlots.back();
+                FreeSlots.pop_back();
+                return Slot;
+            }
+        }
+        // Every slot is queued or running: help drain them instead of growing the slab
+        if (!runOne(currentThread()))
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void WorkerPool::releaseTask(const std::uint32_t Slot)
+{
+    std::lock_guard Lock(FreeMutex);
+    FreeSlots.push_back(Slot);
+}
+
+void WorkerPool::push(const std::uint32_t Slot)
+{
+    Deque& Owner = Deques[currentThread()];
+    std::lock_guard Lock(Owner.Mutex);
+    assert(Owner.Bottom - Owner.Top < MaxTasks);
+    Owner.Ring[Owner.Bottom++ % MaxTasks] = Slot;
+}
+
+void WorkerPool::wake()
+{
+    // Pairs with the sleeper raising Sleepers before it rechecks WorkEpoch: either it sees the new epoch
+    // or this sees it asleep and notifies under the lock it waits with
+    WorkEpoch.fetch_add(1);
+    if (Sleepers.load() > 0)
+    {
+        {
+            std::lock_guard Lock(WakeMutex);
+        }
+        WakeCondition.notify_all();
+    }
+}
+
+bool WorkerPool::popOrSteal(const unsigned Thread, std::uint32_t& Slot)
+{
+    {
+        Deque& Own = Deques[Thread];
+        std::lock_guard Lock(Own.Mutex);
+        if (Own.Bottom > Own.Top)
+        {
+            Slot = Own.Ring[--Own.Bottom % MaxTasks];
+            return true;
+        }
+    }
+
+    const unsigned Count = threadCount();
+    for (unsigned Offset = 1; Offset < Count; ++Offset)
+    {
+        Deque& Victim = Deques[(Thread + Offset) % Count];
+        std::lock_guard Lock(Victim.Mutex);
+        if (Victim.Bottom > Victim.Top)
+        {
+            Slot = Victim.Ring[Victim.Top++ % MaxTasks];
+            Deques[Thread].Steals.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkerPool::runOne(const unsigned Thread)
+{
+    std::uint32_t Slot;
+    if (!popOrSteal(Thread, Slot))
+    {
+        return false;
+    }
+    run(Thread, Slot);
+    return true;
+}
+
+void WorkerPool::run(const unsigned Thread, const std::uint32_t Slot)
+{
+    Task& Current = Tasks[Slot];
+    const auto Start = std::chrono::steady_clock::now();
+    Current.Work(Current.Begin, Current.End);
+    const auto Busy = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - Start);
+    Deques[Thread].BusyNanoseconds.fetch_add(static_cast<std::uint64_t>(Busy.count()), std::memory_order_relaxed);
+    Deques[Thread].Tasks.fetch_add(1, std::memory_order_relaxed);
+
+    if (Current.Tracked)
+    {
+        // Retiring the generation under the lock means no successor can be added after the list is read
+        std::uint32_t Ready[MaxSuccessors];
+        std::uint32_t ReadyCount;
+        {
+            std::lock_guard Lock(DependencyMutex);
+            ++Current.Generation;
+            ReadyCount = Current.SuccessorCount;
+            std::copy(Current.Successors, Current.Successors + ReadyCount, Ready);
+        }
+
+        bool Pushed = false;
+        for (std::uint32_t I = 0; I < ReadyCount; ++I)
+        {
+            if (Tasks[Ready[I]].Blockers.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                push(Ready[I]);
+                Pushed = true;
+            }
+        }
+        if (Pushed)
+        {
+            wake();
+        }
+    }
+
+    TaskGroup* Group = Current.Group;
+    releaseTask(Slot);
+    Group->Pending.fetch_sub(1, std::memory_order_release);
+}
+
+void WorkerPool::workerLoop(const unsigned Thread)
+{
+    CurrentPool = this;
+    CurrentThread = Thread;
+    while (true)
+    {
+        const std::uint64_t SeenEpoch = WorkEpoch.load();
+        if (runOne(Thread))
+        {
+            continue;
+        }
+
+        std::unique_lock Lock(WakeMutex);
+        Sleepers.fetch_add(1);
+        WakeCondition.wait(Lock, [&] { return Stopping || WorkEpoch.load() != SeenEpoch; });
+        Sleepers.fetch_sub(1);
+        if (Stopping)
+        {
+            return;
+        }
+    }
+}
+
+void printWorkerStats(const WorkerPool& Pool, std::ostream& Stream)
+{
+    Stream << "thread     tasks    steals    busy" << std::endl;
+    for (unsigned Thread = 0; Thread < Pool.threadCount(); ++Thread)
+    {
+        const WorkerPool::WorkerStats Stats = Pool.workerStats(Thread);
+        Stream << std::setw(6) << Thread << std::setw(10) << Stats.Tasks << std::setw(10) << Stats.Steals
+            << std::fixed << std::setprecision(1) << std::setw(7) << Stats.Utilization * 100.0 << '%' << std::endl;
+    }
+}
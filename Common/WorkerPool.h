@@ -0,0 +1,176 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Work-stealing task scheduler shared by every exercise: blades of a field, screen tiles, worm chains and
+// curve segments all run on the same threads. Each thread owns a deque of ready tasks; it pushes and pops
+// its own at the bottom, and a thread that runs dry steals the oldest task from the top of another's, so
+// work that spawns more work stays local while idle threads still pick up the slack. Threads are created
+// once and sleep while there is nothing to run, and a thread waiting on a group runs tasks instead of
+// blocking, so tasks may submit and wait on tasks of their own. Tasks live in a fixed slab and the deques
+// are fixed rings, so submitting never touches the heap.
+class WorkerPool
+{
+public:
+    // Non-owning reference to a callable taking (Begin, End) or nothing. Unlike std::function it never
+    // copies the callable, so handing the pool a lambda with many captures every frame does not touch the
+    // heap. The callable has to outlive every task that runs it.
+    class Job
+    {
+    public:
+        template <typename Callable, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Callable>, Job>>>
+        Job(Callable&& Work)
+            : Object(const_cast<void*>(static_cast<const void*>(std::addressof(Work))))
+            , Invoke([](void* Object, const std::size_t Begin, const std::size_t End)
+                {
+                    auto& Work = *static_cast<std::remove_reference_t<Callable>*>(Object);
+                    if constexpr (std::is_invocable_v<decltype(Work), std::size_t, std::size_t>)
+                    {
+                        Work(Begin, End);
+                    }
+                    else
+                    {
+                        Work();
+                    }
+                })
+        {
+        }
+
+        void operator()(const std::size_t Begin, const std::size_t End) const { Invoke(Object, Begin, End); }
+
+    private:
+        friend class WorkerPool;
+        Job() = default;
+
+        void* Object = nullptr;
+        void (*Invoke)(void* Object, std::size_t Begin, std::size_t End) = nullptr;
+    };
+
+    // Counts the tasks submitted under it that have not finished yet
+    class TaskGroup
+    {
+    public:
+        TaskGroup() = default;
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        bool done() const { return Pending.load(std::memory_order_acquire) == 0; }
+
+    private:
+        friend class WorkerPool;
+        std::atomic<std::size_t> Pending{ 0 };
+    };
+
+    // Handle to a submitted task, only good for naming it as a dependency of later tasks. A handle to a
+    // task that has already finished is a satisfied dependency.
+    struct TaskId
+    {
+        std::uint32_t Slot = 0;
+        std::uint32_t Generation = 0;
+    };
+
+    struct WorkerStats
+    {
+        std::uint64_t Tasks = 0;  // Tasks run by this thread
+        std::uint64_t Steals = 0; // Tasks it took from another thread's deque
+        double BusySeconds = 0.0; // Time spent inside tasks
+        double Utilization = 0.0; // BusySeconds over the time since the pool started or stats were reset
+    };
+
+    // ThreadCount includes the calling thread; 0 means one per hardware thread
+    explicit WorkerPool(unsigned ThreadCount = 0);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    unsigned threadCount() const { return ThreadCount; }
+
+    // Queues Work to run once, as Work(0, 0), after every task in Dependencies has finished
+    TaskId submit(TaskGroup& Group, const Job& Work, std::initializer_list<TaskId> Dependencies = {});
+
+    // Runs tasks until every task submitted under Group has finished
+    void wait(TaskGroup& Group);
+
+    // Runs Work over [0, Count) and blocks until it has all finished. The range is cut into a few chunks per
+    // thread, each a multiple of Alignment, so small ranges run inline on the caller and large ones leave
+    // enough chunks for stealing to even out threads that are slow or descheduled.
+    void parallelFor(std::size_t Count, std::size_t Alignment, const Job& Work);
+    void parallelFor(const std::size_t Count, const Job& Work) { parallelFor(Count, 1, Work); }
+
+    // Thread 0 is every thread outside the pool, normally the main thread
+    WorkerStats workerStats(unsigned Thread) const;
+    void resetStats();
+
+private:
+    static constexpr std::uint32_t MaxTasks = 4096;
+    static constexpr std::uint32_t MaxSuccessors = 8;
+
+    struct Task
+    {
+        Job Work;
+        std::size_t Begin = 0;
+        std::size_t End = 0;
+        TaskGroup* Group = nullptr;
+        bool Tracked = false;                    // Submitted with a handle, so completion wakes successors
+        std::atomic<std::uint32_t> Blockers{ 0 }; // Unfinished dependencies, plus one while being submitted
+        std::uint32_t Generation = 0;            // Bumped when the task finishes, under DependencyMutex
+        std::uint32_t SuccessorCount = 0;
+        std::uint32_t Successors[MaxSuccessors];
+    };
+
+    // One per thread: a fixed ring of ready task slots, bottom for the owner and top for thieves
+    struct alignas(64) Deque
+    {
+        std::mutex Mutex;
+        std::vector<std::uint32_t> Ring;
+        std::uint64_t Top = 0;
+        std::uint64_t Bottom = 0;
+
+        std::atomic<std::uint64_t> Tasks{ 0 };
+        std::atomic<std::uint64_t> Steals{ 0 };
+        std::atomic<std::uint64_t> BusyNanoseconds{ 0 };
+    };
+
+    unsigned currentThread() const;
+    std::uint32_t allocateTask();
+    void releaseTask(std::uint32_t Slot);
+    void push(std::uint32_t Slot);
+    void wake();
+    bool popOrSteal(unsigned Thread, std::uint32_t& Slot);
+    bool runOne(unsigned Thread);
+    void run(unsigned Thread, std::uint32_t Slot);
+    void workerLoop(unsigned Thread);
+
+    unsigned ThreadCount = 1; // Fixed before the first worker starts, unlike Workers.size()
+    std::vector<std::thread> Workers;
+    std::unique_ptr<Deque[]> Deques;
+    std::unique_ptr<Task[]> Tasks;
+
+    std::mutex FreeMutex;
+    std::vector<std::uint32_t> FreeSlots;
+    std::mutex DependencyMutex;
+
+    // Sleeping workers wait for WorkEpoch to move; pushers only take WakeMutex when someone is asleep
+    std::mutex WakeMutex;
+    std::condition_variable WakeCondition;
+    std::atomic<std::uint64_t> WorkEpoch{ 0 };
+    std::atomic<unsigned> Sleepers{ 0 };
+    bool Stopping = false;
+
+    std::chrono::steady_clock::time_point StatsStart;
+};
+
+// One line per thread with tasks run, steals and utilization since the stats were last reset
+void printWorkerStats(const WorkerPool& Pool, std::ostream& Stream);
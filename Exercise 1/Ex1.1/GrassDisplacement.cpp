@@ -0,0 +1,276 @@
+#include "GrassDisplacement.h"
+
+#include "GrassWorkerPool.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace
+{
+    // Enough bands that one crowded with colliders does not hold up the rest of the pool
+    constexpr int MaxBands = 64;
+
+    // Lean below which a blade counts as released
+    constexpr float RestBend = 1e-3f;
+
+    // Blades eased and bent together, sized so the scratch rows below stay in L1
+    constexpr std::size_t BendBlock = 256;
+
+    // Blends every segment of blades [Begin, Begin + Count) towards a blade leaning by Bend, with its sway
+    // spread along it as Bend * I / SegmentCount like the kinematic update, in proportion to |Bend| / MaxBend.
+    // The wind sway can curl a blade through several radians, so adding the bend on top would only turn the
+    // curl; blending the directions instead straightens a pushed blade out of the wind and lays it over.
+    // Works a segment row at a time across the blades; a blade with no bend keeps its segments unchanged.
+    void bendBlades(GrassField& Field, const float* Bend, const float MaxBend, const std::size_t Begin, const std::size_t Count)
+    {
+        alignas(64) float Weight[BendBlock];
+        alignas(64) float SegmentLength[BendBlock];
+        alignas(64) float StepSin[BendBlock];
+        alignas(64) float StepCos[BendBlock];
+        alignas(64) float LeanSin[BendBlock];
+        alignas(64) float LeanCos[BendBlock];
+        alignas(64) float PreviousX[BendBlock];
+        alignas(64) float PreviousY[BendBlock];
+        alignas(64) float X[BendBlock];
+        alignas(64) float Y[BendBlock];
+
+        // The step is at most MaxBend / SegmentCount, small enough for short Taylor series (error below
+        // 1e-4 even for a single segment at 1.2 rad) instead of a library sin/cos per blade
+        const float InvSegments = 1.0f / static_cast<float>(Field.SegmentCount);
+        const float InvMaxBend = 1.0f / MaxBend;
+        for (std::size_t I = 0; I < Count; ++I)
+        {
+            const float Step = Bend[Begin + I] * InvSegments;
+            const float StepSquared = Step * Step;
+            Weight[I] = std::min(1.0f, std::abs(Bend[Begin + I]) * InvMaxBend);
+            SegmentLength[I] = BaseGrassLength * Field.LengthVariance[Begin + I] * InvSegments;
+            StepSin[I] = Step * (1.0f - StepSquared / 6.0f * (1.0f - StepSquared / 20.0f));
+            StepCos[I] = 1.0f - StepSquared / 2.0f * (1.0f - StepSquared / 12.0f * (1.0f - StepSquared / 30.0f));
+            LeanSin[I] = 0.0f;
+            LeanCos[I] = 1.0f;
+            PreviousX[I] = X[I] = Field.BaseX[Begin + I];
+            PreviousY[I] = Y[I] = Field.BaseY[Begin + I];
+        }
+
+        for (int Segment = 1; Segment <= Field.SegmentCount; ++Segment)
+        {
+            float* RowX = Field.segmentRowX(Segment) + Begin;
+            float* RowY = Field.segmentRowY(Segment) + Begin;
+            for (std::size_t I = 0; I < Count; ++I)
+            {
+                const float Sin = LeanSin[I] * StepCos[I] + LeanCos[I] * StepSin[I];
+                const float Cos = LeanCos[I] * StepCos[I] - LeanSin[I] * StepSin[I];
+                LeanSin[I] = Sin;
+                LeanCos[I] = Cos;
+
+                // Lerp the segment towards the leaning one, then put its length back
+                const float DeltaX = RowX[I] - PreviousX[I];
+                const float DeltaY = RowY[I] - PreviousY[I];
+                PreviousX[I] = RowX[I];
+                PreviousY[I] = RowY[I];
+                const float BlendX = DeltaX + (Sin * SegmentLength[I] - DeltaX) * Weight[I];
+                const float BlendY = DeltaY + (-Cos * SegmentLength[I] - DeltaY) * Weight[I];
+                const float Scale = SegmentLength[I] / std::sqrt(BlendX * BlendX + BlendY * BlendY + 1e-12f);
+                X[I] += BlendX * Scale;
+                Y[I] += BlendY * Scale;
+                RowX[I] = X[I];
+                RowY[I] = Y[I];
+            }
+        }
+    }
+
+    // Eases Count blades towards their push, clamped to MaxBend, or back to 0 once released, and
+    // clears the pushes. Returns how many are left bent. Any bend too small to see is snapped to 0, pushed
+    // or not, which keeps the loop to plain selects so it vectorizes.
+    int easeBlades(float* Push, float* Bend, const std::size_t Count, const float MaxBend, const float PressBlend, const float RecoveryBlend)
+    {
+        int Bent = 0;
+        for (std::size_t I = 0; I < Count; ++I)
+        {
+            const float Target = std::min(std::max(Push[I], -MaxBend), MaxBend);
+            const float Eased = Bend[I] + (Target - Bend[I]) * (Target != 0.0f ? PressBlend : RecoveryBlend);
+            Bend[I] = std::abs(Eased) >= RestBend ? Eased : 0.0f;
+            Push[I] = 0.0f;
+            Bent += Bend[I] != 0.0f;
+        }
+        return Bent;
+    }
+
+    // Adds one collider's push to blades [Begin, End). Falloff is on squared distance, so the loop has no
+    // sqrt or branch and vectorizes.
+    void pushBlades(const GrassField& Field, float* Push, const GrassCollider& Collider, const float MaxBend, const std::size_t Begin,
+        const std::size_t End)
+    {
+        const float* BaseX = Field.BaseX;
+        const float* BaseY = Field.BaseY;
+        const float* LengthVariance = Field.LengthVariance;
+        const float CenterX = Collider.Position.x;
+        const float CenterY = Collider.Position.y;
+        const float InvRadiusSquared = 1.0f / (Collider.Radius * Collider.Radius);
+        for (std::size_t Blade = Begin; Blade < End; ++Blade)
+        {
+            // Nearest point to the collider on the blade standing straight
+            const float TopY = BaseY[Blade] - BaseGrassLength * LengthVariance[Blade];
+            const float OffsetX = BaseX[Blade] - CenterX;
+            const float OffsetY = std::min(std::max(CenterY, TopY), BaseY[Blade]) - CenterY;
+            const float Falloff = std::max(0.0f, 1.0f - (OffsetX * OffsetX + OffsetY * OffsetY) * InvRadiusSquared);
+
+            // Positive sway leans towards +x, so blades right of the collider are pushed right
+            Push[Blade] += std::copysign(MaxBend * Falloff, OffsetX);
+        }
+    }
+
+    // Reorders every per-blade array of Field, attributes and segment rows alike, so blade I becomes Order[I]
+    void permuteBlades(GrassField& Field, const std::vector<std::uint32_t>& Order)
+    {
+        std::vector<float> Scratch(Field.BladeCount);
+        const auto permute = [&](float* Values)
+        {
+            for (std::size_t Blade = 0; Blade < Field.BladeCount; ++Blade)
+            {
+                Scratch[Blade] = Values[Order[Blade]];
+            }
+            std::copy(Scratch.begin(), Scratch.end(), Values);
+        };
+        for (std::size_t Array = 0; Array < GrassAttributeArrays; ++Array)
+        {
+            permute(Field.BaseX + Array * Field.Stride);
+        }
+        for (int Segment = 0; Segment <= Field.SegmentCount; ++Segment)
+        {
+            permute(Field.segmentRowX(Segment));
+            permute(Field.segmentRowY(Segment));
+        }
+    }
+}
+
+void buildGrassBladeGrid(GrassBladeGrid& Grid, GrassField& Field, const float CellSize)
+{
+    float MinX = 0.0f;
+    float MaxX = 0.0f;
+    float MinY = 0.0f;
+    float MaxY = 0.0f;
+    float MaxLength = 0.0f;
+    if (Field.BladeCount > 0)
+    {
+        MinX = MaxX = Field.BaseX[0];
+        MinY = MaxY = Field.BaseY[0];
+    }
+    for (std::size_t Blade = 0; Blade < Field.BladeCount; ++Blade)
+    {
+        MinX = std::min(MinX, Field.BaseX[Blade]);
+        MaxX = std::max(MaxX, Field.BaseX[Blade]);
+        MinY = std::min(MinY, Field.BaseY[Blade]);
+        MaxY = std::max(MaxY, Field.BaseY[Blade]);
+        MaxLength = std::max(MaxLength, Field.LengthVariance[Blade]);
+    }
+
+    Grid.CellSize = CellSize;
+    Grid.OriginX = MinX;
+    Grid.OriginY = MinY;
+    Grid.Columns = Grid.column(MaxX) + 1;
+    Grid.Rows = Grid.row(MaxY) + 1;
+    Grid.MaxBladeLength = BaseGrassLength * MaxLength;
+
+    // Counting sort: cell sizes, then prefix sums, then a scatter of the blade indices
+    const auto cellOf = [&Grid, &Field](const std::size_t Blade)
+    {
+        return static_cast<std::size_t>(Grid.column(Field.BaseX[Blade])) * Grid.Rows + static_cast<std::size_t>(Grid.row(Field.BaseY[Blade]));
+    };
+    Grid.CellStart.assign(static_cast<std::size_t>(Grid.Columns) * Grid.Rows + 1, 0);
+    for (std::size_t Blade = 0; Blade < Field.BladeCount; ++Blade)
+    {
+        ++Grid.CellStart[cellOf(Blade) + 1];
+    }
+    std::partial_sum(Grid.CellStart.begin(), Grid.CellStart.end(), Grid.CellStart.begin());
+    std::vector<std::uint32_t> Next(Grid.CellStart.begin(), Grid.CellStart.end() - 1);
+    std::vector<std::uint32_t> Order(Field.BladeCount);
+    for (std::size_t Blade = 0; Blade < Field.BladeCount; ++Blade)
+    {
+        Order[Next[cellOf(Blade)]++] = static_cast<std::uint32_t>(Blade);
+    }
+
+    // Order each cell by x, then move the blades themselves into that order. Both sorts are stable, so a
+    // field already in grid order comes out as the identity and is left untouched, which keeps a mapped
+    // snapshot from being copied page by page.
+    for (std::size_t Cell = 0; Cell + 1 < Grid.CellStart.size(); ++Cell)
+    {
+        std::stable_sort(Order.begin() + Grid.CellStart[Cell], Order.begin() + Grid.CellStart[Cell + 1],
+            [&Field](const std::uint32_t Left, const std::uint32_t Right) { return Field.BaseX[Left] < Field.BaseX[Right]; });
+    }
+    if (!std::is_sorted(Order.begin(), Order.end()))
+    {
+        permuteBlades(Field, Order);
+    }
+}
+
+void resetGrassDisplacement(GrassDisplacement& Displacement, const GrassField& Field, const GrassBladeGrid& Grid)
+{
+    Displacement.Bend.assign(Field.BladeCount, 0.0f);
+    Displacement.Push.assign(Field.BladeCount, 0.0f);
+    Displacement.BandColumns = std::max(1, (Grid.Columns + MaxBands - 1) / MaxBands);
+    Displacement.BandCount = static_cast<std::size_t>((Grid.Columns + Displacement.BandColumns - 1) / Displacement.BandColumns);
+}
+
+void applyGrassDisplacement(GrassDisplacement& Displacement, GrassField& Field, const GrassBladeGrid& Grid,
+    const std::span<const GrassCollider> Colliders, const float DeltaTime, WorkerPool& Pool)
+{
+    const GrassDisplacementSettings& Settings = Displacement.Settings;
+    const float PressBlend = 1.0f - std::exp(-Settings.PressRate * DeltaTime);
+    const float RecoveryBlend = 1.0f - std::exp(-Settings.RecoveryRate * DeltaTime);
+
+    Pool.parallelFor(Displacement.BandCount, 1, [&](const std::size_t BandBegin, const std::size_t BandEnd)
+    {
+        for (std::size_t Band = BandBegin; Band < BandEnd; ++Band)
+        {
+            const int FirstColumn = static_cast<int>(Band) * Displacement.BandColumns;
+            const int LastColumn = std::min(Grid.Columns, FirstColumn + Displacement.BandColumns) - 1;
+
+            // Gather pushes from the colliders overlapping this band. A blade can reach up to
+            // MaxBladeLength above its base, so the rows searched extend that far below the collider.
+            for (const GrassCollider& Collider : Colliders)
+            {
+                const float Left = Collider.Position.x - Collider.Radius;
+                const float Right = Collider.Position.x + Collider.Radius;
+                const int ColumnBegin = std::max(FirstColumn, Grid.column(Left));
+                const int ColumnEnd = std::min(LastColumn, Grid.column(Right));
+                const int RowBegin = std::max(0, Grid.row(Collider.Position.y - Collider.Radius));
+                const int RowEnd = std::min(Grid.Rows - 1, Grid.row(Collider.Position.y + Collider.Radius + Grid.MaxBladeLength));
+                for (int Column = ColumnBegin; Column <= ColumnEnd; ++Column)
+                {
+                    for (int Row = RowBegin; Row <= RowEnd; ++Row)
+                    {
+                        const std::size_t Cell = static_cast<std::size_t>(Column) * Grid.Rows + static_cast<std::size_t>(Row);
+                        const float* CellBegin = Field.BaseX + Grid.CellStart[Cell];
+                        const float* CellEnd = Field.BaseX + Grid.CellStart[Cell + 1];
+                        const float* First = std::lower_bound(CellBegin, CellEnd, Left);
+                        const float* Last = std::upper_bound(First, CellEnd, Right);
+                        pushBlades(Field, Displacement.Push.data(), Collider, Settings.MaxBend, static_cast<std::size_t>(First - Field.BaseX),
+                            static_cast<std::size_t>(Last - Field.BaseX));
+                    }
+                }
+            }
+
+            // Ease every blade of the band towards its push, or back to 0 once released, then bend
+            // the blocks that have any blade bent
+            const std::size_t BladeBegin = Grid.CellStart[static_cast<std::size_t>(FirstColumn) * Grid.Rows];
+            const std::size_t BladeEnd = Grid.CellStart[static_cast<std::size_t>(LastColumn + 1) * Grid.Rows];
+            float* Push = Displacement.Push.data();
+            float* Bend = Displacement.Bend.data();
+            for (std::size_t Block = BladeBegin; Block < BladeEnd; Block += BendBlock)
+            {
+                const std::size_t Count = std::min(BendBlock, BladeEnd - Block);
+                const int Bent = easeBlades(Push + Block, Bend + Block, Count, Settings.MaxBend, PressBlend, RecoveryBlend);
+                if (Bent)
+                {
+                    bendBlades(Field, Bend, Settings.MaxBend, Block, Count);
+                }
+            }
+        }
+    });
+}
+
+std::size_t displacedBladeCount(const GrassDisplacement& Displacement)
+{
+    return static_cast<std::size_t>(std::count_if(Displacement.Bend.begin(), Displacement.Bend.end(), [](const float Bend) { return Bend != 0.0f; }));
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "GrassField.h"
+
+#include <SFML/System/Vector2.hpp>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+class WorkerPool;
+
+// Uniform grid over the blade bases of one field, so a query only visits blades near a point. Building it
+// reorders the field itself into grid order with a counting sort, so cell C holds blades
+// [CellStart[C], CellStart[C + 1]) sorted by base x: a query narrows each cell to the blades in its x range
+// with a binary search and then scans them contiguously, and any pass over the blades of a run of cells
+// walks the field's arrays in order. Cells are column-major, so a run of whole columns is one blade range.
+struct GrassBladeGrid
+{
+    float CellSize = 0.0f;
+    float OriginX = 0.0f;
+    float OriginY = 0.0f;
+    int Columns = 0;
+    int Rows = 0;
+    float MaxBladeLength = 0.0f; // Longest blade, how far above its cell a blade can reach
+
+    std::vector<std::uint32_t> CellStart; // Columns * Rows + 1 blade offsets
+
+    int column(const float X) const { return static_cast<int>(std::floor((X - OriginX) / CellSize)); }
+    int row(const float Y) const { return static_cast<int>(std::floor((Y - OriginY) / CellSize)); }
+};
+
+// Sorts the blades of Field into grid order and buckets them. Anything indexed by blade (dynamics state)
+// must be set up after this, and the field's bases must not move afterwards. A field already in grid
+// order, such as one saved after its grid was built, is only read.
+void buildGrassBladeGrid(GrassBladeGrid& Grid, GrassField& Field, float CellSize = 16.0f);
+
+struct GrassCollider
+{
+    sf::Vector2f Position;
+    float Radius = 12.0f;
+};
+
+struct GrassDisplacementSettings
+{
+    float MaxBend = 1.2f;      // Lean of a fully pushed blade, radians
+    float PressRate = 20.0f;   // How fast a touched blade bends towards its push, 1/s
+    float RecoveryRate = 3.0f; // How fast a released blade returns to the wind, 1/s
+};
+
+// Lean pushed into blades by moving colliders, blended over whatever pose the update gave the field. The
+// grid's columns are split into bands that each own every blade in their cells, so the pool runs the bands
+// in parallel without sharing a blade.
+struct GrassDisplacement
+{
+    GrassDisplacementSettings Settings;
+    int BandColumns = 1;
+    std::size_t BandCount = 0;
+
+    std::vector<float> Bend; // Current lean per blade, signed towards +x
+    std::vector<float> Push; // Push gathered this frame per blade
+};
+
+void resetGrassDisplacement(GrassDisplacement& Displacement, const GrassField& Field, const GrassBladeGrid& Grid);
+
+// Pushes blades away from every collider that touches them (anywhere along their rest height, not just at
+// the base), eases each blade towards its push or back to rest, and lays every pushed blade over by its
+// lean. Call after the field has been updated for the frame.
+void applyGrassDisplacement(GrassDisplacement& Displacement, GrassField& Field, const GrassBladeGrid& Grid,
+    std::span<const GrassCollider> Colliders, float DeltaTime, WorkerPool& Pool);
+
+// Blades currently bent or recovering
+std::size_t displacedBladeCount(const GrassDisplacement& Displacement);
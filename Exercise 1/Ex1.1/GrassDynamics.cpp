@@ -0,0 +1,146 @@
+#include "GrassDynamics.h"
+
+#include "GrassWorkerPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <new>
+
+namespace
+{
+    // Longest frame fed to the accumulator, so a stall (window drag, breakpoint) does not explode
+    constexpr float MaxFrameTime = 0.25f;
+}
+
+void resetGrassDynamics(GrassDynamics& Dynamics, const GrassField& Field, const float Time)
+{
+    Dynamics.Stride = Field.Stride;
+    Dynamics.SegmentCount = Field.SegmentCount;
+    Dynamics.Accumulator = 0.0f;
+
+    const std::size_t Rows = static_cast<std::size_t>(Field.SegmentCount);
+    const std::size_t TotalFloats = Field.Stride * (3 * Rows + 5);
+    Dynamics.Storage.reset(static_cast<float*>(::operator new[](TotalFloats * sizeof(float), std::align_val_t{ GrassArrayAlignment })));
+    float* Cursor = Dynamics.Storage.get();
+    std::fill(Cursor, Cursor + TotalFloats, 0.0f);
+
+    Dynamics.Bend = Cursor; Cursor += Field.Stride * Rows;
+    Dynamics.PreviousBend = Cursor; Cursor += Field.Stride * Rows;
+    Dynamics.AngularVelocity = Cursor; Cursor += Field.Stride * Rows;
+    Dynamics.TargetBend = Cursor; Cursor += Field.Stride;
+    Dynamics.OscillatorSin = Cursor; Cursor += Field.Stride;
+    Dynamics.OscillatorCos = Cursor; Cursor += Field.Stride;
+    Dynamics.StepSin = Cursor; Cursor += Field.Stride;
+    Dynamics.StepCos = Cursor;
+
+    const float Step = Dynamics.step();
+    for (std::size_t Blade = 0; Blade < Field.Stride; ++Blade)
+    {
+        const float EffectiveFrequency = WindSwayFrequencyBase * Field.FrequencyVariance[Blade];
+        const float Phase = Time * EffectiveFrequency + Field.PhaseOffset[Blade];
+        Dynamics.OscillatorSin[Blade] = std::sin(Phase);
+        Dynamics.OscillatorCos[Blade] = std::cos(Phase);
+        Dynamics.StepSin[Blade] = std::sin(EffectiveFrequency * Step);
+        Dynamics.StepCos[Blade] = std::cos(EffectiveFrequency * Step);
+    }
+}
+
+void stepGrassDynamicsRange(GrassDynamics& Dynamics, const GrassField& Field, const std::size_t Begin, const std::size_t End)
+{
+    const float Step = Dynamics.step();
+    const float SwayScale = WindSwayAmplitude * DampingFactor / static_cast<float>(Dynamics.SegmentCount);
+    const float Stiffness = Dynamics.Settings.Stiffness;
+    const float Damping = Dynamics.Settings.Damping;
+    const float FlutterWeight = Field.FlutterWeight;
+
+    // Advance each blade's oscillator by its fixed rotation, pulled back to unit length every step. Kept
+    // apart from the target loop below so neither needs more runtime alias checks than GCC will version for.
+    float* OscillatorSin = Dynamics.OscillatorSin;
+    float* OscillatorCos = Dynamics.OscillatorCos;
+    float* TargetBend = Dynamics.TargetBend;
+    const float* StepSin = Dynamics.StepSin;
+    const float* StepCos = Dynamics.StepCos;
+    const float* WindOffset = Field.WindOffset;
+    for (std::size_t Blade = Begin; Blade < End; ++Blade)
+    {
+        const float Sin = OscillatorSin[Blade] * StepCos[Blade] + OscillatorCos[Blade] * StepSin[Blade];
+        const float Cos = OscillatorCos[Blade] * StepCos[Blade] - OscillatorSin[Blade] * StepSin[Blade];
+        const float Correction = 1.5f - 0.5f * (Sin * Sin + Cos * Cos);
+        OscillatorSin[Blade] = Sin * Correction;
+        OscillatorCos[Blade] = Cos * Correction;
+    }
+
+    // Per-segment rest angle, the one the kinematic update would use
+    for (std::size_t Blade = Begin; Blade < End; ++Blade)
+    {
+        TargetBend[Blade] = (WindOffset[Blade] + FlutterWeight * OscillatorSin[Blade]) * SwayScale;
+    }
+
+    // Semi-implicit Euler: velocity first, then the angle from the new velocity
+    for (int Segment = 0; Segment < Dynamics.SegmentCount; ++Segment)
+    {
+        float* Bend = Dynamics.Bend + static_cast<std::size_t>(Segment) * Dynamics.Stride;
+        float* Velocity = Dynamics.AngularVelocity + static_cast<std::size_t>(Segment) * Dynamics.Stride;
+        for (std::size_t Blade = Begin; Blade < End; ++Blade)
+        {
+            const float Acceleration = Stiffness * (TargetBend[Blade] - Bend[Blade]) - Damping * Velocity[Blade];
+            Velocity[Blade] += Acceleration * Step;
+            Bend[Blade] += Velocity[Blade] * Step;
+        }
+    }
+}
+
+void advanceGrassDynamics(GrassDynamics& Dynamics, GrassField& Field, const float DeltaTime, const GrassIsa Isa, WorkerPool& Pool,
+    const GrassWindField* Wind)
+{
+    const float Step = Dynamics.step();
+    Dynamics.Accumulator += std::clamp(DeltaTime, 0.0f, MaxFrameTime);
+    const int Steps = std::min(static_cast<int>(Dynamics.Accumulator / Step), Dynamics.Settings.MaxStepsPerFrame);
+    Dynamics.Accumulator = std::min(Dynamics.Accumulator - static_cast<float>(Steps) * Step, Step * 0.999f);
+    const float Alpha = Dynamics.Accumulator / Step;
+
+    const GrassPoseKernel Pose = grassPoseKernel(Isa);
+    const std::size_t Rows = static_cast<std::size_t>(Dynamics.SegmentCount);
+    Field.FlutterWeight = Wind ? Wind->Settings.FlutterWeight : 1.0f;
+    Pool.parallelFor(Field.BladeCount, GrassLaneWidth, [&](const std::size_t Begin, const std::size_t End)
+    {
+        if (Wind)
+        {
+            sampleWindRange(*Wind, Field, Begin, End);
+        }
+        for (int I = 0; I < Steps; ++I)
+        {
+            // Only the last step of the frame needs its starting pose kept for interpolation
+            if (I == Steps - 1)
+            {
+                for (std::size_t Row = 0; Row < Rows; ++Row)
+                {
+                    const float* Source = Dynamics.Bend + Row * Dynamics.Stride;
+                    std::copy(Source + Begin, Source + End, Dynamics.PreviousBend + Row * Dynamics.Stride + Begin);
+                }
+            }
+            stepGrassDynamicsRange(Dynamics, Field, Begin, End);
+        }
+        Pose(Field, Dynamics.PreviousBend, Dynamics.Bend, Alpha, Begin, End);
+    });
+}
+
+void applyGrassImpulse(GrassDynamics& Dynamics, const GrassField& Field, const sf::Vector2f Point, const float Radius, const float AngularImpulse)
+{
+    for (std::size_t Blade = 0; Blade < Field.BladeCount; ++Blade)
+    {
+        const float OffsetX = Field.BaseX[Blade] - Point.x;
+        const float Distance = std::hypot(OffsetX, Field.BaseY[Blade] - Point.y);
+        if (Distance >= Radius)
+        {
+            continue;
+        }
+
+        // Positive angles lean towards +x, so blades right of the point are pushed right
+        const float Kick = std::copysign(AngularImpulse * (1.0f - Distance / Radius), OffsetX);
+        for (int Segment = 0; Segment < Dynamics.SegmentCount; ++Segment)
+        {
+            Dynamics.AngularVelocity[static_cast<std::size_t>(Segment) * Dynamics.Stride + Blade] += Kick;
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "GrassField.h"
+#include "GrassSimd.h"
+#include "GrassWind.h"
+
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <memory>
+
+class WorkerPool;
+
+struct GrassDynamicsSettings
+{
+    float StepRate = 120.0f;     // Simulation steps per second, independent of the frame rate
+    float Stiffness = 40.0f;     // Angular spring constant per segment, 1/s^2
+    float Damping = 4.0f;        // Angular damping per segment, 1/s
+    int MaxStepsPerFrame = 8;    // Time beyond this many steps in one frame is dropped rather than caught up
+};
+
+// Spring-damper state for every segment of a field. Each segment bends relative to the one below it and is
+// pulled towards the same per-segment angle the kinematic update would give it, so with no impulses the
+// blades settle into the familiar sway with some lag. All state is segment-major like the field's own
+// segment rows, and the integrator runs over whole rows so every loop is a plain vectorizable pass.
+struct GrassDynamics
+{
+    GrassDynamicsSettings Settings;
+    std::size_t Stride = 0;
+    int SegmentCount = 0;
+    float Accumulator = 0.0f; // Simulated time not yet stepped, always below one step
+
+    float* Bend = nullptr;            // SegmentCount rows: angle of segment I relative to segment I - 1
+    float* PreviousBend = nullptr;    // Bend before the most recent step, for render interpolation
+    float* AngularVelocity = nullptr; // SegmentCount rows
+    float* TargetBend = nullptr;      // Spring rest angle of the current step
+    float* OscillatorSin = nullptr;   // Each blade's own sway oscillator, advanced by a fixed rotation per step
+    float* OscillatorCos = nullptr;
+    float* StepSin = nullptr;         // Rotation of the oscillator over one step
+    float* StepCos = nullptr;
+
+    std::unique_ptr<float, AlignedFloatDeleter> Storage;
+
+    float step() const { return 1.0f / Settings.StepRate; }
+};
+
+// Sizes the state for Field and puts every blade at rest, with its oscillator at the phase it has at Time
+void resetGrassDynamics(GrassDynamics& Dynamics, const GrassField& Field, float Time);
+
+// Integrates blades [Begin, End) over one fixed step with semi-implicit Euler
+void stepGrassDynamicsRange(GrassDynamics& Dynamics, const GrassField& Field, std::size_t Begin, std::size_t End);
+
+// Adds DeltaTime to the accumulator, runs as many whole steps as it holds and poses the field between the
+// last two steps. Each pool chunk samples the wind, runs every step and poses its own blades in one pass.
+void advanceGrassDynamics(GrassDynamics& Dynamics, GrassField& Field, float DeltaTime, GrassIsa Isa, WorkerPool& Pool,
+    const GrassWindField* Wind = nullptr);
+
+// Kicks every blade whose base is within Radius of Point away from it, with an angular velocity that
+// falls off linearly from AngularImpulse (rad/s) at the point to 0 at Radius
+void applyGrassImpulse(GrassDynamics& Dynamics, const GrassField& Field, sf::Vector2f Point, float Radius, float AngularImpulse);
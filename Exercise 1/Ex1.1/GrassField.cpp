@@ -0,0 +1,194 @@
+#include "GrassField.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <new>
+#include <random>
+
+void AlignedFloatDeleter::operator()(float* Memory) const
+{
+    ::operator delete[](Memory, std::align_val_t{ GrassArrayAlignment });
+}
+
+void GrassField::allocate(const std::size_t NumBlades, const int NumSegments)
+{
+    BladeCount = NumBlades;
+    SegmentCount = NumSegments;
+    Stride = (NumBlades + GrassLaneWidth - 1) / GrassLaneWidth * GrassLaneWidth;
+
+    const std::size_t TotalFloats = storageFloats();
+    Mapping.reset();
+    Storage.reset(static_cast<float*>(::operator new[](TotalFloats * sizeof(float), std::align_val_t{ GrassArrayAlignment })));
+
+    // Zero everything so the padding lanes hold harmless values for the vector kernels
+    std::fill(Storage.get(), Storage.get() + TotalFloats, 0.0f);
+    bindAttributes(Storage.get());
+    bindSegments(Storage.get() + attributeFloats());
+}
+
+void GrassField::shareAttributes(GrassField& Other)
+{
+    BladeCount = Other.BladeCount;
+    SegmentCount = Other.SegmentCount;
+    Stride = Other.Stride;
+    FlutterWeight = Other.FlutterWeight;
+
+    Mapping = Other.Mapping;
+    Storage.reset(static_cast<float*>(::operator new[](segmentFloats() * sizeof(float), std::align_val_t{ GrassArrayAlignment })));
+    bindAttributes(Other.BaseX);
+    bindSegments(Storage.get());
+    std::copy(Other.SegmentX, Other.SegmentX + segmentFloats(), SegmentX);
+}
+
+void GrassField::bindAttributes(float* Attributes)
+{
+    BaseX = Attributes;
+    BaseY = BaseX + Stride;
+    LengthVariance = BaseY + Stride;
+    PhaseOffset = LengthVariance + Stride;
+    FrequencyVariance = PhaseOffset + Stride;
+    WindOffset = FrequencyVariance + Stride;
+}
+
+void GrassField::bindSegments(float* Segments)
+{
+    SegmentX = Segments;
+    SegmentY = SegmentX + Stride * (static_cast<std::size_t>(SegmentCount) + 1);
+}
+
+void GrassField::copyFrom(const GrassField& Other)
+{
+    allocate(Other.BladeCount, Other.SegmentCount);
+    FlutterWeight = Other.FlutterWeight;
+    std::copy(Other.BaseX, Other.BaseX + attributeFloats(), BaseX);
+    std::copy(Other.SegmentX, Other.SegmentX + segmentFloats(), SegmentX);
+}
+
+void initializeGrass(GrassField& Field, const std::size_t NumBlades, const float FieldWidth, const float GroundY, const int NumSegments)
+{
+    // Seed the random number generator with the current time for more randomness
+    const auto Seed = static_cast<unsigned>(std::chrono::system_clock::now().time_since_epoch().count());
+    generateGrass(Field, NumBlades, 0.0f, FieldWidth, GroundY, NumSegments, Seed);
+}
+
+void generateGrass(GrassField& Field, const std::size_t NumBlades, const float OriginX, const float FieldWidth, const float GroundY,
+    const int NumSegments, const unsigned Seed)
+{
+    Field.allocate(NumBlades, NumSegments);
+
+    std::default_random_engine Generator(Seed);
+    std::uniform_real_distribution LengthDist(1.0f, 1.3f);
+    std::uniform_real_distribution PhaseDist(0.0f, 3.14f);
+    std::uniform_real_distribution XPosDist(OriginX, OriginX + FieldWidth);
+    std::uniform_real_distribution FrequencyDist(0.8f, 1.2f);  // Variance for swaying frequency
+
+    for (std::size_t Blade = 0; Blade < NumBlades; ++Blade)
+    {
+        Field.LengthVariance[Blade] = LengthDist(Generator);
+        Field.PhaseOffset[Blade] = PhaseDist(Generator);
+        Field.FrequencyVariance[Blade] = FrequencyDist(Generator);
+
+        // Initialize the position of the grass blades along the entire width of the field
+        Field.BaseX[Blade] = XPosDist(Generator);
+        Field.BaseY[Blade] = GroundY; // Grass blade base at the bottom of the field
+    }
+
+    // Row 0 of the segment arrays is the fixed base of every blade
+    std::copy(Field.BaseX, Field.BaseX + Field.Stride, Field.segmentRowX(0));
+    std::copy(Field.BaseY, Field.BaseY + Field.Stride, Field.segmentRowY(0));
+}
+
+void updateGrass(GrassField& Field, const float Time)
+{
+    updateGrassRange(Field, Time, 0, Field.BladeCount);
+}
+
+void updateGrassRange(GrassField& Field, const float Time, const std::size_t Begin, const std::size_t End)
+{
+    const int Segments = Field.SegmentCount;
+
+    for (std::size_t Blade = Begin; Blade < End; ++Blade)
+    {
+        // Adjust the frequency based on a variance to make blades move uniquely
+        const float EffectiveFrequency = WindSwayFrequencyBase * Field.FrequencyVariance[Blade];
+        const float Oscillation = std::sin(Time * EffectiveFrequency + Field.PhaseOffset[Blade]);
+        const float Sway = (Field.WindOffset[Blade] + Field.FlutterWeight * Oscillation) * WindSwayAmplitude * DampingFactor;
+        const float SegmentLength = BaseGrassLength * Field.LengthVariance[Blade] / static_cast<float>(Segments);
+
+        float X = Field.BaseX[Blade];
+        float Y = Field.BaseY[Blade];
+        for (int I = 1; I <= Segments; ++I)
+        {
+            const float Angle = Sway * (static_cast<float>(I) / static_cast<float>(Segments));
+            X += std::sin(Angle) * SegmentLength;
+            Y -= std::cos(Angle) * SegmentLength;
+            Field.segmentRowX(I)[Blade] = X;
+            Field.segmentRowY(I)[Blade] = Y;
+        }
+    }
+}
+
+void updateGrassIncrementalRange(GrassField& Field, const float Time, const std::size_t Begin, const std::size_t End)
+{
+    const int Segments = Field.SegmentCount;
+
+    for (std::size_t Blade = Begin; Blade < End; ++Blade)
+    {
+        const float EffectiveFrequency = WindSwayFrequencyBase * Field.FrequencyVariance[Blade];
+        const float Oscillation = std::sin(Time * EffectiveFrequency + Field.PhaseOffset[Blade]);
+        const float Sway = (Field.WindOffset[Blade] + Field.FlutterWeight * Oscillation) * WindSwayAmplitude * DampingFactor;
+        const float SegmentLength = BaseGrassLength * Field.LengthVariance[Blade] / static_cast<float>(Segments);
+
+        // Rotation by the angle between consecutive segments, applied once before every segment
+        const float Step = Sway / static_cast<float>(Segments);
+        const float StepSin = std::sin(Step);
+        const float StepCos = std::cos(Step);
+
+        float DirectionSin = 0.0f;
+        float DirectionCos = 1.0f;
+        float X = Field.BaseX[Blade];
+        float Y = Field.BaseY[Blade];
+        for (int I = 1; I <= Segments; ++I)
+        {
+            const float RotatedSin = DirectionSin * StepCos + DirectionCos * StepSin;
+            DirectionCos = DirectionCos * StepCos - DirectionSin * StepSin;
+            DirectionSin = RotatedSin;
+            if (I % GrassRenormalizeInterval == 0)
+            {
+                const float Correction = 1.5f - 0.5f * (DirectionSin * DirectionSin + DirectionCos * DirectionCos);
+                DirectionSin *= Correction;
+                DirectionCos *= Correction;
+            }
+
+            X += DirectionSin * SegmentLength;
+            Y -= DirectionCos * SegmentLength;
+            Field.segmentRowX(I)[Blade] = X;
+            Field.segmentRowY(I)[Blade] = Y;
+        }
+    }
+}
+
+void poseGrassRange(GrassField& Field, const float* PreviousBend, const float* Bend, const float Alpha, const std::size_t Begin,
+    const std::size_t End)
+{
+    const int Segments = Field.SegmentCount;
+
+    for (std::size_t Blade = Begin; Blade < End; ++Blade)
+    {
+        const float SegmentLength = BaseGrassLength / static_cast<float>(Segments) * Field.LengthVariance[Blade];
+
+        float Angle = 0.0f;
+        float X = Field.BaseX[Blade];
+        float Y = Field.BaseY[Blade];
+        for (int I = 1; I <= Segments; ++I)
+        {
+            const std::size_t Row = static_cast<std::size_t>(I - 1) * Field.Stride + Blade;
+            Angle += Alpha * Bend[Row] + (PreviousBend[Row] - Alpha * PreviousBend[Row]);
+            X += std::sin(Angle) * SegmentLength;
+            Y -= std::cos(Angle) * SegmentLength;
+            Field.segmentRowX(I)[Blade] = X;
+            Field.segmentRowY(I)[Blade] = Y;
+        }
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <memory>
+
+constexpr int GrassSegments = 5;
+// Most segments per blade --segments accepts, and a snapshot may ask for
+constexpr int MaxGrassSegments = 256;
+constexpr float BaseGrassLength = 150.0f;
+constexpr float WindSwayFrequencyBase = 0.2f;
+constexpr float WindSwayAmplitude = 20.0f;
+constexpr float DampingFactor = 0.7f;
+
+// The incremental segment builder renormalises its rotated direction every this many segments
+constexpr int GrassRenormalizeInterval = 8;
+
+// Blade arrays are padded to a multiple of this many floats and aligned to a cache line,
+// so vector kernels can always process full lanes without a scalar tail.
+constexpr std::size_t GrassLaneWidth = 16;
+constexpr std::size_t GrassArrayAlignment = 64;
+
+struct AlignedFloatDeleter
+{
+    void operator()(float* Memory) const;
+};
+
+// Per-blade attribute arrays in a field, BaseX through WindOffset
+constexpr std::size_t GrassAttributeArrays = 6;
+
+// Structure-of-arrays storage for a whole field of grass blades.
+// Every per-blade attribute lives in its own contiguous array, and segment positions are stored
+// segment-major: SegmentX[Segment * Stride + Blade]. The attribute arrays are one contiguous block of
+// GrassAttributeArrays * Stride floats starting at BaseX, and the segment rows another starting at SegmentX.
+// Both normally share a single allocation; a field loaded from a snapshot points into the mapped file.
+struct GrassField
+{
+    std::size_t BladeCount = 0;
+    std::size_t Stride = 0; // BladeCount rounded up to GrassLaneWidth
+    int SegmentCount = 0;
+
+    float* BaseX = nullptr;
+    float* BaseY = nullptr;
+    float* LengthVariance = nullptr;
+    float* PhaseOffset = nullptr;
+    float* FrequencyVariance = nullptr;
+    float* WindOffset = nullptr; // Sway added on top of the blade's own oscillation, written by the wind field
+    float* SegmentX = nullptr; // (SegmentCount + 1) rows of Stride floats, row 0 is the base
+    float* SegmentY = nullptr;
+
+    // Weight of each blade's own sin oscillation in its sway. 1 with no wind field; lowered when a wind
+    // field supplies most of the motion through WindOffset.
+    float FlutterWeight = 1.0f;
+
+    std::unique_ptr<float, AlignedFloatDeleter> Storage;
+    std::shared_ptr<const void> Mapping; // Keeps a mapped snapshot alive while the arrays point into it
+
+    void allocate(std::size_t NumBlades, int NumSegments = GrassSegments);
+    void copyFrom(const GrassField& Other);
+
+    // Makes this a second pose of Other: its own copy of the segment rows over Other's attributes, which
+    // must outlive it. One pose can then be drawn while the next is simulated into the other.
+    void shareAttributes(GrassField& Other);
+
+    // Points the arrays at externally owned blocks laid out as described above
+    void bindAttributes(float* Attributes);
+    void bindSegments(float* Segments);
+
+    std::size_t attributeFloats() const { return Stride * GrassAttributeArrays; }
+    std::size_t segmentFloats() const { return Stride * 2 * (static_cast<std::size_t>(SegmentCount) + 1); }
+    std::size_t storageFloats() const { return attributeFloats() + segmentFloats(); }
+
+    float* segmentRowX(const int Segment) { return SegmentX + static_cast<std::size_t>(Segment) * Stride; }
+    float* segmentRowY(const int Segment) { return SegmentY + static_cast<std::size_t>(Segment) * Stride; }
+    const float* segmentRowX(const int Segment) const { return SegmentX + static_cast<std::size_t>(Segment) * Stride; }
+    const float* segmentRowY(const int Segment) const { return SegmentY + static_cast<std::size_t>(Segment) * Stride; }
+
+    sf::Vector2f segment(const std::size_t Blade, const int Segment) const
+    {
+        return { segmentRowX(Segment)[Blade], segmentRowY(Segment)[Blade] };
+    }
+};
+
+void initializeGrass(GrassField& Field, std::size_t NumBlades, float FieldWidth, float GroundY, int NumSegments = GrassSegments);
+
+// Deterministic version of initializeGrass: the same seed always produces the same field, with blade
+// bases spread over [OriginX, OriginX + FieldWidth)
+void generateGrass(GrassField& Field, std::size_t NumBlades, float OriginX, float FieldWidth, float GroundY, int NumSegments, unsigned Seed);
+void updateGrass(GrassField& Field, float Time);
+
+// Scalar update of blades [Begin, End). Reference implementation for the vector kernels.
+void updateGrassRange(GrassField& Field, float Time, std::size_t Begin, std::size_t End);
+
+// Scalar update of blades [Begin, End) using the incremental segment builder. Segment angles form the
+// progression Sway * I / SegmentCount, so instead of a sin/cos pair per segment the direction is
+// advanced by a fixed 2D rotation computed once per blade. Each step adds up to one rounding error to
+// the direction's length, so every GrassRenormalizeInterval segments it is pulled back to unit length
+// with a Newton step (no sqrt). The remaining drift is in angle only and grows linearly with segment
+// count; at 64 segments the tip stays within 1e-3 px of the exact build.
+void updateGrassIncrementalRange(GrassField& Field, float Time, std::size_t Begin, std::size_t End);
+
+// Scalar pose of blades [Begin, End) from per-segment bend angles, the reference for the vector pose
+// kernels. PreviousBend and Bend hold SegmentCount rows of Stride floats, row I - 1 being the angle of
+// segment I relative to segment I - 1. Each angle is blended as PreviousBend + Alpha * (Bend - PreviousBend)
+// before being accumulated along the blade.
+void poseGrassRange(GrassField& Field, const float* PreviousBend, const float* Bend, float Alpha, std::size_t Begin, std::size_t End);
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "GrassField.h"
+
+#include <algorithm>
+#include <cstddef>
+
+// Detail levels for drawing grass, from every segment down to a single triangle per blade
+enum GrassLodLevel
+{
+    GrassLodFull,     // Every simulated segment
+    GrassLodHalf,     // Every other segment
+    GrassLodTwo,      // Two segments
+    GrassLodTriangle, // One tapered triangle from base to tip
+    GrassLodLevelCount
+};
+
+struct GrassLodSettings
+{
+    bool Enabled = true;
+    // Smallest projected blade length in pixels at which each of the first three levels is still used.
+    // The longest blades are about 195 px at 1x zoom, so across the world camera's zoom range of 0.25x to 8x
+    // every level is reached, even allowing for the hysteresis.
+    float MinPixels[GrassLodTriangle] = { 100.0f, 55.0f, 35.0f };
+    // A level only changes once the projected length moves this fraction past its threshold, so a
+    // chunk sitting right on a threshold does not pop back and forth
+    float Hysteresis = 0.15f;
+};
+
+// Blades drawn at each level in the last frame
+struct GrassLodStats
+{
+    std::size_t Blades[GrassLodLevelCount] = {};
+
+    void reset()
+    {
+        for (std::size_t& Count : Blades)
+        {
+            Count = 0;
+        }
+    }
+};
+
+// Length in world units of the longest blade in Field, which its level is chosen from so no blade is drawn
+// coarser than its own length warrants
+inline float grassLodBladeLength(const GrassField& Field)
+{
+    const float* Lengths = Field.LengthVariance;
+    return Field.BladeCount > 0 ? BaseGrassLength * *std::max_element(Lengths, Lengths + Field.BladeCount) : 0.0f;
+}
+
+// One field to draw, with the level it was drawn at last frame. LodLevel may be null, in which case the
+// level is picked without hysteresis.
+struct GrassDrawItem
+{
+    const GrassField* Field = nullptr;
+    int* LodLevel = nullptr;
+    float BladeLength = 0.0f; // grassLodBladeLength of the field, measured when building if left at 0
+};
+
+// Picks the level for a blade (or chunk of blades) of the given on-screen length, given its current level
+inline int selectGrassLod(const int CurrentLevel, const float ProjectedPixels, const GrassLodSettings& Settings)
+{
+    if (!Settings.Enabled)
+    {
+        return GrassLodFull;
+    }
+
+    int Level = GrassLodTriangle;
+    for (int Candidate = GrassLodFull; Candidate < GrassLodTriangle; ++Candidate)
+    {
+        // Hold on to finer levels a bit longer and require a margin before becoming finer
+        const float Scale = Candidate >= CurrentLevel ? 1.0f - Settings.Hysteresis : 1.0f + Settings.Hysteresis;
+        if (ProjectedPixels >= Settings.MinPixels[Candidate] * Scale)
+        {
+            Level = Candidate;
+            break;
+        }
+    }
+    return Level;
+}
+
+// Segments drawn per blade at a level, for blades simulated with SegmentCount segments
+inline int grassLodSegmentCount(const int Level, const int SegmentCount)
+{
+    switch (Level)
+    {
+    case GrassLodFull:
+        return SegmentCount;
+    case GrassLodHalf:
+        return SegmentCount > 2 ? (SegmentCount + 1) / 2 : SegmentCount;
+    case GrassLodTwo:
+        return SegmentCount > 2 ? 2 : SegmentCount;
+    default:
+        return 1;
+    }
+}
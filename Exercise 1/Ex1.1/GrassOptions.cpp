@@ -0,0 +1,104 @@
+#include "GrassOptions.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+GrassOptions parseGrassOptions(const int Argc, char* Argv[])
+{
+    GrassOptions Options;
+    for (int I = 1; I < Argc; ++I)
+    {
+        const bool HasValue = I + 1 < Argc;
+        if (std::strcmp(Argv[I], "--scalar") == 0)
+        {
+            Options.Isa = GrassIsa::Scalar;
+        }
+        else if (std::strcmp(Argv[I], "--verify") == 0)
+        {
+            Options.Verify = true;
+        }
+        else if (std::strcmp(Argv[I], "--scaling") == 0)
+        {
+            Options.Scaling = true;
+        }
+        else if (std::strcmp(Argv[I], "--threads") == 0 && HasValue)
+        {
+            Options.Threads = static_cast<unsigned>(std::strtoul(Argv[++I], nullptr, 10));
+        }
+        else if (std::strcmp(Argv[I], "--blades") == 0 && HasValue)
+        {
+            Options.NumBlades = std::strtoull(Argv[++I], nullptr, 10);
+        }
+        else if (std::strcmp(Argv[I], "--segments") == 0 && HasValue)
+        {
+            Options.Segments = std::clamp(std::atoi(Argv[++I]), 1, MaxGrassSegments);
+        }
+        else if (std::strcmp(Argv[I], "--incremental") == 0)
+        {
+            Options.Builder = GrassSegmentBuilder::Incremental;
+        }
+        else if (std::strcmp(Argv[I], "--no-lod") == 0)
+        {
+            Options.Lod = false;
+        }
+        else if (std::strcmp(Argv[I], "--dirty-epsilon") == 0 && HasValue)
+        {
+            Options.DirtyEpsilon = std::max(0.0f, static_cast<float>(std::atof(Argv[++I])));
+        }
+        else if (std::strcmp(Argv[I], "--no-dirty-tracking") == 0)
+        {
+            Options.DirtyTracking = false;
+        }
+        else if (std::strcmp(Argv[I], "--no-wind") == 0)
+        {
+            Options.Wind = false;
+        }
+        else if (std::strcmp(Argv[I], "--pose-cache") == 0 && HasValue)
+        {
+            Options.PoseCacheSize = std::max(2, std::atoi(Argv[++I]));
+        }
+        else if (std::strcmp(Argv[I], "--pose-cache-nearest") == 0)
+        {
+            Options.PoseCacheLerp = false;
+        }
+        else if (std::strcmp(Argv[I], "--time-slice") == 0 && HasValue)
+        {
+            Options.TimeSlices = std::max(1, std::atoi(Argv[++I]));
+        }
+        else if (std::strcmp(Argv[I], "--dynamics") == 0)
+        {
+            Options.Dynamics = true;
+        }
+        else if (std::strcmp(Argv[I], "--pipelined") == 0)
+        {
+            Options.Pipelined = true;
+        }
+        else if (std::strcmp(Argv[I], "--no-displacement") == 0)
+        {
+            Options.Displacement = false;
+        }
+        else if (std::strcmp(Argv[I], "--colliders") == 0 && HasValue)
+        {
+            Options.Colliders = std::max(0, std::atoi(Argv[++I]));
+        }
+        else if (std::strcmp(Argv[I], "--seed") == 0 && HasValue)
+        {
+            Options.Seed = static_cast<unsigned>(std::strtoul(Argv[++I], nullptr, 10));
+        }
+        else if (std::strcmp(Argv[I], "--load-field") == 0 && HasValue)
+        {
+            Options.LoadPath = Argv[++I];
+        }
+        else if (std::strcmp(Argv[I], "--save-field") == 0 && HasValue)
+        {
+            Options.SavePath = Argv[++I];
+        }
+        else if (std::strcmp(Argv[I], "--world") == 0)
+        {
+            // Optional width in screens, 1000 by default
+            Options.WorldScreens = HasValue && Argv[I + 1][0] != '-' ? std::max(1LL, std::atoll(Argv[++I])) : 1000;
+        }
+    }
+    return Options;
+}
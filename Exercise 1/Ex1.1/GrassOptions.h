@@ -0,0 +1,40 @@
+#pragma once
+
+#include "GrassField.h"
+#include "GrassSimd.h"
+
+#include <cstddef>
+#include <optional>
+#include <string>
+
+constexpr int NumGrassBlades = 500;
+
+// Command line settings for the grass simulation, see the Readme for the full list
+struct GrassOptions
+{
+    GrassIsa Isa = detectGrassIsa();
+    GrassSegmentBuilder Builder = GrassSegmentBuilder::Direct;
+    unsigned Threads = 0; // One per hardware thread
+    std::size_t NumBlades = NumGrassBlades;
+    int Segments = GrassSegments;
+    bool Verify = false;
+    bool Scaling = false;
+    bool Lod = true;
+    bool DirtyTracking = true; // Only rewrite the vertices of blades that moved visibly since the last frame
+    float DirtyEpsilon = 0.1f; // Screen pixels a blade must move by to count as moved
+    bool Wind = true;
+    int PoseCacheSize = 0;   // Poses in the blade pose cache, 0 builds every blade with trig as usual
+    bool PoseCacheLerp = true;
+    int TimeSlices = 1;    // Solve only one of this many slices of blades per frame and extrapolate the rest
+    bool Dynamics = false; // Spring-damper blades on a fixed timestep instead of the kinematic sway
+    bool Displacement = true; // The cursor pushes blades aside
+    int Colliders = 0;        // Moving circular colliders pushing blades aside as well as the cursor
+    bool Pipelined = false;   // Simulate the next frame on the pool while the current one is drawn
+    std::optional<unsigned> Seed; // Wall clock seed when unset
+    std::string LoadPath;         // Snapshot to map instead of generating the field
+    std::string SavePath;         // Snapshot to write after generating the field
+
+    long long WorldScreens = 0; // 0 simulates a single screen, otherwise a chunked world this many screens wide
+};
+
+GrassOptions parseGrassOptions(int Argc, char* Argv[]);
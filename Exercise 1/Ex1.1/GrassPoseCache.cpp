@@ -0,0 +1,110 @@
+#include "GrassPoseCache.h"
+
+#include "GrassWorkerPool.h"
+
+#include <algorithm>
+#include <cmath>
+
+void buildGrassPoseCache(GrassPoseCache& Cache, const int SegmentCount, const int PoseCount, const bool Interpolate, const float MaxSway)
+{
+    Cache.SegmentCount = SegmentCount;
+    Cache.PoseCount = std::max(2, PoseCount);
+    Cache.MaxSway = MaxSway;
+    Cache.InvSpacing = static_cast<float>(Cache.PoseCount - 1) / (2.0f * MaxSway);
+    Cache.Interpolate = Interpolate;
+
+    const std::size_t Size = static_cast<std::size_t>(Cache.PoseCount) * static_cast<std::size_t>(SegmentCount);
+    Cache.OffsetX.resize(Size);
+    Cache.OffsetY.resize(Size);
+
+    // Built the same way as updateGrassRange, in double so the table adds no rounding of its own
+    const double SegmentLength = 1.0 / static_cast<double>(SegmentCount);
+    for (int Pose = 0; Pose < Cache.PoseCount; ++Pose)
+    {
+        const double Sway = -static_cast<double>(MaxSway) + static_cast<double>(Pose) / Cache.InvSpacing;
+        double X = 0.0;
+        double Y = 0.0;
+        for (int I = 1; I <= SegmentCount; ++I)
+        {
+            const double Angle = Sway * static_cast<double>(I) / static_cast<double>(SegmentCount);
+            X += std::sin(Angle) * SegmentLength;
+            Y -= std::cos(Angle) * SegmentLength;
+            const std::size_t Index = static_cast<std::size_t>(Pose) * SegmentCount + (I - 1);
+            Cache.OffsetX[Index] = static_cast<float>(X);
+            Cache.OffsetY[Index] = static_cast<float>(Y);
+        }
+    }
+}
+
+void updateGrassCachedRange(GrassField& Field, const float Time, const GrassPoseCache& Cache, const std::size_t Begin, const std::size_t End)
+{
+    const int Segments = Field.SegmentCount;
+    const float LastPose = static_cast<float>(Cache.PoseCount - 1);
+
+    for (std::size_t Blade = Begin; Blade < End; ++Blade)
+    {
+        const float EffectiveFrequency = WindSwayFrequencyBase * Field.FrequencyVariance[Blade];
+        const float Oscillation = std::sin(Time * EffectiveFrequency + Field.PhaseOffset[Blade]);
+        const float Sway = (Field.WindOffset[Blade] + Field.FlutterWeight * Oscillation) * WindSwayAmplitude * DampingFactor;
+        const float Length = BaseGrassLength * Field.LengthVariance[Blade];
+
+        // Position of the sway between poses; the last pose is only reached by snapping or with a zero blend
+        const float Position = std::clamp((Sway + Cache.MaxSway) * Cache.InvSpacing, 0.0f, LastPose);
+        const int Pose = Cache.Interpolate ? std::min(static_cast<int>(Position), Cache.PoseCount - 2) : static_cast<int>(Position + 0.5f);
+        const float Blend = Cache.Interpolate ? Position - static_cast<float>(Pose) : 0.0f;
+        const float* FromX = Cache.OffsetX.data() + static_cast<std::size_t>(Pose) * Segments;
+        const float* FromY = Cache.OffsetY.data() + static_cast<std::size_t>(Pose) * Segments;
+
+        const float BaseX = Field.BaseX[Blade];
+        const float BaseY = Field.BaseY[Blade];
+        for (int I = 1; I <= Segments; ++I)
+        {
+            float OffsetX = FromX[I - 1];
+            float OffsetY = FromY[I - 1];
+            if (Cache.Interpolate)
+            {
+                OffsetX += (FromX[Segments + I - 1] - OffsetX) * Blend;
+                OffsetY += (FromY[Segments + I - 1] - OffsetY) * Blend;
+            }
+            Field.segmentRowX(I)[Blade] = BaseX + OffsetX * Length;
+            Field.segmentRowY(I)[Blade] = BaseY + OffsetY * Length;
+        }
+    }
+}
+
+void updateGrassCached(GrassField& Field, const float Time, const GrassPoseCache& Cache, WorkerPool& Pool, const GrassWindField* Wind)
+{
+    Field.FlutterWeight = Wind ? Wind->Settings.FlutterWeight : 1.0f;
+    Pool.parallelFor(Field.BladeCount, GrassLaneWidth, [&](const std::size_t Begin, const std::size_t End)
+    {
+        if (Wind)
+        {
+            sampleWindRange(*Wind, Field, Begin, End);
+        }
+        updateGrassCachedRange(Field, Time, Cache, Begin, End);
+    });
+}
+
+float grassPoseCacheMaxError(const GrassField& Field, const GrassPoseCache& Cache)
+{
+    GrassField Reference;
+    GrassField Candidate;
+    Reference.copyFrom(Field);
+    Candidate.copyFrom(Field);
+
+    float MaxError = 0.0f;
+    for (float Time = 0.0f; Time < 3600.0f; Time += 97.3f)
+    {
+        updateGrassRange(Reference, Time, 0, Reference.BladeCount);
+        updateGrassCachedRange(Candidate, Time, Cache, 0, Candidate.BladeCount);
+        for (int Segment = 1; Segment <= Field.SegmentCount; ++Segment)
+        {
+            for (std::size_t Blade = 0; Blade < Field.BladeCount; ++Blade)
+            {
+                const sf::Vector2f Difference = Reference.segment(Blade, Segment) - Candidate.segment(Blade, Segment);
+                MaxError = std::max(MaxError, std::hypot(Difference.x, Difference.y));
+            }
+        }
+    }
+    return MaxError;
+}
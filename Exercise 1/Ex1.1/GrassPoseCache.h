@@ -0,0 +1,45 @@
+#pragma once
+
+#include "GrassField.h"
+#include "GrassWind.h"
+
+#include <cstddef>
+#include <vector>
+
+class WorkerPool;
+
+// Blades only differ in length and sway, so every blade shape is a scaled copy of one member of a 1D
+// family parameterized by sway. The cache holds PoseCount unit-length poses evenly spread over
+// [-MaxSway, MaxSway]; a blade is built by looking up its pose (optionally blending the two nearest),
+// scaling it by the blade length and offsetting it to the base, with no trig per segment.
+struct GrassPoseCache
+{
+    int SegmentCount = 0;
+    int PoseCount = 0;
+    float MaxSway = 0.0f;
+    float InvSpacing = 0.0f; // Poses per radian of sway
+    bool Interpolate = true; // Blend the two nearest poses instead of snapping to the nearest one
+
+    // PoseCount rows of SegmentCount offsets from the base, for a blade of total length 1. Pose P, segment
+    // I (1-based) is at [P * SegmentCount + I - 1].
+    std::vector<float> OffsetX;
+    std::vector<float> OffsetY;
+};
+
+// Sway covered by the default cache: the kinematic sway plus the strongest wind field offset
+constexpr float GrassPoseCacheMaxSway = 2.0f * WindSwayAmplitude * DampingFactor;
+
+void buildGrassPoseCache(GrassPoseCache& Cache, int SegmentCount, int PoseCount, bool Interpolate = true,
+    float MaxSway = GrassPoseCacheMaxSway);
+
+// Same motion as updateGrassRange, with the blade shape taken from the cache, which must have been built
+// for Field.SegmentCount. Sways outside the cached range are clamped to it.
+void updateGrassCachedRange(GrassField& Field, float Time, const GrassPoseCache& Cache, std::size_t Begin, std::size_t End);
+
+// Whole-field update split across the pool, sampling the wind first like the kernel path
+void updateGrassCached(GrassField& Field, float Time, const GrassPoseCache& Cache, WorkerPool& Pool,
+    const GrassWindField* Wind = nullptr);
+
+// Largest distance between any segment position built from the cache and by the exact scalar update,
+// over the same sweep of simulation times as grassKernelMaxError
+float grassPoseCacheMaxError(const GrassField& Field, const GrassPoseCache& Cache);
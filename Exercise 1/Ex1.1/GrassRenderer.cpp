@@ -0,0 +1,379 @@
+#include "GrassRenderer.h"
+
+#include "VectorMath.h"
+
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    constexpr std::size_t VerticesPerSegment = 6;
+    constexpr std::size_t VerticesPerTriangle = 3;
+
+    // Blades whose segment directions are normalized together, sized to stay in L1
+    constexpr std::size_t NormalizeBatchBlades = 256;
+
+    std::size_t vertexCount(const GrassField& Field, const int Level)
+    {
+        if (Level == GrassLodTriangle)
+        {
+            return Field.BladeCount * VerticesPerTriangle;
+        }
+        return Field.BladeCount * static_cast<std::size_t>(grassLodSegmentCount(Level, Field.SegmentCount)) * VerticesPerSegment;
+    }
+
+    // Segment ends a level draws: the tip alone for the triangle, otherwise the end of every drawn segment.
+    // End K (from 1) is segment row K * SegmentCount / drawnEnds.
+    int drawnEnds(const GrassField& Field, const int Level)
+    {
+        return Level == GrassLodTriangle ? 1 : grassLodSegmentCount(Level, Field.SegmentCount);
+    }
+
+    // Offset from a segment's start to its thick edge: the left-hand normal scaled to Thickness
+    sf::Vector2f thicknessOffset(const float DirectionX, const float DirectionY, const float Thickness)
+    {
+        const sf::Vector2f Unit = fastNormalize(sf::Vector2f(DirectionX, DirectionY));
+        return sf::Vector2f(-Unit.y * Thickness, Unit.x * Thickness);
+    }
+
+    // Writes the vertices of every drawn segment of Field into Out, which holds vertexCount(Field, Level)
+    // vertices, or only those of the blades set in Dirty when it is given. Coarser levels connect a subset
+    // of the simulated segment rows.
+    void writeGrassVertices(sf::Vertex* Out, const GrassField& Field, const int Level, const std::uint8_t* Dirty)
+    {
+        if (Level == GrassLodTriangle)
+        {
+            const float Thickness = grassSegmentThickness(0, Field.SegmentCount);
+            const float* TipX = Field.segmentRowX(Field.SegmentCount);
+            const float* TipY = Field.segmentRowY(Field.SegmentCount);
+            for (std::size_t Blade = 0; Blade < Field.BladeCount; ++Blade)
+            {
+                if (Dirty != nullptr && !Dirty[Blade])
+                {
+                    continue;
+                }
+                const sf::Vector2f Base(Field.BaseX[Blade], Field.BaseY[Blade]);
+                const sf::Vector2f Tip(TipX[Blade], TipY[Blade]);
+                sf::Vertex* Triangle = Out + Blade * VerticesPerTriangle;
+                Triangle[0].position = Base;
+                Triangle[1].position = Tip;
+                Triangle[2].position = Base + thicknessOffset(Tip.x - Base.x, Tip.y - Base.y, Thickness);
+            }
+            return;
+        }
+
+        // Walk the segment-major arrays row by row so reads and writes both stay sequential. Every blade is
+        // the same colour, so drawing all base segments before the next row looks identical to blade order.
+        const int Drawn = grassLodSegmentCount(Level, Field.SegmentCount);
+        for (int J = 0; J < Drawn; ++J)
+        {
+            const int Row = J * Field.SegmentCount / Drawn;
+            const int NextRow = (J + 1) * Field.SegmentCount / Drawn;
+            const float Thickness = grassSegmentThickness(Row, Field.SegmentCount);
+            const float* StartX = Field.segmentRowX(Row);
+            const float* StartY = Field.segmentRowY(Row);
+            const float* EndX = Field.segmentRowX(NextRow);
+            const float* EndY = Field.segmentRowY(NextRow);
+            sf::Vertex* RowOut = Out + static_cast<std::size_t>(J) * Field.BladeCount * VerticesPerSegment;
+
+            // The segment directions of a batch of blades are normalized in one vector call before any
+            // vertex is written
+            float UnitX[NormalizeBatchBlades];
+            float UnitY[NormalizeBatchBlades];
+            float Lengths[NormalizeBatchBlades];
+            for (std::size_t First = 0; First < Field.BladeCount; First += NormalizeBatchBlades)
+            {
+                const std::size_t Count = std::min(NormalizeBatchBlades, Field.BladeCount - First);
+                for (std::size_t I = 0; I < Count; ++I)
+                {
+                    UnitX[I] = EndX[First + I] - StartX[First + I];
+                    UnitY[I] = EndY[First + I] - StartY[First + I];
+                }
+                fastNormalizeBatch(UnitX, UnitY, UnitX, UnitY, Lengths, Count);
+
+                for (std::size_t I = 0; I < Count; ++I)
+                {
+                    const std::size_t Blade = First + I;
+                    if (Dirty != nullptr && !Dirty[Blade])
+                    {
+                        continue;
+                    }
+                    // Same footprint as a rotated sf::RectangleShape anchored at the segment start
+                    const sf::Vector2f A(StartX[Blade], StartY[Blade]);
+                    const sf::Vector2f B(EndX[Blade], EndY[Blade]);
+                    const sf::Vector2f Offset(-UnitY[I] * Thickness, UnitX[I] * Thickness);
+                    sf::Vertex* Quad = RowOut + Blade * VerticesPerSegment;
+                    Quad[0].position = A;
+                    Quad[1].position = B;
+                    Quad[2].position = B + Offset;
+                    Quad[3].position = A;
+                    Quad[4].position = B + Offset;
+                    Quad[5].position = A + Offset;
+                }
+            }
+        }
+    }
+
+    // Copies the segment ends Field is drawn from at Level into DrawnX/DrawnY
+    void copyDrawnEnds(const GrassField& Field, const int Level, float* DrawnX, float* DrawnY)
+    {
+        const int Ends = drawnEnds(Field, Level);
+        for (int K = 1; K <= Ends; ++K)
+        {
+            const int Row = K * Field.SegmentCount / Ends;
+            std::copy(Field.segmentRowX(Row), Field.segmentRowX(Row) + Field.BladeCount, DrawnX);
+            std::copy(Field.segmentRowY(Row), Field.segmentRowY(Row) + Field.BladeCount, DrawnY);
+            DrawnX += Field.BladeCount;
+            DrawnY += Field.BladeCount;
+        }
+    }
+
+    // Flags every blade with a drawn segment end more than Epsilon from where it was last written, on
+    // either axis, and moves the flagged blades' copies up to date. Bases never move, so they are not
+    // compared. Returns the number flagged.
+    std::size_t markMovedBlades(const GrassField& Field, const int Level, const float Epsilon, float* DrawnX, float* DrawnY,
+        std::uint8_t* Dirty)
+    {
+        const std::size_t Count = Field.BladeCount;
+        const int Ends = drawnEnds(Field, Level);
+        std::fill(Dirty, Dirty + Count, std::uint8_t{ 0 });
+        for (int K = 1; K <= Ends; ++K)
+        {
+            const int Row = K * Field.SegmentCount / Ends;
+            const float* X = Field.segmentRowX(Row);
+            const float* Y = Field.segmentRowY(Row);
+            const float* CopyX = DrawnX + static_cast<std::size_t>(K - 1) * Count;
+            const float* CopyY = DrawnY + static_cast<std::size_t>(K - 1) * Count;
+            for (std::size_t Blade = 0; Blade < Count; ++Blade)
+            {
+                const bool Moved = std::fabs(X[Blade] - CopyX[Blade]) > Epsilon || std::fabs(Y[Blade] - CopyY[Blade]) > Epsilon;
+                Dirty[Blade] |= static_cast<std::uint8_t>(Moved);
+            }
+        }
+
+        std::size_t Marked = 0;
+        for (std::size_t Blade = 0; Blade < Count; ++Blade)
+        {
+            Marked += Dirty[Blade];
+        }
+        if (Marked == 0)
+        {
+            return 0;
+        }
+
+        for (int K = 1; K <= Ends; ++K)
+        {
+            const int Row = K * Field.SegmentCount / Ends;
+            const float* X = Field.segmentRowX(Row);
+            const float* Y = Field.segmentRowY(Row);
+            float* CopyX = DrawnX + static_cast<std::size_t>(K - 1) * Count;
+            float* CopyY = DrawnY + static_cast<std::size_t>(K - 1) * Count;
+            for (std::size_t Blade = 0; Blade < Count; ++Blade)
+            {
+                CopyX[Blade] = Dirty[Blade] ? X[Blade] : CopyX[Blade];
+                CopyY[Blade] = Dirty[Blade] ? Y[Blade] : CopyY[Blade];
+            }
+        }
+        return Marked;
+    }
+
+    // Flags the upload pages holding the vertices of the blades set in Dirty
+    void markDirtyPages(std::vector<std::uint8_t>& Pages, const GrassDrawnItem& Item, const GrassField& Field, const std::uint8_t* Dirty)
+    {
+        const bool Triangle = Item.Level == GrassLodTriangle;
+        const std::size_t BladeVertices = Triangle ? VerticesPerTriangle : VerticesPerSegment;
+        const int Rows = Triangle ? 1 : grassLodSegmentCount(Item.Level, Field.SegmentCount);
+        for (int J = 0; J < Rows; ++J)
+        {
+            const std::size_t RowStart = Item.VertexStart + static_cast<std::size_t>(J) * Field.BladeCount * BladeVertices;
+            for (std::size_t Blade = 0; Blade < Field.BladeCount; ++Blade)
+            {
+                if (Dirty[Blade])
+                {
+                    Pages[(RowStart + Blade * BladeVertices) / GrassVertexPage] = 1;
+                }
+            }
+        }
+    }
+}
+
+float grassPixelsPerUnit(const sf::RenderTarget& Target)
+{
+    return static_cast<float>(Target.getSize().x) / Target.getView().getSize().x;
+}
+
+void buildGrassVertices(GrassRenderer& Renderer, const std::span<const GrassDrawItem> Items, const float PixelsPerUnit)
+{
+    // Pick every item's level first so the array can be sized in one go
+    Renderer.LodStats.reset();
+    std::size_t VertexCount = 0;
+    std::size_t BladeCount = 0;
+    const auto projectedPixels = [PixelsPerUnit](const GrassDrawItem& Item)
+    {
+        return (Item.BladeLength > 0.0f ? Item.BladeLength : grassLodBladeLength(*Item.Field)) * PixelsPerUnit;
+    };
+    for (const GrassDrawItem& Item : Items)
+    {
+        const int Current = Item.LodLevel != nullptr ? *Item.LodLevel : GrassLodFull;
+        const int Level = selectGrassLod(Current, projectedPixels(Item), Renderer.Lod);
+        if (Item.LodLevel != nullptr)
+        {
+            *Item.LodLevel = Level;
+        }
+        Renderer.LodStats.Blades[Level] += Item.Field->BladeCount;
+        VertexCount += vertexCount(*Item.Field, Level);
+        BladeCount += Item.Field->BladeCount;
+    }
+    const auto levelOf = [&](const GrassDrawItem& Item)
+    {
+        return Item.LodLevel != nullptr ? *Item.LodLevel : selectGrassLod(GrassLodFull, projectedPixels(Item), Renderer.Lod);
+    };
+
+    // The previous vertices can be kept blade by blade only if they were built from the same fields at
+    // the same levels, in the same order
+    bool Reuse = Renderer.Dirty.Enabled && Renderer.DrawnItems.size() == Items.size() && Renderer.Vertices.getVertexCount() == VertexCount;
+    for (std::size_t I = 0; Reuse && I < Items.size(); ++I)
+    {
+        const GrassDrawnItem& Drawn = Renderer.DrawnItems[I];
+        const GrassField& Field = *Items[I].Field;
+        Reuse = Drawn.Bases == Field.BaseX && Drawn.BladeCount == Field.BladeCount && Drawn.SegmentCount == Field.SegmentCount
+            && Drawn.Level == levelOf(Items[I]);
+    }
+
+    Renderer.RebuildStats.Blades = BladeCount;
+    Renderer.DirtyPages.assign((VertexCount + GrassVertexPage - 1) / GrassVertexPage, static_cast<std::uint8_t>(!Reuse));
+
+    if (Reuse)
+    {
+        const float Epsilon = Renderer.Dirty.Epsilon / PixelsPerUnit;
+        std::size_t Rebuilt = 0;
+        for (std::size_t I = 0; I < Items.size(); ++I)
+        {
+            const GrassDrawnItem& Drawn = Renderer.DrawnItems[I];
+            const GrassField& Field = *Items[I].Field;
+            const std::size_t Moved = markMovedBlades(Field, Drawn.Level, Epsilon, Renderer.DrawnX.data() + Drawn.DrawnStart,
+                Renderer.DrawnY.data() + Drawn.DrawnStart, Renderer.DirtyBlades.data());
+            if (Moved > 0)
+            {
+                writeGrassVertices(&Renderer.Vertices[Drawn.VertexStart], Field, Drawn.Level, Renderer.DirtyBlades.data());
+                markDirtyPages(Renderer.DirtyPages, Drawn, Field, Renderer.DirtyBlades.data());
+                Rebuilt += Moved;
+            }
+        }
+        Renderer.RebuildStats.Rebuilt = Rebuilt;
+        return;
+    }
+
+    Renderer.RebuildStats.Rebuilt = BladeCount;
+    if (Renderer.Vertices.getVertexCount() != VertexCount)
+    {
+        Renderer.Vertices.resize(VertexCount);
+        for (std::size_t I = 0; I < VertexCount; ++I)
+        {
+            Renderer.Vertices[I].color = Renderer.Color;
+        }
+    }
+
+    // Record what this build drew from, for the next one to compare against
+    Renderer.DrawnItems.clear();
+    std::size_t VertexStart = 0;
+    std::size_t DrawnFloats = 0;
+    std::size_t MaxBlades = 0;
+    for (const GrassDrawItem& Item : Items)
+    {
+        const GrassField& Field = *Item.Field;
+        const int Level = levelOf(Item);
+        Renderer.DrawnItems.push_back({ Field.BaseX, Field.BladeCount, Field.SegmentCount, Level, VertexStart, DrawnFloats });
+        VertexStart += vertexCount(Field, Level);
+        DrawnFloats += static_cast<std::size_t>(drawnEnds(Field, Level)) * Field.BladeCount;
+        MaxBlades = std::max(MaxBlades, Field.BladeCount);
+    }
+    if (Renderer.Dirty.Enabled)
+    {
+        Renderer.DrawnX.resize(DrawnFloats);
+        Renderer.DrawnY.resize(DrawnFloats);
+        Renderer.DirtyBlades.resize(MaxBlades);
+    }
+
+    for (std::size_t I = 0; I < Items.size(); ++I)
+    {
+        const GrassDrawnItem& Drawn = Renderer.DrawnItems[I];
+        if (Drawn.BladeCount == 0)
+        {
+            continue;
+        }
+        writeGrassVertices(&Renderer.Vertices[Drawn.VertexStart], *Items[I].Field, Drawn.Level, nullptr);
+        if (Renderer.Dirty.Enabled)
+        {
+            copyDrawnEnds(*Items[I].Field, Drawn.Level, Renderer.DrawnX.data() + Drawn.DrawnStart, Renderer.DrawnY.data() + Drawn.DrawnStart);
+        }
+    }
+}
+
+void buildGrassVertices(GrassRenderer& Renderer, const GrassField& Field, const float PixelsPerUnit)
+{
+    // Every pose of a field shares its lengths, so they are only measured again for another field
+    if (Renderer.SingleFieldLengths != Field.LengthVariance)
+    {
+        Renderer.SingleFieldLengths = Field.LengthVariance;
+        Renderer.SingleFieldBladeLength = grassLodBladeLength(Field);
+    }
+    const GrassDrawItem Items[] = { { &Field, &Renderer.SingleFieldLod, Renderer.SingleFieldBladeLength } };
+    buildGrassVertices(Renderer, Items, PixelsPerUnit);
+}
+
+void drawGrass(sf::RenderTarget& Target, GrassRenderer& Renderer)
+{
+    const std::size_t VertexCount = Renderer.Vertices.getVertexCount();
+    if (VertexCount == 0)
+    {
+        return;
+    }
+    if (!sf::VertexBuffer::isAvailable())
+    {
+        Target.draw(Renderer.Vertices);
+        return;
+    }
+
+    // A resized buffer has lost its contents, so everything goes up again
+    const bool Resized = Renderer.Buffer.getVertexCount() != VertexCount;
+    if (Resized && !Renderer.Buffer.create(VertexCount))
+    {
+        Target.draw(Renderer.Vertices);
+        return;
+    }
+
+    // One partial update per run of consecutive dirty pages
+    const std::size_t PageCount = Renderer.DirtyPages.size();
+    for (std::size_t Page = 0; Page < PageCount; )
+    {
+        if (!Resized && !Renderer.DirtyPages[Page])
+        {
+            ++Page;
+            continue;
+        }
+        std::size_t End = Page + 1;
+        while (End < PageCount && (Resized || Renderer.DirtyPages[End]))
+        {
+            ++End;
+        }
+        const std::size_t First = Page * GrassVertexPage;
+        const std::size_t Count = std::min(End * GrassVertexPage, VertexCount) - First;
+        Renderer.Buffer.update(&Renderer.Vertices[First], Count, static_cast<unsigned>(First));
+        Page = End;
+    }
+    Target.draw(Renderer.Buffer);
+}
+
+void renderGrass(sf::RenderTarget& Target, GrassRenderer& Renderer, const std::span<const GrassDrawItem> Items)
+{
+    buildGrassVertices(Renderer, Items, grassPixelsPerUnit(Target));
+    drawGrass(Target, Renderer);
+}
+
+void renderGrass(sf::RenderTarget& Target, GrassRenderer& Renderer, const GrassField& Field)
+{
+    buildGrassVertices(Renderer, Field, grassPixelsPerUnit(Target));
+    drawGrass(Target, Renderer);
+}
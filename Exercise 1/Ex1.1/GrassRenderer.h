@@ -0,0 +1,94 @@
+#pragma once
+
+#include "GrassField.h"
+#include "GrassLod.h"
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include <SFML/Graphics/VertexBuffer.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Vertices are uploaded to the GPU in pages of this many, so a frame that rewrote a few scattered blades
+// only sends the pages they fall in
+constexpr std::size_t GrassVertexPage = 1536;
+
+// A blade whose drawn segment ends have all moved less than Epsilon screen pixels on each axis since its
+// vertices were last written keeps those vertices, so no drawn segment end is ever more than Epsilon off
+struct GrassDirtySettings
+{
+    bool Enabled = true;
+    float Epsilon = 0.1f;
+};
+
+struct GrassRebuildStats
+{
+    std::size_t Blades = 0;
+    std::size_t Rebuilt = 0;
+
+    float fraction() const { return Blades > 0 ? static_cast<float>(Rebuilt) / static_cast<float>(Blades) : 0.0f; }
+};
+
+// What one draw item was built from, to tell whether the next build can reuse its vertices
+struct GrassDrawnItem
+{
+    const float* Bases = nullptr; // Shared by every pose buffer of the same field
+    std::size_t BladeCount = 0;
+    int SegmentCount = 0;
+    int Level = GrassLodFull;
+    std::size_t VertexStart = 0;
+    std::size_t DrawnStart = 0;   // Offset of its rows in DrawnX/DrawnY
+};
+
+// Batches every segment of every blade into one persistent triangle list so a whole field is
+// submitted with a single draw call. The array is only resized when the field shape changes, and while
+// the same fields are drawn at the same levels only the blades that moved are rewritten.
+struct GrassRenderer
+{
+    sf::VertexArray Vertices{ sf::Triangles };
+    sf::Color Color{ 34, 139, 34 };
+
+    GrassLodSettings Lod;
+    GrassLodStats LodStats;
+    int SingleFieldLod = GrassLodFull; // Level state for the single-field overloads
+    const float* SingleFieldLengths = nullptr; // Lengths SingleFieldBladeLength was measured from
+    float SingleFieldBladeLength = 0.0f;
+
+    GrassDirtySettings Dirty;
+    GrassRebuildStats RebuildStats; // Blades rewritten by the last build
+
+    // GPU copy of Vertices, updated from the pages the last build wrote
+    sf::VertexBuffer Buffer{ sf::Triangles, sf::VertexBuffer::Stream };
+    std::vector<std::uint8_t> DirtyPages;
+
+    // Blade positions the vertices were last written from: per item, one row of BladeCount floats per
+    // drawn segment end
+    std::vector<GrassDrawnItem> DrawnItems;
+    std::vector<float> DrawnX;
+    std::vector<float> DrawnY;
+    std::vector<std::uint8_t> DirtyBlades;
+};
+
+// Thicker at the base, thinner towards the tip (3px down to 1px over the whole blade)
+inline float grassSegmentThickness(const int Segment, const int SegmentCount)
+{
+    return 3.0f - 2.0f * static_cast<float>(Segment) / static_cast<float>(SegmentCount);
+}
+
+// On-screen pixels per world unit under the target's current view
+float grassPixelsPerUnit(const sf::RenderTarget& Target);
+
+// PixelsPerUnit converts blade lengths to on-screen pixels when choosing the detail level
+void buildGrassVertices(GrassRenderer& Renderer, std::span<const GrassDrawItem> Items, float PixelsPerUnit);
+void buildGrassVertices(GrassRenderer& Renderer, const GrassField& Field, float PixelsPerUnit = 1.0f);
+
+// Sends the pages written by the last build to Renderer.Buffer and draws it, or draws Vertices directly
+// when the GPU has no vertex buffer support
+void drawGrass(sf::RenderTarget& Target, GrassRenderer& Renderer);
+
+// Several fields (e.g. the active chunks of a GrassWorld) are batched into the same single draw call
+void renderGrass(sf::RenderTarget& Target, GrassRenderer& Renderer, std::span<const GrassDrawItem> Items);
+void renderGrass(sf::RenderTarget& Target, GrassRenderer& Renderer, const GrassField& Field);
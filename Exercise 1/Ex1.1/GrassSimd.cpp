@@ -0,0 +1,118 @@
+#include "GrassSimd.h"
+
+#include "CpuFeatures.h"
+
+#include <algorithm>
+#include <cmath>
+
+GrassIsa detectGrassIsa()
+{
+#if GRASS_SIMD_X86
+    if (cpuHasAvx512())
+    {
+        return GrassIsa::Avx512;
+    }
+    if (cpuHasAvx2())
+    {
+        return GrassIsa::Avx2;
+    }
+    return GrassIsa::Sse2;
+#else
+    return GrassIsa::Scalar;
+#endif
+}
+
+const char* grassIsaName(const GrassIsa Isa)
+{
+    switch (Isa)
+    {
+    case GrassIsa::Sse2:
+        return "SSE2";
+    case GrassIsa::Avx2:
+        return "AVX2";
+    case GrassIsa::Avx512:
+        return "AVX-512";
+    default:
+        return "Scalar";
+    }
+}
+
+GrassUpdateKernel grassUpdateKernel(const GrassIsa Isa, const GrassSegmentBuilder Builder)
+{
+    if (Builder == GrassSegmentBuilder::Incremental)
+    {
+        switch (Isa)
+        {
+#if GRASS_SIMD_X86
+        case GrassIsa::Sse2:
+            return updateGrassSse2Incremental;
+        case GrassIsa::Avx2:
+            return updateGrassAvx2Incremental;
+        case GrassIsa::Avx512:
+            return updateGrassAvx512Incremental;
+#endif
+        default:
+            return updateGrassIncrementalRange;
+        }
+    }
+
+    switch (Isa)
+    {
+#if GRASS_SIMD_X86
+    case GrassIsa::Sse2:
+        return updateGrassSse2;
+    case GrassIsa::Avx2:
+        return updateGrassAvx2;
+    case GrassIsa::Avx512:
+        return updateGrassAvx512;
+#endif
+    default:
+        return updateGrassRange;
+    }
+}
+
+GrassPoseKernel grassPoseKernel(const GrassIsa Isa)
+{
+    switch (Isa)
+    {
+#if GRASS_SIMD_X86
+    case GrassIsa::Sse2:
+        return poseGrassSse2;
+    case GrassIsa::Avx2:
+        return poseGrassAvx2;
+    case GrassIsa::Avx512:
+        return poseGrassAvx512;
+#endif
+    default:
+        return poseGrassRange;
+    }
+}
+
+void updateGrass(GrassField& Field, const float Time, const GrassIsa Isa, const GrassSegmentBuilder Builder)
+{
+    grassUpdateKernel(Isa, Builder)(Field, Time, 0, Field.BladeCount);
+}
+
+float grassKernelMaxError(const GrassField& Field, const GrassIsa Isa, const GrassSegmentBuilder Builder)
+{
+    GrassField Reference;
+    GrassField Candidate;
+    Reference.copyFrom(Field);
+    Candidate.copyFrom(Field);
+
+    float MaxError = 0.0f;
+    for (float Time = 0.0f; Time < 3600.0f; Time += 97.3f)
+    {
+        updateGrass(Reference, Time, GrassIsa::Scalar);
+        updateGrass(Candidate, Time, Isa, Builder);
+        for (int Segment = 1; Segment <= Field.SegmentCount; ++Segment)
+        {
+            for (std::size_t Blade = 0; Blade < Field.BladeCount; ++Blade)
+            {
+                const sf::Vector2f Difference = Reference.segment(Blade, Segment) - Candidate.segment(Blade, Segment);
+                MaxError = std::max(MaxError, std::hypot(Difference.x, Difference.y));
+            }
+        }
+    }
+    return MaxError;
+}
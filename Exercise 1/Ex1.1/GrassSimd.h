@@ -0,0 +1,63 @@
+#pragma once
+
+#include "GrassField.h"
+
+#include <cstddef>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define GRASS_SIMD_X86 1
+#else
+#define GRASS_SIMD_X86 0
+#endif
+
+enum class GrassIsa
+{
+    Scalar,
+    Sse2,
+    Avx2,
+    Avx512
+};
+
+// How segment directions are built: a sin/cos pair per segment, or one rotation per blade advanced
+// incrementally along the blade (cheaper for long blades, see updateGrassIncrementalRange)
+enum class GrassSegmentBuilder
+{
+    Direct,
+    Incremental
+};
+
+// Updates blades [Begin, End). Begin must be a multiple of GrassLaneWidth; End is rounded up to the
+// lane width, which is always safe because the field arrays are padded to Stride.
+using GrassUpdateKernel = void (*)(GrassField& Field, float Time, std::size_t Begin, std::size_t End);
+
+// Builds the segment positions of blades [Begin, End) from per-segment bend angles, with the same
+// alignment rules as GrassUpdateKernel (see poseGrassRange)
+using GrassPoseKernel = void (*)(GrassField& Field, const float* PreviousBend, const float* Bend, float Alpha, std::size_t Begin, std::size_t End);
+
+// Picks the widest instruction set supported by both the build and the running CPU
+GrassIsa detectGrassIsa();
+const char* grassIsaName(GrassIsa Isa);
+GrassUpdateKernel grassUpdateKernel(GrassIsa Isa, GrassSegmentBuilder Builder = GrassSegmentBuilder::Direct);
+GrassPoseKernel grassPoseKernel(GrassIsa Isa);
+
+// Updates the whole field with the given kernel
+void updateGrass(GrassField& Field, float Time, GrassIsa Isa, GrassSegmentBuilder Builder = GrassSegmentBuilder::Direct);
+
+// Largest distance between any segment position produced by the given kernel and by the direct scalar
+// reference, over a sweep of simulation times
+float grassKernelMaxError(const GrassField& Field, GrassIsa Isa, GrassSegmentBuilder Builder = GrassSegmentBuilder::Direct);
+
+// Most grassKernelMaxError may report, in px, for a kernel to count as correct. The vector sin/cos
+// polynomials and the incremental builder's rotations land within about 0.0006 px of the scalar path.
+constexpr float GrassKernelTolerance = 0.002f;
+
+// Kernels built in their own translation units so each can be compiled for its instruction set
+void updateGrassSse2(GrassField& Field, float Time, std::size_t Begin, std::size_t End);
+void updateGrassAvx2(GrassField& Field, float Time, std::size_t Begin, std::size_t End);
+void updateGrassAvx512(GrassField& Field, float Time, std::size_t Begin, std::size_t End);
+void updateGrassSse2Incremental(GrassField& Field, float Time, std::size_t Begin, std::size_t End);
+void updateGrassAvx2Incremental(GrassField& Field, float Time, std::size_t Begin, std::size_t End);
+void updateGrassAvx512Incremental(GrassField& Field, float Time, std::size_t Begin, std::size_t End);
+void poseGrassSse2(GrassField& Field, const float* PreviousBend, const float* Bend, float Alpha, std::size_t Begin, std::size_t End);
+void poseGrassAvx2(GrassField& Field, const float* PreviousBend, const float* Bend, float Alpha, std::size_t Begin, std::size_t End);
+void poseGrassAvx512(GrassField& Field, const float* PreviousBend, const float* Bend, float Alpha, std::size_t Begin, std::size_t End);
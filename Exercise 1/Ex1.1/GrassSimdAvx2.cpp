@@ -0,0 +1,57 @@
+// Compiled with AVX2 and FMA enabled (see the project files); only called after detectGrassIsa()
+// has confirmed the CPU supports them.
+
+#include "GrassSimd.h"
+#include "GrassSimdKernel.h"
+
+#if GRASS_SIMD_X86
+
+#include <immintrin.h>
+
+namespace
+{
+    struct Avx2Lanes
+    {
+        using Float = __m256;
+        using Int = __m256i;
+        static constexpr std::size_t Width = 8;
+
+        static Float set(const float Value) { return _mm256_set1_ps(Value); }
+        static Float load(const float* Address) { return _mm256_load_ps(Address); }
+        static void store(float* Address, const Float Value) { _mm256_store_ps(Address, Value); }
+        static Float add(const Float A, const Float B) { return _mm256_add_ps(A, B); }
+        static Float mul(const Float A, const Float B) { return _mm256_mul_ps(A, B); }
+        static Float fmadd(const Float A, const Float B, const Float C) { return _mm256_fmadd_ps(A, B, C); }
+        static Float fnmadd(const Float A, const Float B, const Float C) { return _mm256_fnmadd_ps(A, B, C); }
+        static Int roundToInt(const Float Value) { return _mm256_cvtps_epi32(Value); }
+        static Float toFloat(const Int Value) { return _mm256_cvtepi32_ps(Value); }
+
+        static void applyQuadrant(const Int Quadrant, const Float SinPoly, const Float CosPoly, Float& Sin, Float& Cos)
+        {
+            const Float Swap = _mm256_castsi256_ps(_mm256_slli_epi32(Quadrant, 31));
+            const Float SinSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(Quadrant, _mm256_set1_epi32(2)), 30));
+            const Float CosSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(Quadrant, _mm256_set1_epi32(1)), _mm256_set1_epi32(2)), 30));
+            // blendv selects on the sign bit, so shifting bit 0 of the quadrant up is enough
+            Sin = _mm256_xor_ps(_mm256_blendv_ps(SinPoly, CosPoly, Swap), SinSign);
+            Cos = _mm256_xor_ps(_mm256_blendv_ps(CosPoly, SinPoly, Swap), CosSign);
+        }
+    };
+}
+
+void updateGrassAvx2(GrassField& Field, const float Time, const std::size_t Begin, const std::size_t End)
+{
+    GrassSimdDetail::updateGrassLanes<Avx2Lanes, false>(Field, Time, Begin, End);
+}
+
+void updateGrassAvx2Incremental(GrassField& Field, const float Time, const std::size_t Begin, const std::size_t End)
+{
+    GrassSimdDetail::updateGrassLanes<Avx2Lanes, true>(Field, Time, Begin, End);
+}
+
+void poseGrassAvx2(GrassField& Field, const float* PreviousBend, const float* Bend, const float Alpha, const std::size_t Begin,
+    const std::size_t End)
+{
+    GrassSimdDetail::poseGrassLanes<Avx2Lanes>(Field, PreviousBend, Bend, Alpha, Begin, End);
+}
+
+#endif
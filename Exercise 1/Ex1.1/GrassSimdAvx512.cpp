@@ -0,0 +1,57 @@
+// Compiled with AVX-512F enabled (see the project files); only called after detectGrassIsa()
+// has confirmed the CPU and operating system support it.
+
+#include "GrassSimd.h"
+#include "GrassSimdKernel.h"
+
+#if GRASS_SIMD_X86
+
+#include <immintrin.h>
+
+namespace
+{
+    struct Avx512Lanes
+    {
+        using Float = __m512;
+        using Int = __m512i;
+        static constexpr std::size_t Width = 16;
+
+        static Float set(const float Value) { return _mm512_set1_ps(Value); }
+        static Float load(const float* Address) { return _mm512_load_ps(Address); }
+        static void store(float* Address, const Float Value) { _mm512_store_ps(Address, Value); }
+        static Float add(const Float A, const Float B) { return _mm512_add_ps(A, B); }
+        static Float mul(const Float A, const Float B) { return _mm512_mul_ps(A, B); }
+        static Float fmadd(const Float A, const Float B, const Float C) { return _mm512_fmadd_ps(A, B, C); }
+        static Float fnmadd(const Float A, const Float B, const Float C) { return _mm512_fnmadd_ps(A, B, C); }
+        static Int roundToInt(const Float Value) { return _mm512_cvtps_epi32(Value); }
+        static Float toFloat(const Int Value) { return _mm512_cvtepi32_ps(Value); }
+
+        static void applyQuadrant(const Int Quadrant, const Float SinPoly, const Float CosPoly, Float& Sin, Float& Cos)
+        {
+            const __mmask16 Swap = _mm512_test_epi32_mask(Quadrant, _mm512_set1_epi32(1));
+            const __m512i SinSign = _mm512_slli_epi32(_mm512_and_si512(Quadrant, _mm512_set1_epi32(2)), 30);
+            const __m512i CosSign = _mm512_slli_epi32(_mm512_and_si512(_mm512_add_epi32(Quadrant, _mm512_set1_epi32(1)), _mm512_set1_epi32(2)), 30);
+            // Integer xor keeps this within AVX-512F (the float xor needs AVX-512DQ)
+            Sin = _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(_mm512_mask_blend_ps(Swap, SinPoly, CosPoly)), SinSign));
+            Cos = _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(_mm512_mask_blend_ps(Swap, CosPoly, SinPoly)), CosSign));
+        }
+    };
+}
+
+void updateGrassAvx512(GrassField& Field, const float Time, const std::size_t Begin, const std::size_t End)
+{
+    GrassSimdDetail::updateGrassLanes<Avx512Lanes, false>(Field, Time, Begin, End);
+}
+
+void updateGrassAvx512Incremental(GrassField& Field, const float Time, const std::size_t Begin, const std::size_t End)
+{
+    GrassSimdDetail::updateGrassLanes<Avx512Lanes, true>(Field, Time, Begin, End);
+}
+
+void poseGrassAvx512(GrassField& Field, const float* PreviousBend, const float* Bend, const float Alpha, const std::size_t Begin,
+    const std::size_t End)
+{
+    GrassSimdDetail::poseGrassLanes<Avx512Lanes>(Field, PreviousBend, Bend, Alpha, Begin, End);
+}
+
+#endif
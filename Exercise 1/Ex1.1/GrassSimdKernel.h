@@ -0,0 +1,148 @@
+#pragma once
+
+// Instruction-set independent body of the vector grass kernels. Only included by the GrassSimd*.cpp
+// translation units, each of which supplies a lane type V wrapping one register width.
+
+#include "GrassField.h"
+
+#include <cstddef>
+
+namespace GrassSimdDetail
+{
+    // Cody-Waite split of pi/2: the first two parts have trailing zero bits, so Q * Part is exact
+    // for |Q| < 2^12 and the reduction stays accurate for arguments up to roughly 8192 radians.
+    constexpr float TwoOverPi = 0.636619772367581f;
+    constexpr float PiOverTwoA = 1.5703125f;
+    constexpr float PiOverTwoB = 4.837512969970703125e-4f;
+    constexpr float PiOverTwoC = 7.54978995489188216e-8f;
+
+    // Minimax polynomials on [-pi/4, pi/4] (Cephes sinf/cosf). Together with the reduction above the
+    // maximum absolute error of sinCos is 1.2e-7 for |X| <= 8192, measured against double precision.
+    constexpr float SinC1 = -1.6666654611e-1f;
+    constexpr float SinC2 = 8.3321608736e-3f;
+    constexpr float SinC3 = -1.9515295891e-4f;
+    constexpr float CosC1 = 4.166664568298827e-2f;
+    constexpr float CosC2 = -1.388731625493765e-3f;
+    constexpr float CosC3 = 2.443315711809948e-5f;
+
+    template <class V>
+    inline void sinCos(const typename V::Float X, typename V::Float& Sin, typename V::Float& Cos)
+    {
+        using F = typename V::Float;
+
+        // Quadrant index and remainder in [-pi/4, pi/4]
+        const auto Quadrant = V::roundToInt(V::mul(X, V::set(TwoOverPi)));
+        const F Q = V::toFloat(Quadrant);
+        F R = V::fnmadd(Q, V::set(PiOverTwoA), X);
+        R = V::fnmadd(Q, V::set(PiOverTwoB), R);
+        R = V::fnmadd(Q, V::set(PiOverTwoC), R);
+
+        const F R2 = V::mul(R, R);
+        F SinPoly = V::fmadd(R2, V::set(SinC3), V::set(SinC2));
+        SinPoly = V::fmadd(R2, SinPoly, V::set(SinC1));
+        SinPoly = V::fmadd(V::mul(R2, R), SinPoly, R);
+
+        F CosPoly = V::fmadd(R2, V::set(CosC3), V::set(CosC2));
+        CosPoly = V::fmadd(R2, CosPoly, V::set(CosC1));
+        CosPoly = V::fmadd(V::mul(R2, R2), CosPoly, V::fnmadd(V::set(0.5f), R2, V::set(1.0f)));
+
+        // Odd quadrants swap sin and cos; quadrants 2 and 3 negate sin, quadrants 1 and 2 negate cos
+        V::applyQuadrant(Quadrant, SinPoly, CosPoly, Sin, Cos);
+    }
+
+    // Incremental selects the rotation-recurrence segment builder (see updateGrassIncrementalRange)
+    template <class V, bool Incremental>
+    inline void updateGrassLanes(GrassField& Field, const float Time, const std::size_t Begin, const std::size_t End)
+    {
+        using F = typename V::Float;
+
+        const int Segments = Field.SegmentCount;
+        const float InvSegments = 1.0f / static_cast<float>(Segments);
+        const F TimeV = V::set(Time);
+        const F FrequencyScale = V::set(WindSwayFrequencyBase);
+        const F SwayScale = V::set(WindSwayAmplitude * DampingFactor);
+        const F LengthScale = V::set(BaseGrassLength * InvSegments);
+        const F FlutterWeight = V::set(Field.FlutterWeight);
+
+        for (std::size_t Blade = Begin; Blade < End; Blade += V::Width)
+        {
+            const F EffectiveFrequency = V::mul(FrequencyScale, V::load(Field.FrequencyVariance + Blade));
+            F SwaySin, SwayCos;
+            // Rounded multiply then add, not fused: at large times the phase argument is big enough
+            // that a fused result visibly drifts from the scalar path
+            sinCos<V>(V::add(V::mul(TimeV, EffectiveFrequency), V::load(Field.PhaseOffset + Blade)), SwaySin, SwayCos);
+            const F Sway = V::mul(V::add(V::load(Field.WindOffset + Blade), V::mul(FlutterWeight, SwaySin)), SwayScale);
+            const F SegmentLength = V::mul(LengthScale, V::load(Field.LengthVariance + Blade));
+
+            F X = V::load(Field.BaseX + Blade);
+            F Y = V::load(Field.BaseY + Blade);
+            F StepSin = V::set(0.0f);
+            F StepCos = V::set(1.0f);
+            F Sin = V::set(0.0f);
+            F Cos = V::set(1.0f);
+            if constexpr (Incremental)
+            {
+                sinCos<V>(V::mul(Sway, V::set(InvSegments)), StepSin, StepCos);
+            }
+
+            for (int I = 1; I <= Segments; ++I)
+            {
+                if constexpr (Incremental)
+                {
+                    const F RotatedSin = V::fmadd(Sin, StepCos, V::mul(Cos, StepSin));
+                    Cos = V::fnmadd(Sin, StepSin, V::mul(Cos, StepCos));
+                    Sin = RotatedSin;
+                    if (I % GrassRenormalizeInterval == 0)
+                    {
+                        const F LengthSquared = V::fmadd(Sin, Sin, V::mul(Cos, Cos));
+                        const F Correction = V::fnmadd(V::set(0.5f), LengthSquared, V::set(1.5f));
+                        Sin = V::mul(Sin, Correction);
+                        Cos = V::mul(Cos, Correction);
+                    }
+                }
+                else
+                {
+                    sinCos<V>(V::mul(Sway, V::set(static_cast<float>(I) * InvSegments)), Sin, Cos);
+                }
+                X = V::fmadd(Sin, SegmentLength, X);
+                Y = V::fnmadd(Cos, SegmentLength, Y);
+                V::store(Field.segmentRowX(I) + Blade, X);
+                V::store(Field.segmentRowY(I) + Blade, Y);
+            }
+        }
+    }
+
+    // Builds segment positions from per-segment bend angles, blended between two simulation steps
+    // (see poseGrassRange)
+    template <class V>
+    inline void poseGrassLanes(GrassField& Field, const float* PreviousBend, const float* Bend, const float Alpha,
+        const std::size_t Begin, const std::size_t End)
+    {
+        using F = typename V::Float;
+
+        const int Segments = Field.SegmentCount;
+        const F LengthScale = V::set(BaseGrassLength / static_cast<float>(Segments));
+        const F AlphaV = V::set(Alpha);
+
+        for (std::size_t Blade = Begin; Blade < End; Blade += V::Width)
+        {
+            const F SegmentLength = V::mul(LengthScale, V::load(Field.LengthVariance + Blade));
+            F X = V::load(Field.BaseX + Blade);
+            F Y = V::load(Field.BaseY + Blade);
+            F Angle = V::set(0.0f);
+            for (int I = 1; I <= Segments; ++I)
+            {
+                const std::size_t Row = static_cast<std::size_t>(I - 1) * Field.Stride + Blade;
+                const F Previous = V::load(PreviousBend + Row);
+                Angle = V::add(Angle, V::fmadd(AlphaV, V::load(Bend + Row), V::fnmadd(AlphaV, Previous, Previous)));
+
+                F Sin, Cos;
+                sinCos<V>(Angle, Sin, Cos);
+                X = V::fmadd(Sin, SegmentLength, X);
+                Y = V::fnmadd(Cos, SegmentLength, Y);
+                V::store(Field.segmentRowX(I) + Blade, X);
+                V::store(Field.segmentRowY(I) + Blade, Y);
+            }
+        }
+    }
+}
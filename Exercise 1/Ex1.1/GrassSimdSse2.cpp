@@ -0,0 +1,55 @@
+// Baseline vector kernel: SSE2 is part of x86-64, so this one needs no runtime check.
+
+#include "GrassSimd.h"
+#include "GrassSimdKernel.h"
+
+#if GRASS_SIMD_X86
+
+#include <emmintrin.h>
+
+namespace
+{
+    struct Sse2Lanes
+    {
+        using Float = __m128;
+        using Int = __m128i;
+        static constexpr std::size_t Width = 4;
+
+        static Float set(const float Value) { return _mm_set1_ps(Value); }
+        static Float load(const float* Address) { return _mm_load_ps(Address); }
+        static void store(float* Address, const Float Value) { _mm_store_ps(Address, Value); }
+        static Float add(const Float A, const Float B) { return _mm_add_ps(A, B); }
+        static Float mul(const Float A, const Float B) { return _mm_mul_ps(A, B); }
+        static Float fmadd(const Float A, const Float B, const Float C) { return _mm_add_ps(_mm_mul_ps(A, B), C); }
+        static Float fnmadd(const Float A, const Float B, const Float C) { return _mm_sub_ps(C, _mm_mul_ps(A, B)); }
+        static Int roundToInt(const Float Value) { return _mm_cvtps_epi32(Value); }
+        static Float toFloat(const Int Value) { return _mm_cvtepi32_ps(Value); }
+
+        static void applyQuadrant(const Int Quadrant, const Float SinPoly, const Float CosPoly, Float& Sin, Float& Cos)
+        {
+            const Float Swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(Quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+            const Float SinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(Quadrant, _mm_set1_epi32(2)), 30));
+            const Float CosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(Quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30));
+            Sin = _mm_xor_ps(_mm_or_ps(_mm_and_ps(Swap, CosPoly), _mm_andnot_ps(Swap, SinPoly)), SinSign);
+            Cos = _mm_xor_ps(_mm_or_ps(_mm_and_ps(Swap, SinPoly), _mm_andnot_ps(Swap, CosPoly)), CosSign);
+        }
+    };
+}
+
+void updateGrassSse2(GrassField& Field, const float Time, const std::size_t Begin, const std::size_t End)
+{
+    GrassSimdDetail::updateGrassLanes<Sse2Lanes, false>(Field, Time, Begin, End);
+}
+
+void updateGrassSse2Incremental(GrassField& Field, const float Time, const std::size_t Begin, const std::size_t End)
+{
+    GrassSimdDetail::updateGrassLanes<Sse2Lanes, true>(Field, Time, Begin, End);
+}
+
+void poseGrassSse2(GrassField& Field, const float* PreviousBend, const float* Bend, const float Alpha, const std::size_t Begin,
+    const std::size_t End)
+{
+    GrassSimdDetail::poseGrassLanes<Sse2Lanes>(Field, PreviousBend, Bend, Alpha, Begin, End);
+}
+
+#endif
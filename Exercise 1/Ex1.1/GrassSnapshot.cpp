@@ -0,0 +1,172 @@
+#include "GrassSnapshot.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // Maps the whole file privately: pages are shared with the page cache until written, and writes never
+    // reach the file. Returns null on any failure, including an empty file.
+    std::shared_ptr<void> mapFileCopyOnWrite(const std::string& Path, std::size_t& Size)
+    {
+#ifdef _WIN32
+        const HANDLE File = CreateFileA(Path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (File == INVALID_HANDLE_VALUE)
+        {
+            return nullptr;
+        }
+        LARGE_INTEGER FileSize{};
+        const HANDLE MappingHandle = GetFileSizeEx(File, &FileSize) && FileSize.QuadPart > 0
+            ? CreateFileMappingA(File, nullptr, PAGE_WRITECOPY, 0, 0, nullptr) : nullptr;
+        void* View = MappingHandle ? MapViewOfFile(MappingHandle, FILE_MAP_COPY, 0, 0, 0) : nullptr;
+        if (MappingHandle)
+        {
+            CloseHandle(MappingHandle);
+        }
+        CloseHandle(File);
+        if (!View)
+        {
+            return nullptr;
+        }
+        Size = static_cast<std::size_t>(FileSize.QuadPart);
+        return std::shared_ptr<void>(View, [](void* Address) { UnmapViewOfFile(Address); });
+#else
+        const int File = open(Path.c_str(), O_RDONLY);
+        if (File < 0)
+        {
+            return nullptr;
+        }
+        struct stat Status{};
+        void* View = MAP_FAILED;
+        if (fstat(File, &Status) == 0 && Status.st_size > 0)
+        {
+            View = mmap(nullptr, static_cast<std::size_t>(Status.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, File, 0);
+        }
+        close(File);
+        if (View == MAP_FAILED)
+        {
+            return nullptr;
+        }
+        Size = static_cast<std::size_t>(Status.st_size);
+        return std::shared_ptr<void>(View, [Size](void* Address) { munmap(Address, Size); });
+#endif
+    }
+
+    void writeFloats(std::ofstream& Stream, const float* Values, const std::size_t Count)
+    {
+        Stream.write(reinterpret_cast<const char*>(Values), static_cast<std::streamsize>(Count * sizeof(float)));
+    }
+}
+
+bool saveGrassSnapshot(const GrassField& Field, const std::string& Path, const bool IncludeRestPose)
+{
+    std::ofstream Stream(Path, std::ios::binary | std::ios::trunc);
+    if (!Stream)
+    {
+        return false;
+    }
+
+    GrassSnapshotHeader Header{};
+    std::memcpy(Header.Magic, GrassSnapshotMagic, sizeof(Header.Magic));
+    Header.Version = GrassSnapshotVersion;
+    Header.Flags = IncludeRestPose ? GrassSnapshotRestPose : 0u;
+    Header.BladeCount = Field.BladeCount;
+    Header.Stride = Field.Stride;
+    Header.SegmentCount = static_cast<std::uint32_t>(Field.SegmentCount);
+    Stream.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+
+    // The first five attribute arrays are contiguous; WindOffset is stored cleared
+    const std::vector<float> Zeros(Field.Stride, 0.0f);
+    writeFloats(Stream, Field.BaseX, Field.Stride * (GrassAttributeArrays - 1));
+    writeFloats(Stream, Zeros.data(), Field.Stride);
+
+    if (IncludeRestPose)
+    {
+        // Unswayed blades: every segment points straight up from the base
+        const float InvSegments = 1.0f / static_cast<float>(Field.SegmentCount);
+        std::vector<float> Row(Field.Stride);
+        for (int Segment = 0; Segment <= Field.SegmentCount; ++Segment)
+        {
+            writeFloats(Stream, Field.BaseX, Field.Stride);
+        }
+        for (int Segment = 0; Segment <= Field.SegmentCount; ++Segment)
+        {
+            const float Rise = static_cast<float>(Segment) * BaseGrassLength * InvSegments;
+            for (std::size_t Blade = 0; Blade < Field.Stride; ++Blade)
+            {
+                Row[Blade] = Field.BaseY[Blade] - Rise * Field.LengthVariance[Blade];
+            }
+            writeFloats(Stream, Row.data(), Field.Stride);
+        }
+    }
+
+    return static_cast<bool>(Stream.flush());
+}
+
+bool loadGrassSnapshot(GrassField& Field, const std::string& Path)
+{
+    std::size_t FileSize = 0;
+    const std::shared_ptr<void> Mapping = mapFileCopyOnWrite(Path, FileSize);
+    if (!Mapping || FileSize < sizeof(GrassSnapshotHeader))
+    {
+        return false;
+    }
+
+    GrassSnapshotHeader Header;
+    std::memcpy(&Header, Mapping.get(), sizeof(Header));
+    const bool HasRestPose = (Header.Flags & GrassSnapshotRestPose) != 0;
+    if (std::memcmp(Header.Magic, GrassSnapshotMagic, sizeof(Header.Magic)) != 0 || Header.Version != GrassSnapshotVersion
+        || Header.SegmentCount == 0 || Header.Stride % GrassLaneWidth != 0 || Header.Stride < Header.BladeCount
+        || Header.Stride - Header.BladeCount >= GrassLaneWidth || Header.Stride > FileSize / (GrassAttributeArrays * sizeof(float))
+        || Header.SegmentCount > static_cast<std::uint32_t>(MaxGrassSegments))
+    {
+        return false;
+    }
+
+    const std::size_t Stride = static_cast<std::size_t>(Header.Stride);
+    const std::size_t AttributeFloats = Stride * GrassAttributeArrays;
+    const std::size_t SegmentFloats = Stride * 2 * (static_cast<std::size_t>(Header.SegmentCount) + 1);
+    const std::size_t ExpectedSize = sizeof(Header) + (AttributeFloats + (HasRestPose ? SegmentFloats : 0)) * sizeof(float);
+    if (FileSize < ExpectedSize)
+    {
+        return false;
+    }
+
+    Field.BladeCount = static_cast<std::size_t>(Header.BladeCount);
+    Field.Stride = Stride;
+    Field.SegmentCount = static_cast<int>(Header.SegmentCount);
+    Field.FlutterWeight = 1.0f;
+    Field.Storage.reset();
+    Field.Mapping = Mapping;
+
+    float* Attributes = reinterpret_cast<float*>(static_cast<char*>(Mapping.get()) + sizeof(Header));
+    Field.bindAttributes(Attributes);
+    if (HasRestPose)
+    {
+        Field.bindSegments(Attributes + AttributeFloats);
+    }
+    else
+    {
+        Field.Storage.reset(static_cast<float*>(::operator new[](SegmentFloats * sizeof(float), std::align_val_t{ GrassArrayAlignment })));
+        std::fill(Field.Storage.get(), Field.Storage.get() + SegmentFloats, 0.0f);
+        Field.bindSegments(Field.Storage.get());
+        std::copy(Field.BaseX, Field.BaseX + Stride, Field.segmentRowX(0));
+        std::copy(Field.BaseY, Field.BaseY + Stride, Field.segmentRowY(0));
+    }
+    return true;
+}
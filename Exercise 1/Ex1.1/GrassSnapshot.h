@@ -0,0 +1,42 @@
+#pragma once
+
+#include "GrassField.h"
+
+#include <cstdint>
+#include <string>
+
+// Binary grass field file, version 1. Little-endian, native float layout:
+//   GrassSnapshotHeader (64 bytes)
+//   Attribute block: BaseX, BaseY, LengthVariance, PhaseOffset, FrequencyVariance, WindOffset, Stride floats each
+//   Segment block (only with GrassSnapshotRestPose): SegmentX then SegmentY, (SegmentCount + 1) rows of Stride floats
+// Every block starts on a 64-byte boundary of the file, so once mapped the arrays are used in place with
+// the same alignment and padding as GrassField::allocate gives them.
+constexpr char GrassSnapshotMagic[8] = { 'G', 'R', 'A', 'S', 'S', 'F', 'L', 'D' };
+constexpr std::uint32_t GrassSnapshotVersion = 1;
+
+enum GrassSnapshotFlags : std::uint32_t
+{
+    GrassSnapshotRestPose = 1u << 0, // The segment block holds every blade standing straight up
+};
+
+struct GrassSnapshotHeader
+{
+    char Magic[8];
+    std::uint32_t Version;
+    std::uint32_t Flags;
+    std::uint64_t BladeCount;
+    std::uint64_t Stride;
+    std::uint32_t SegmentCount;
+    std::uint32_t Reserved[7];
+};
+static_assert(sizeof(GrassSnapshotHeader) == GrassArrayAlignment, "Snapshot blocks must stay cache line aligned");
+
+// Writes Field to Path. WindOffset is stored as zeros since it is rewritten every frame. Returns false
+// if the file could not be written.
+bool saveGrassSnapshot(const GrassField& Field, const std::string& Path, bool IncludeRestPose = true);
+
+// Maps Path copy-on-write and points Field's arrays straight into it, without parsing any blades. Without
+// a stored rest pose only the segment rows are allocated, with row 0 set to the bases. Returns false and
+// leaves Field untouched if the file is missing, truncated, of another version or has more than
+// MaxGrassSegments segments per blade, so a corrupt header cannot ask for a huge allocation.
+bool loadGrassSnapshot(GrassField& Field, const std::string& Path);
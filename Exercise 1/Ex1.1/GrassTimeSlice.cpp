@@ -0,0 +1,198 @@
+#include "GrassTimeSlice.h"
+
+#include "WorkerPool.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Blades [Begin, End) solved this frame: slice Frame % Slices of the field's lane groups
+    void solveRange(const GrassField& Field, const GrassTimeSlice& Slice, std::size_t& Begin, std::size_t& End)
+    {
+        if (Slice.FullSolvesLeft > 0 || Slice.Slices <= 1)
+        {
+            Begin = 0;
+            End = Field.BladeCount;
+            return;
+        }
+        const std::size_t Groups = Field.Stride / GrassLaneWidth;
+        const std::size_t Slices = static_cast<std::size_t>(Slice.Slices);
+        const std::size_t Current = Slice.Frame % Slices;
+        Begin = std::min(Field.BladeCount, Current * Groups / Slices * GrassLaneWidth);
+        End = std::min(Field.BladeCount, (Current + 1) * Groups / Slices * GrassLaneWidth);
+    }
+
+    // How far along the line through its last two solved poses a group is drawn at Time: 0 at the last
+    // solve, 1 once it is as far past it as the gap between the two, where it stops
+    float extrapolationWeight(const GrassTimeSlice& Slice, const std::size_t Group, const float Time)
+    {
+        const float Span = Slice.SolvedTime[Group] - Slice.PreviousTime[Group];
+        return Span > 0.0f ? std::clamp((Time - Slice.SolvedTime[Group]) / Span, 0.0f, 1.0f) : 0.0f;
+    }
+
+    // Writes the extrapolated pose of blades [Begin, End) at Time into the field
+    void extrapolateRange(GrassField& Field, const GrassTimeSlice& Slice, const float Time, const std::size_t Begin, const std::size_t End)
+    {
+        for (std::size_t GroupBegin = Begin; GroupBegin < End; )
+        {
+            const std::size_t Group = GroupBegin / GrassLaneWidth;
+            const std::size_t GroupEnd = std::min(End, (Group + 1) * GrassLaneWidth);
+            const float Weight = extrapolationWeight(Slice, Group, Time);
+            for (int Segment = 1; Segment <= Field.SegmentCount; ++Segment)
+            {
+                const std::size_t Row = static_cast<std::size_t>(Segment - 1) * Field.Stride;
+                const float* SolvedX = Slice.SolvedX.data() + Row;
+                const float* SolvedY = Slice.SolvedY.data() + Row;
+                const float* PreviousX = Slice.PreviousX.data() + Row;
+                const float* PreviousY = Slice.PreviousY.data() + Row;
+                float* X = Field.segmentRowX(Segment);
+                float* Y = Field.segmentRowY(Segment);
+                for (std::size_t Blade = GroupBegin; Blade < GroupEnd; ++Blade)
+                {
+                    X[Blade] = SolvedX[Blade] + (SolvedX[Blade] - PreviousX[Blade]) * Weight;
+                    Y[Blade] = SolvedY[Blade] + (SolvedY[Blade] - PreviousY[Blade]) * Weight;
+                }
+            }
+            GroupBegin = GroupEnd;
+        }
+    }
+
+    // Solves blades [Begin, End), which start on a lane group, exactly; records each one's tip error against
+    // the pose it would have been extrapolated to and shifts the exact pose into the solved history
+    void solveBlades(GrassField& Field, GrassTimeSlice& Slice, const float Time, const GrassUpdateKernel Kernel,
+        const GrassWindField* Wind, const std::size_t Begin, const std::size_t End)
+    {
+        if (Wind)
+        {
+            sampleWindRange(*Wind, Field, Begin, End);
+        }
+        Kernel(Field, Time, Begin, End);
+
+        const int Tip = Field.SegmentCount;
+        const std::size_t TipRow = static_cast<std::size_t>(Tip - 1) * Field.Stride;
+        const bool Measure = Slice.FullSolvesLeft == 0;
+        for (std::size_t GroupBegin = Begin; GroupBegin < End; GroupBegin += GrassLaneWidth)
+        {
+            const std::size_t Group = GroupBegin / GrassLaneWidth;
+            const std::size_t GroupEnd = std::min(End, GroupBegin + GrassLaneWidth);
+            const float Weight = extrapolationWeight(Slice, Group, Time);
+            for (std::size_t Blade = GroupBegin; Blade < GroupEnd; ++Blade)
+            {
+                const float PredictedX = Slice.SolvedX[TipRow + Blade] + (Slice.SolvedX[TipRow + Blade] - Slice.PreviousX[TipRow + Blade]) * Weight;
+                const float PredictedY = Slice.SolvedY[TipRow + Blade] + (Slice.SolvedY[TipRow + Blade] - Slice.PreviousY[TipRow + Blade]) * Weight;
+                Slice.TipError[Blade] = Measure ? std::hypot(Field.segmentRowX(Tip)[Blade] - PredictedX, Field.segmentRowY(Tip)[Blade] - PredictedY) : 0.0f;
+            }
+            Slice.PreviousTime[Group] = Slice.SolvedTime[Group];
+            Slice.SolvedTime[Group] = Time;
+        }
+
+        for (int Segment = 1; Segment <= Field.SegmentCount; ++Segment)
+        {
+            const std::size_t Row = static_cast<std::size_t>(Segment - 1) * Field.Stride;
+            std::copy(Slice.SolvedX.begin() + Row + Begin, Slice.SolvedX.begin() + Row + End, Slice.PreviousX.begin() + Row + Begin);
+            std::copy(Slice.SolvedY.begin() + Row + Begin, Slice.SolvedY.begin() + Row + End, Slice.PreviousY.begin() + Row + Begin);
+            std::copy(Field.segmentRowX(Segment) + Begin, Field.segmentRowX(Segment) + End, Slice.SolvedX.begin() + Row + Begin);
+            std::copy(Field.segmentRowY(Segment) + Begin, Field.segmentRowY(Segment) + End, Slice.SolvedY.begin() + Row + Begin);
+        }
+    }
+
+    // Blades [Begin, End) of this frame: the part inside the solve range is solved, the rest extrapolated
+    void updateRange(GrassField& Field, GrassTimeSlice& Slice, const float Time, const GrassUpdateKernel Kernel, const GrassWindField* Wind,
+        const std::size_t SolveBegin, const std::size_t SolveEnd, const std::size_t Begin, const std::size_t End)
+    {
+        const std::size_t SolvedBegin = std::clamp(SolveBegin, Begin, End);
+        const std::size_t SolvedEnd = std::clamp(SolveEnd, SolvedBegin, End);
+        extrapolateRange(Field, Slice, Time, Begin, SolvedBegin);
+        if (SolvedBegin < SolvedEnd)
+        {
+            solveBlades(Field, Slice, Time, Kernel, Wind, SolvedBegin, SolvedEnd);
+        }
+        extrapolateRange(Field, Slice, Time, SolvedEnd, End);
+    }
+
+    // Gathers the frame's statistics from the tip errors of the solved blades and advances the round robin
+    void finishFrame(const GrassField& Field, GrassTimeSlice& Slice, const std::size_t SolveBegin, const std::size_t SolveEnd)
+    {
+        GrassTimeSliceStats Stats;
+        Stats.Blades = Field.BladeCount;
+        Stats.Solved = SolveEnd - SolveBegin;
+        if (Slice.FullSolvesLeft == 0)
+        {
+            Stats.Measured = Stats.Solved;
+            for (std::size_t Blade = SolveBegin; Blade < SolveEnd; ++Blade)
+            {
+                Stats.TipErrorSum += Slice.TipError[Blade];
+                Stats.MaxTipError = std::max(Stats.MaxTipError, Slice.TipError[Blade]);
+            }
+        }
+        Slice.LastStats = Stats;
+
+        if (Slice.FullSolvesLeft > 0)
+        {
+            --Slice.FullSolvesLeft;
+        }
+        else
+        {
+            ++Slice.Frame;
+        }
+    }
+}
+
+void GrassTimeSliceStats::add(const GrassTimeSliceStats& Other)
+{
+    Blades += Other.Blades;
+    Solved += Other.Solved;
+    Measured += Other.Measured;
+    TipErrorSum += Other.TipErrorSum;
+    MaxTipError = std::max(MaxTipError, Other.MaxTipError);
+}
+
+void resetGrassTimeSlice(GrassTimeSlice& Slice, const GrassField& Field, const int Slices)
+{
+    const std::size_t RowFloats = static_cast<std::size_t>(Field.SegmentCount) * Field.Stride;
+    Slice.Slices = std::max(1, Slices);
+    Slice.Frame = 0;
+    Slice.FullSolvesLeft = 2;
+    Slice.SolvedX.assign(RowFloats, 0.0f);
+    Slice.SolvedY.assign(RowFloats, 0.0f);
+    Slice.PreviousX.assign(RowFloats, 0.0f);
+    Slice.PreviousY.assign(RowFloats, 0.0f);
+    Slice.SolvedTime.assign(Field.Stride / GrassLaneWidth, 0.0f);
+    Slice.PreviousTime.assign(Field.Stride / GrassLaneWidth, 0.0f);
+    Slice.TipError.assign(Field.Stride, 0.0f);
+    Slice.LastStats = GrassTimeSliceStats();
+}
+
+void updateGrassTimeSliced(GrassField& Field, GrassTimeSlice& Slice, const float Time, const GrassUpdateKernel Kernel,
+    const GrassWindField* Wind)
+{
+    Field.FlutterWeight = Wind ? Wind->Settings.FlutterWeight : 1.0f;
+    std::size_t SolveBegin = 0;
+    std::size_t SolveEnd = 0;
+    solveRange(Field, Slice, SolveBegin, SolveEnd);
+    updateRange(Field, Slice, Time, Kernel, Wind, SolveBegin, SolveEnd, 0, Field.BladeCount);
+    finishFrame(Field, Slice, SolveBegin, SolveEnd);
+}
+
+void updateGrassTimeSliced(GrassField& Field, GrassTimeSlice& Slice, const float Time, const GrassIsa Isa, WorkerPool& Pool,
+    const GrassSegmentBuilder Builder, const GrassWindField* Wind)
+{
+    const GrassUpdateKernel Kernel = grassUpdateKernel(Isa, Builder);
+    Field.FlutterWeight = Wind ? Wind->Settings.FlutterWeight : 1.0f;
+    std::size_t SolveBegin = 0;
+    std::size_t SolveEnd = 0;
+    solveRange(Field, Slice, SolveBegin, SolveEnd);
+
+    // The solved slice is split on its own, since its blades cost far more than extrapolated ones
+    Pool.parallelFor(SolveEnd - SolveBegin, GrassLaneWidth, [&](const std::size_t Begin, const std::size_t End)
+    {
+        solveBlades(Field, Slice, Time, Kernel, Wind, SolveBegin + Begin, SolveBegin + End);
+    });
+    Pool.parallelFor(Field.BladeCount, GrassLaneWidth, [&](const std::size_t Begin, const std::size_t End)
+    {
+        extrapolateRange(Field, Slice, Time, Begin, std::clamp(SolveBegin, Begin, End));
+        extrapolateRange(Field, Slice, Time, std::clamp(SolveEnd, Begin, End), End);
+    });
+    finishFrame(Field, Slice, SolveBegin, SolveEnd);
+}
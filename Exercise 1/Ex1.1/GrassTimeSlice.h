@@ -0,0 +1,61 @@
+#pragma once
+
+#include "GrassField.h"
+#include "GrassSimd.h"
+#include "GrassWind.h"
+
+#include <cstddef>
+#include <vector>
+
+class WorkerPool;
+
+// One frame (or a run of frames) of the amortised update. The error of the approximation is measured on
+// each blade at the moment it is solved again, when it is at its stalest: the distance from the tip it
+// was about to be drawn with to the exact tip.
+struct GrassTimeSliceStats
+{
+    std::size_t Blades = 0;   // Blade updates, solved or extrapolated
+    std::size_t Solved = 0;   // Blade updates that ran the full kernel
+    std::size_t Measured = 0; // Solves that replaced an extrapolated pose and so measured its error
+    double TipErrorSum = 0.0;
+    float MaxTipError = 0.0f;
+
+    float solvedFraction() const { return Blades > 0 ? static_cast<float>(Solved) / static_cast<float>(Blades) : 1.0f; }
+    double meanTipError() const { return Measured > 0 ? TipErrorSum / static_cast<double>(Measured) : 0.0; }
+    void add(const GrassTimeSliceStats& Other);
+};
+
+// Amortised update state of one field. Each frame only one of Slices contiguous, lane-aligned groups of
+// blades gets the full kernel solve, round-robin, and every other blade is extrapolated along the line
+// through its last two solved poses, never further ahead than the gap between them. Slices may change
+// from frame to frame; 1 solves every blade every frame.
+struct GrassTimeSlice
+{
+    int Slices = 1;
+    unsigned Frame = 0;
+    int FullSolvesLeft = 2; // Every blade is solved twice up front so it has two poses to extrapolate from
+
+    // Last two solved poses, SegmentCount rows of Stride floats (the base row never moves and is left out)
+    std::vector<float> SolvedX;
+    std::vector<float> SolvedY;
+    std::vector<float> PreviousX;
+    std::vector<float> PreviousY;
+    // Solve times per lane group: slices are whole groups, so every blade of a group is solved together
+    std::vector<float> SolvedTime;
+    std::vector<float> PreviousTime;
+    std::vector<float> TipError; // Per blade, of the blades solved this frame
+
+    GrassTimeSliceStats LastStats; // Of the last update
+};
+
+// Sizes the state for Field, so the next update solves every blade
+void resetGrassTimeSlice(GrassTimeSlice& Slice, const GrassField& Field, int Slices);
+
+// One frame of the amortised update of Field on the calling thread. With a wind field, only the blades
+// being solved sample it.
+void updateGrassTimeSliced(GrassField& Field, GrassTimeSlice& Slice, float Time, GrassUpdateKernel Kernel,
+    const GrassWindField* Wind = nullptr);
+
+// Same, split across the pool in lane-aligned chunks
+void updateGrassTimeSliced(GrassField& Field, GrassTimeSlice& Slice, float Time, GrassIsa Isa, WorkerPool& Pool,
+    GrassSegmentBuilder Builder = GrassSegmentBuilder::Direct, const GrassWindField* Wind = nullptr);
@@ -0,0 +1,122 @@
+#include "GrassWind.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Random value in [-1, 1] for an integer lattice point
+    float latticeValue(const int X, const int Y)
+    {
+        unsigned Hash = static_cast<unsigned>(X) * 0x8DA6B343u ^ static_cast<unsigned>(Y) * 0xD8163841u;
+        Hash = (Hash ^ (Hash >> 15)) * 0x2C1B3C6Du;
+        Hash = (Hash ^ (Hash >> 12)) * 0x297A2D39u;
+        Hash ^= Hash >> 15;
+        return static_cast<float>(Hash & 0xFFFFFF) / static_cast<float>(0x7FFFFF) - 1.0f;
+    }
+
+    float smoothStep(const float T)
+    {
+        return T * T * (3.0f - 2.0f * T);
+    }
+
+    float valueNoise(const float X, const float Y)
+    {
+        const float FloorX = std::floor(X);
+        const float FloorY = std::floor(Y);
+        const int IX = static_cast<int>(FloorX);
+        const int IY = static_cast<int>(FloorY);
+        const float TX = smoothStep(X - FloorX);
+        const float TY = smoothStep(Y - FloorY);
+
+        const float Top = latticeValue(IX, IY) + (latticeValue(IX + 1, IY) - latticeValue(IX, IY)) * TX;
+        const float Bottom = latticeValue(IX, IY + 1) + (latticeValue(IX + 1, IY + 1) - latticeValue(IX, IY + 1)) * TX;
+        return Top + (Bottom - Top) * TY;
+    }
+
+    float evaluateWind(const GrassWindSettings& Settings, const float X, const float Y, const float Time)
+    {
+        // Two octaves of noise scrolling with the wind
+        const float NoiseX = (X - Settings.NoiseVelocity.x * Time) / Settings.NoiseFeatureSize;
+        const float NoiseY = (Y - Settings.NoiseVelocity.y * Time) / Settings.NoiseFeatureSize;
+        const float Noise = 0.67f * valueNoise(NoiseX, NoiseY) + 0.33f * valueNoise(NoiseX * 2.7f + 17.0f, NoiseY * 2.7f);
+
+        // Periodic gust fronts with a Gaussian profile, travelling along +x
+        const float Phase = (X - Settings.GustSpeed * Time) / Settings.GustSpacing;
+        const float Distance = (Phase - std::floor(Phase) - 0.5f) * Settings.GustSpacing / Settings.GustWidth;
+        const float Gust = std::exp(-Distance * Distance);
+
+        return Settings.NoiseStrength * Noise + Settings.GustStrength * Gust;
+    }
+}
+
+void updateWindField(GrassWindField& Wind, const sf::FloatRect& Bounds, const float Time)
+{
+    // Snap the grid to whole cells so panning does not make the sampled wind shimmer
+    const float Cell = Wind.Settings.CellSize;
+    const float Left = std::floor(Bounds.left / Cell) * Cell;
+    const float Top = std::floor(Bounds.top / Cell) * Cell;
+    Wind.Origin = sf::Vector2f(Left, Top);
+    Wind.Columns = std::max(2, static_cast<int>(std::ceil((Bounds.left + Bounds.width - Left) / Cell)) + 1);
+    Wind.Rows = std::max(2, static_cast<int>(std::ceil((Bounds.top + Bounds.height - Top) / Cell)) + 1);
+    Wind.Values.resize(static_cast<std::size_t>(Wind.Columns) * static_cast<std::size_t>(Wind.Rows));
+
+    for (int Row = 0; Row < Wind.Rows; ++Row)
+    {
+        const float Y = Top + static_cast<float>(Row) * Cell;
+        for (int Column = 0; Column < Wind.Columns; ++Column)
+        {
+            const float X = Left + static_cast<float>(Column) * Cell;
+            Wind.Values[static_cast<std::size_t>(Row) * Wind.Columns + Column] = evaluateWind(Wind.Settings, X, Y, Time);
+        }
+    }
+}
+
+namespace
+{
+    // Bilinear lookup with the per-grid constants hoisted out of the blade loop
+    struct WindSampler
+    {
+        const float* Values;
+        std::size_t Columns;
+        float OriginX, OriginY, InvCell, MaxX, MaxY;
+        int LastColumn, LastRow; // Last top-left cell of a bilinear quad, so the +1 neighbours stay on the grid
+
+        explicit WindSampler(const GrassWindField& Wind)
+            : Values(Wind.Values.data()), Columns(static_cast<std::size_t>(Wind.Columns)), OriginX(Wind.Origin.x), OriginY(Wind.Origin.y),
+            InvCell(1.0f / Wind.Settings.CellSize), MaxX(static_cast<float>(Wind.Columns - 1)), MaxY(static_cast<float>(Wind.Rows - 1)),
+            LastColumn(Wind.Columns - 2), LastRow(Wind.Rows - 2)
+        {
+        }
+
+        float operator()(const float X, const float Y) const
+        {
+            const float GridX = std::clamp((X - OriginX) * InvCell, 0.0f, MaxX);
+            const float GridY = std::clamp((Y - OriginY) * InvCell, 0.0f, MaxY);
+            const int Column = std::min(static_cast<int>(GridX), LastColumn);
+            const int Row = std::min(static_cast<int>(GridY), LastRow);
+            const float TX = GridX - static_cast<float>(Column);
+            const float TY = GridY - static_cast<float>(Row);
+
+            const float* Top = Values + static_cast<std::size_t>(Row) * Columns + Column;
+            const float* Bottom = Top + Columns;
+            const float Upper = Top[0] + (Top[1] - Top[0]) * TX;
+            const float Lower = Bottom[0] + (Bottom[1] - Bottom[0]) * TX;
+            return Upper + (Lower - Upper) * TY;
+        }
+    };
+}
+
+float sampleWind(const GrassWindField& Wind, const float X, const float Y)
+{
+    return WindSampler(Wind)(X, Y);
+}
+
+void sampleWindRange(const GrassWindField& Wind, GrassField& Field, const std::size_t Begin, const std::size_t End)
+{
+    const WindSampler Sample(Wind);
+    for (std::size_t Blade = Begin; Blade < End; ++Blade)
+    {
+        Field.WindOffset[Blade] = Sample(Field.BaseX[Blade], Field.BaseY[Blade]);
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "GrassField.h"
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <vector>
+
+struct GrassWindSettings
+{
+    float CellSize = 64.0f;                        // Grid spacing in world units
+    float NoiseFeatureSize = 500.0f;               // World units between value noise lattice points
+    sf::Vector2f NoiseVelocity{ 220.0f, 0.0f };    // Scroll speed of the noise in world units per second
+    float NoiseStrength = 0.45f;
+    float GustSpeed = 380.0f;                      // Gust fronts travel along +x at this speed
+    float GustSpacing = 2600.0f;                   // Distance between consecutive gust fronts
+    float GustWidth = 260.0f;
+    float GustStrength = 0.75f;
+    float FlutterWeight = 0.3f;                    // Share of each blade's own oscillation kept on top of the wind
+};
+
+// Wind strength on a coarse grid, re-evaluated once per frame over the simulated area. Blades only do a
+// bilinear lookup, so the cost of evaluating noise and gusts depends on the area and not on blade density.
+// Values are signed sway offsets in roughly [-1, 1.2], positive leaning blades towards +x.
+struct GrassWindField
+{
+    GrassWindSettings Settings;
+    sf::Vector2f Origin;
+    int Columns = 0;
+    int Rows = 0;
+    std::vector<float> Values; // Row-major, Columns * Rows
+};
+
+// Re-evaluates the grid so it covers Bounds at the given time. The grid is always at least 2 x 2.
+void updateWindField(GrassWindField& Wind, const sf::FloatRect& Bounds, float Time);
+
+// Bilinear lookup, clamped to the grid edges. Needs a grid filled in by updateWindField.
+float sampleWind(const GrassWindField& Wind, float X, float Y);
+
+// Writes the wind at every base of blades [Begin, End) into the field's WindOffset array
+void sampleWindRange(const GrassWindField& Wind, GrassField& Field, std::size_t Begin, std::size_t End);
@@ -0,0 +1,67 @@
+#include "GrassWorkerPool.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+
+void updateGrass(GrassField& Field, const float Time, const GrassIsa Isa, WorkerPool& Pool, const GrassSegmentBuilder Builder,
+    const GrassWindField* Wind)
+{
+    const GrassUpdateKernel Kernel = grassUpdateKernel(Isa, Builder);
+    Field.FlutterWeight = Wind ? Wind->Settings.FlutterWeight : 1.0f;
+    Pool.parallelFor(Field.BladeCount, GrassLaneWidth, [&](const std::size_t Begin, const std::size_t End)
+    {
+        if (Wind)
+        {
+            sampleWindRange(*Wind, Field, Begin, End);
+        }
+        Kernel(Field, Time, Begin, End);
+    });
+}
+
+void printGrassScalingReport(const std::size_t NumBlades, const GrassIsa Isa, const unsigned MaxThreads)
+{
+    constexpr int Iterations = 50;
+
+    GrassField Field;
+    initializeGrass(Field, NumBlades, 1600.0f, 900.0f);
+
+    std::cout << "Grass scaling report: " << NumBlades << " blades, " << grassIsaName(Isa) << " kernel" << std::endl;
+    std::cout << "threads   ms/update   speedup   efficiency   steals/update   busy" << std::endl;
+
+    double SingleThreadMs = 0.0;
+    for (unsigned Threads = 1; Threads <= MaxThreads; ++Threads)
+    {
+        WorkerPool Pool(Threads);
+        updateGrass(Field, 0.0f, Isa, Pool); // Warm up caches and wake the workers once
+        Pool.resetStats();
+
+        const auto Start = std::chrono::steady_clock::now();
+        for (int I = 0; I < Iterations; ++I)
+        {
+            updateGrass(Field, static_cast<float>(I) * 0.016f, Isa, Pool);
+        }
+        const double Ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count() / Iterations;
+        if (Threads == 1)
+        {
+            SingleThreadMs = Ms;
+        }
+
+        // Steals show how unevenly the chunks finished; busy is the mean share of wall time spent in tasks
+        std::uint64_t Steals = 0;
+        double Utilization = 0.0;
+        for (unsigned Thread = 0; Thread < Threads; ++Thread)
+        {
+            const WorkerPool::WorkerStats Stats = Pool.workerStats(Thread);
+            Steals += Stats.Steals;
+            Utilization += Stats.Utilization / Threads;
+        }
+
+        const double Speedup = SingleThreadMs / Ms;
+        std::cout << std::setw(7) << Threads << std::fixed << std::setprecision(3)
+            << std::setw(12) << Ms << std::setw(10) << Speedup << std::setw(13) << Speedup / Threads
+            << std::setprecision(1) << std::setw(16) << static_cast<double>(Steals) / Iterations
+            << std::setw(6) << Utilization * 100.0 << '%' << std::endl;
+    }
+}
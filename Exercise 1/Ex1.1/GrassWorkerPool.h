@@ -0,0 +1,17 @@
+#pragma once
+
+#include "GrassSimd.h"
+#include "GrassWind.h"
+#include "WorkerPool.h"
+
+#include <cstddef>
+
+// Updates the whole field with the given kernel, split across the pool. Chunks are whole multiples of
+// GrassLaneWidth blades, so every chunk writes whole 64-byte lines of each segment row and no two
+// threads ever share a cache line. With a wind field, each chunk samples the wind at its own blade bases
+// right before updating them, while the data is still in cache.
+void updateGrass(GrassField& Field, float Time, GrassIsa Isa, WorkerPool& Pool,
+    GrassSegmentBuilder Builder = GrassSegmentBuilder::Direct, const GrassWindField* Wind = nullptr);
+
+// Times the update at every thread count from 1 to MaxThreads and prints one line per count
+void printGrassScalingReport(std::size_t NumBlades, GrassIsa Isa, unsigned MaxThreads);
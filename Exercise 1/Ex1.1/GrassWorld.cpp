@@ -0,0 +1,155 @@
+#include "GrassWorld.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // SplitMix64 finaliser, so neighbouring chunk indices get unrelated seeds
+    unsigned chunkSeed(const unsigned WorldSeed, const long long Index)
+    {
+        unsigned long long Value = (static_cast<unsigned long long>(WorldSeed) << 32) ^ static_cast<unsigned long long>(Index);
+        Value += 0x9E3779B97F4A7C15ull;
+        Value = (Value ^ (Value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        Value = (Value ^ (Value >> 27)) * 0x94D049BB133111EBull;
+        return static_cast<unsigned>(Value ^ (Value >> 31));
+    }
+}
+
+GrassWorld::GrassWorld(const GrassWorldSettings& Settings)
+    : Settings(Settings)
+{
+}
+
+void GrassWorld::setView(const sf::FloatRect& ViewBounds)
+{
+    VisibleBounds = ViewBounds;
+    const float Left = ViewBounds.left - Settings.Margin;
+    const float Right = ViewBounds.left + ViewBounds.width + Settings.Margin;
+    const long long First = std::max(0LL, static_cast<long long>(std::floor(Left / Settings.ChunkWidth)));
+    const long long Last = std::min(Settings.ChunkCount - 1, static_cast<long long>(std::floor(Right / Settings.ChunkWidth)));
+
+    ActiveChunks.clear();
+    ActiveFields.clear();
+    ActiveDrawItems.clear();
+    for (long long Index = First; Index <= Last; ++Index)
+    {
+        GrassChunk& Chunk = acquireChunk(Index);
+        ActiveChunks.push_back(&Chunk);
+        ActiveFields.push_back(&Chunk.Field);
+        ActiveDrawItems.push_back(GrassDrawItem{ &Chunk.Field, &Chunk.LodLevel, Chunk.BladeLength });
+    }
+
+    const float ActiveLeft = static_cast<float>(First) * Settings.ChunkWidth;
+    ActiveBounds = sf::FloatRect(ActiveLeft, ViewBounds.top, static_cast<float>(Last + 1) * Settings.ChunkWidth - ActiveLeft, ViewBounds.height);
+
+    evictChunks();
+}
+
+void GrassWorld::update(const float Time, const GrassIsa Isa, WorkerPool& Pool, const GrassSegmentBuilder Builder,
+    const GrassWindField* Wind)
+{
+    const GrassUpdateKernel Kernel = grassUpdateKernel(Isa, Builder);
+    const bool TimeSliced = Settings.TimeSlices > 1;
+    ++Updates;
+    Pool.parallelFor(ActiveChunks.size(), 1, [&](const std::size_t Begin, const std::size_t End)
+    {
+        for (std::size_t I = Begin; I < End; ++I)
+        {
+            GrassChunk& Chunk = *ActiveChunks[I];
+            GrassField& Field = Chunk.Field;
+            if (TimeSliced)
+            {
+                // A new chunk has no poses yet, and one coming back into range has poses too old to extrapolate from
+                if (Chunk.TimeSlice.SolvedX.empty() || Chunk.LastUpdate + 1 != Updates)
+                {
+                    resetGrassTimeSlice(Chunk.TimeSlice, Field, 1);
+                }
+                Chunk.LastUpdate = Updates;
+                Chunk.TimeSlice.Slices = chunkTimeSlices(Chunk);
+                updateGrassTimeSliced(Field, Chunk.TimeSlice, Time, Kernel, Wind);
+                continue;
+            }
+
+            Field.FlutterWeight = Wind ? Wind->Settings.FlutterWeight : 1.0f;
+            if (Wind)
+            {
+                sampleWindRange(*Wind, Field, 0, Field.BladeCount);
+            }
+            Kernel(Field, Time, 0, Field.BladeCount);
+        }
+    });
+
+    TimeSliceStats = GrassTimeSliceStats();
+    VisibleTimeSliceStats = GrassTimeSliceStats();
+    if (TimeSliced)
+    {
+        for (const GrassChunk* Chunk : ActiveChunks)
+        {
+            TimeSliceStats.add(Chunk->TimeSlice.LastStats);
+            if (chunkOnScreen(*Chunk))
+            {
+                VisibleTimeSliceStats.add(Chunk->TimeSlice.LastStats);
+            }
+        }
+    }
+}
+
+bool GrassWorld::chunkOnScreen(const GrassChunk& Chunk) const
+{
+    const float Left = static_cast<float>(Chunk.Index) * Settings.ChunkWidth;
+    return Left < VisibleBounds.left + VisibleBounds.width && Left + Settings.ChunkWidth > VisibleBounds.left;
+}
+
+int GrassWorld::chunkTimeSlices(const GrassChunk& Chunk) const
+{
+    if (!chunkOnScreen(Chunk))
+    {
+        return Settings.TimeSlices;
+    }
+
+    // From 1 slice for the chunks at the centre of the view up to TimeSlices at its edges, by how far the
+    // chunk's nearest point is from the centre
+    const float HalfWidth = VisibleBounds.width * 0.5f;
+    const float Centre = (static_cast<float>(Chunk.Index) + 0.5f) * Settings.ChunkWidth;
+    const float Nearest = std::max(0.0f, std::abs(Centre - (VisibleBounds.left + HalfWidth)) - Settings.ChunkWidth * 0.5f);
+    const float Distance = std::min(Nearest / HalfWidth, 1.0f);
+    const int ByDistance = 1 + static_cast<int>(Distance * static_cast<float>(Settings.TimeSlices));
+
+    // Coarser detail hides more of the extrapolation error
+    const int ByDetail = 1 << Chunk.LodLevel;
+    return std::min(Settings.TimeSlices, std::max(ByDistance, ByDetail));
+}
+
+GrassChunk& GrassWorld::acquireChunk(const long long Index)
+{
+    const auto Found = Chunks.find(Index);
+    if (Found != Chunks.end())
+    {
+        RecentlyUsed.splice(RecentlyUsed.begin(), RecentlyUsed, Found->second.RecentPosition);
+        return *Found->second.Chunk;
+    }
+
+    auto Chunk = std::make_unique<GrassChunk>();
+    Chunk->Index = Index;
+    generateGrass(Chunk->Field, Settings.BladesPerChunk, static_cast<float>(Index) * Settings.ChunkWidth, Settings.ChunkWidth,
+        Settings.GroundY, Settings.Segments, chunkSeed(Settings.Seed, Index));
+    Chunk->BladeLength = grassLodBladeLength(Chunk->Field);
+    ++GeneratedChunks;
+
+    RecentlyUsed.push_front(Index);
+    GrassChunk& Result = *Chunk;
+    Chunks.emplace(Index, CacheEntry{ std::move(Chunk), RecentlyUsed.begin() });
+    return Result;
+}
+
+void GrassWorld::evictChunks()
+{
+    // Active chunks were all just moved to the front, so eviction from the back never touches them
+    const std::size_t Capacity = std::max(Settings.CacheCapacity, ActiveChunks.size());
+    while (Chunks.size() > Capacity)
+    {
+        Chunks.erase(RecentlyUsed.back());
+        RecentlyUsed.pop_back();
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "GrassField.h"
+#include "GrassLod.h"
+#include "GrassTimeSlice.h"
+#include "GrassWorkerPool.h"
+
+#include <SFML/Graphics/Rect.hpp>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+struct GrassWorldSettings
+{
+    long long ChunkCount = 4000;          // World width in chunks
+    float ChunkWidth = 400.0f;            // World units per chunk
+    std::size_t BladesPerChunk = 125;     // Same density as the single-screen field (500 blades per 1600px)
+    int Segments = GrassSegments;
+    float GroundY = 900.0f;
+    unsigned Seed = 1;
+    float Margin = 200.0f;                // Chunks this close to the view are also kept active
+    std::size_t CacheCapacity = 256;      // Resident chunks kept after leaving the view
+    int TimeSlices = 1;                   // Most slices a chunk's update is spread over, 1 solves every blade every frame
+};
+
+// A fixed-width strip of the world with its own generated field
+struct GrassChunk
+{
+    long long Index = 0;
+    GrassField Field;
+    int LodLevel = GrassLodFull; // Level the chunk was last drawn at
+    float BladeLength = 0.0f;    // Longest blade, measured once when the chunk is generated
+    GrassTimeSlice TimeSlice;    // Amortised update state, sized on first use
+    std::size_t LastUpdate = 0;  // World update that last advanced the chunk
+};
+
+// An arbitrarily wide field of grass split into chunks. Chunks are generated deterministically from the
+// world seed and their index when they first come near the view, and only those chunks are simulated and
+// drawn. Chunks that leave the view stay cached up to CacheCapacity and are evicted least recently used.
+class GrassWorld
+{
+public:
+    explicit GrassWorld(const GrassWorldSettings& Settings);
+
+    // Makes every chunk overlapping ViewBounds plus the margin resident and active
+    void setView(const sf::FloatRect& ViewBounds);
+
+    // Updates the active chunks only, one chunk per pool job. With a wind field, each chunk samples it
+    // right before its update. With TimeSlices above 1, each chunk's budget follows its importance on
+    // screen: chunks in the view get more slices the farther they are from the view's centre, and at
+    // least one per LOD level step, while chunks only active for the margin get TimeSlices.
+    void update(float Time, GrassIsa Isa, WorkerPool& Pool, GrassSegmentBuilder Builder = GrassSegmentBuilder::Direct,
+        const GrassWindField* Wind = nullptr);
+
+    const std::vector<const GrassField*>& activeFields() const { return ActiveFields; }
+    const std::vector<GrassDrawItem>& activeDrawItems() const { return ActiveDrawItems; }
+    const sf::FloatRect& activeBounds() const { return ActiveBounds; } // Area covered by the active chunks
+    const GrassTimeSliceStats& timeSliceStats() const { return TimeSliceStats; } // Of the last update
+    const GrassTimeSliceStats& visibleTimeSliceStats() const { return VisibleTimeSliceStats; } // Same, chunks in the view only
+    std::size_t residentChunkCount() const { return Chunks.size(); }
+    std::size_t generatedChunkCount() const { return GeneratedChunks; }
+    float width() const { return static_cast<float>(Settings.ChunkCount) * Settings.ChunkWidth; }
+    const GrassWorldSettings& settings() const { return Settings; }
+
+private:
+    struct CacheEntry
+    {
+        std::unique_ptr<GrassChunk> Chunk;
+        std::list<long long>::iterator RecentPosition;
+    };
+
+    GrassChunk& acquireChunk(long long Index);
+    bool chunkOnScreen(const GrassChunk& Chunk) const;
+    int chunkTimeSlices(const GrassChunk& Chunk) const;
+    void evictChunks();
+
+    GrassWorldSettings Settings;
+    std::unordered_map<long long, CacheEntry> Chunks;
+    std::list<long long> RecentlyUsed; // Front is the most recently used chunk
+    std::vector<GrassChunk*> ActiveChunks;
+    std::vector<const GrassField*> ActiveFields;
+    std::vector<GrassDrawItem> ActiveDrawItems;
+    sf::FloatRect ActiveBounds;
+    sf::FloatRect VisibleBounds;
+    std::size_t Updates = 0;
+    GrassTimeSliceStats TimeSliceStats;
+    GrassTimeSliceStats VisibleTimeSliceStats;
+    std::size_t GeneratedChunks = 0;
+};
@@ -1,115 +1,566 @@
-#include <chrono>
+#include "FrameAllocations.h"
+#include "FrameOverlay.h"
+#include "FramePipeline.h"
+#include "FrameProfiler.h"
+#include "GrassDisplacement.h"
+#include "GrassDynamics.h"
+#include "GrassField.h"
+#include "GrassOptions.h"
+#include "GrassPoseCache.h"
+#include "GrassRenderer.h"
+#include "GrassSimd.h"
+#include "GrassSnapshot.h"
+#include "GrassTimeSlice.h"
+#include "GrassWind.h"
+#include "GrassWorkerPool.h"
+#include "GrassWorld.h"
+#include "SoftwareRasterizer.h"
+
 #include <SFML/Graphics.hpp>
-#include <vector>
+#include <algorithm>
+#include <iostream>
 #include <cmath>
+#include <memory>
+#include <optional>
 #include <random>
+#include <sstream>
+#include <vector>
 
 constexpr int WindowWidth = 1600;
 constexpr int WindowHeight = 900;
-constexpr int NumGrassBlades = 500;
-constexpr int GrassSegments = 5;
-constexpr float BaseGrassLength = 150.0f;
-constexpr float WindSwayFrequencyBase = 0.2f;  
-constexpr float WindSwayAmplitude = 20.0f;
-constexpr float DampingFactor = 0.7f;  
-
-struct GrassBlade
+constexpr float CameraPanSpeed = 1200.0f; // World units per second at 1x zoom
+constexpr float MinCameraZoom = 0.25f;
+constexpr float MaxCameraZoom = 8.0f; // Far enough out for the coarsest grass detail level
+// Phases timed by the frame profiler
+enum FramePhase
 {
-    std::vector<sf::Vector2f> Segments;
-    float LengthVariance;
-    float PhaseOffset;
-    float FrequencyVariance;  
+    PhaseEvents,
+    PhaseUpdate,
+    PhaseBuild,
+    PhaseDraw,
+    PhaseDisplay
 };
 
-void initializeGrass(std::vector<GrassBlade>& GrassBlades)
+constexpr float ImpulseRadius = 250.0f;
+constexpr float ImpulseStrength = 4.0f; // Angular velocity in rad/s given to blades right under the cursor
+constexpr float CursorColliderRadius = 40.0f;
+constexpr float ColliderSpeed = 200.0f; // Pixels per second
+constexpr int ColliderOutlineSegments = 12;
+
+// Moving colliders bouncing around the window, plus the cursor as collider 0. Their outlines are double
+// buffered along with the grass for the pipelined loop.
+struct GrassColliders
 {
-    // Seed the random number generator with the current time for more randomness
-    std::default_random_engine Generator(static_cast<unsigned>(std::chrono::system_clock::now().time_since_epoch().count()));
-    std::uniform_real_distribution LengthDist(1.0f, 1.3f);
-    std::uniform_real_distribution PhaseDist(0.0f, 3.14f);
-    std::uniform_real_distribution XPosDist(0.0f, static_cast<float>(WindowWidth));
-    std::uniform_real_distribution FrequencyDist(0.8f, 1.2f);  // Variance for swaying frequency
+    std::vector<GrassCollider> Colliders;
+    std::vector<sf::Vector2f> Velocities;
+    sf::VertexArray Outlines[2]{ sf::VertexArray(sf::Lines), sf::VertexArray(sf::Lines) };
+};
 
-    for (auto& Blade : GrassBlades)
-    {
-        Blade.LengthVariance = LengthDist(Generator);
-        Blade.PhaseOffset = PhaseDist(Generator);
-        Blade.FrequencyVariance = FrequencyDist(Generator);
+void initializeColliders(GrassColliders& Swarm, const int Count, const unsigned Seed)
+{
+    std::mt19937 Generator(Seed);
+    std::uniform_real_distribution PositionX(0.0f, static_cast<float>(WindowWidth));
+    std::uniform_real_distribution PositionY(WindowHeight - BaseGrassLength * 1.5f, static_cast<float>(WindowHeight));
+    std::uniform_real_distribution Heading(0.0f, 6.2831853f);
 
-        // Initialize the position of the grass blades along the entire width of the window
-        const float StartX = XPosDist(Generator);
-        Blade.Segments.resize(GrassSegments + 1);
-        Blade.Segments[0] = sf::Vector2f(StartX, WindowHeight); // Grass blade base at bottom of the window
+    Swarm.Colliders.assign(1, GrassCollider{ sf::Vector2f(-1.0e6f, -1.0e6f), CursorColliderRadius });
+    Swarm.Velocities.assign(1, sf::Vector2f());
+    for (int I = 0; I < Count; ++I)
+    {
+        const float Angle = Heading(Generator);
+        Swarm.Colliders.push_back(GrassCollider{ sf::Vector2f(PositionX(Generator), PositionY(Generator)) });
+        Swarm.Velocities.emplace_back(std::cos(Angle) * ColliderSpeed, std::sin(Angle) * ColliderSpeed);
+    }
+    for (sf::VertexArray& Outlines : Swarm.Outlines)
+    {
+        Outlines.resize(static_cast<std::size_t>(Count) * ColliderOutlineSegments * 2);
     }
 }
 
-void updateGrass(std::vector<GrassBlade>& GrassBlades, const float Time)
+// Moves every collider but the cursor, bouncing off the window edges and the top of the grass
+void moveColliders(GrassColliders& Swarm, const float DeltaTime)
 {
-    for (auto& Blade : GrassBlades)
+    const float Top = WindowHeight - BaseGrassLength * 1.5f;
+    for (std::size_t I = 1; I < Swarm.Colliders.size(); ++I)
     {
-        // Adjust the frequency based on a variance to make blades move uniquely
-        const float EffectiveFrequency = WindSwayFrequencyBase * Blade.FrequencyVariance;
-        const float Sway = std::sin(Time * EffectiveFrequency + Blade.PhaseOffset) * WindSwayAmplitude * DampingFactor;
-
-        for (int I = 1; I <= GrassSegments; ++I)
+        sf::Vector2f& Position = Swarm.Colliders[I].Position;
+        sf::Vector2f& Velocity = Swarm.Velocities[I];
+        Position += Velocity * DeltaTime;
+        if ((Position.x < 0.0f && Velocity.x < 0.0f) || (Position.x > WindowWidth && Velocity.x > 0.0f))
         {
-            const float SegmentLength = BaseGrassLength * Blade.LengthVariance / GrassSegments;
-            const float Angle = Sway * (I / static_cast<float>(GrassSegments));
-            Blade.Segments[I] = Blade.Segments[I - 1] + sf::Vector2f(std::sin(Angle) * SegmentLength, -std::cos(Angle) * SegmentLength);
+            Velocity.x = -Velocity.x;
+        }
+        if ((Position.y < Top && Velocity.y < 0.0f) || (Position.y > WindowHeight && Velocity.y > 0.0f))
+        {
+            Velocity.y = -Velocity.y;
         }
     }
 }
 
-void renderGrass(sf::RenderWindow& Window, const std::vector<GrassBlade>& GrassBlades)
+// Rebuilds the outline of every moving collider into one of the outline buffers, as line segments
+void buildColliderOutlines(GrassColliders& Swarm, const int Buffer)
 {
-    for (const auto& Blade : GrassBlades)
+    sf::VertexArray& Outlines = Swarm.Outlines[Buffer];
+    std::size_t Vertex = 0;
+    for (std::size_t I = 1; I < Swarm.Colliders.size(); ++I)
     {
-        for (int I = 0; I < GrassSegments; ++I)
+        const GrassCollider& Collider = Swarm.Colliders[I];
+        for (int Segment = 0; Segment < ColliderOutlineSegments; ++Segment)
         {
-            const float Thickness = 3.0f - static_cast<float>(I) * 0.4f; // Thicker at the base, thinner towards the tip
-            sf::RectangleShape SegmentLine;
-            SegmentLine.setPosition(Blade.Segments[I]);
-            const sf::Vector2f Direction = Blade.Segments[I + 1] - Blade.Segments[I];
-            const float Length = std::sqrt(Direction.x * Direction.x + Direction.y * Direction.y);
-            SegmentLine.setSize(sf::Vector2f(Length, Thickness));
-            SegmentLine.setRotation(std::atan2(Direction.y, Direction.x) * 180.f / 3.14159265f);
-            SegmentLine.setFillColor(sf::Color(34, 139, 34));
-
-            Window.draw(SegmentLine);
+            for (const int Corner : { Segment, Segment + 1 })
+            {
+                const float Angle = 6.2831853f * static_cast<float>(Corner) / ColliderOutlineSegments;
+                Outlines[Vertex].position = Collider.Position + sf::Vector2f(std::cos(Angle), std::sin(Angle)) * Collider.Radius;
+                Outlines[Vertex++].color = sf::Color(120, 60, 20);
+            }
         }
     }
 }
 
-int main()
+// Pans with the arrow keys or A/D, or by dragging with the left mouse button, and zooms with the mouse
+// wheel. The view is kept inside the world horizontally and anchored to the ground vertically.
+struct GrassCamera
+{
+    sf::View View{ sf::FloatRect(0.0f, 0.0f, WindowWidth, WindowHeight) };
+    float Zoom = 1.0f;
+    bool Dragging = false;
+    sf::Vector2i DragStart;
+};
+
+void handleCameraEvent(GrassCamera& Camera, const sf::Event& Event)
+{
+    if (Event.type == sf::Event::MouseWheelScrolled)
+    {
+        Camera.Zoom = std::clamp(Camera.Zoom * (Event.mouseWheelScroll.delta > 0 ? 0.9f : 1.1f), MinCameraZoom, MaxCameraZoom);
+    }
+    else if (Event.type == sf::Event::MouseButtonPressed && Event.mouseButton.button == sf::Mouse::Left)
+    {
+        Camera.Dragging = true;
+        Camera.DragStart = sf::Vector2i(Event.mouseButton.x, Event.mouseButton.y);
+    }
+    else if (Event.type == sf::Event::MouseButtonReleased && Event.mouseButton.button == sf::Mouse::Left)
+    {
+        Camera.Dragging = false;
+    }
+    else if (Event.type == sf::Event::MouseMoved && Camera.Dragging)
+    {
+        Camera.View.move(static_cast<float>(Camera.DragStart.x - Event.mouseMove.x) * Camera.Zoom, 0.0f);
+        Camera.DragStart = sf::Vector2i(Event.mouseMove.x, Event.mouseMove.y);
+    }
+}
+
+// Horizontal pan from the arrow keys or A/D this frame, in world units
+float cameraPanInput(const GrassCamera& Camera, const float DeltaTime)
+{
+    float Pan = 0.0f;
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left) || sf::Keyboard::isKeyPressed(sf::Keyboard::A))
+    {
+        Pan -= CameraPanSpeed * Camera.Zoom * DeltaTime;
+    }
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right) || sf::Keyboard::isKeyPressed(sf::Keyboard::D))
+    {
+        Pan += CameraPanSpeed * Camera.Zoom * DeltaTime;
+    }
+    return Pan;
+}
+
+void updateCamera(GrassCamera& Camera, const float WorldWidth, const float Pan)
+{
+    const sf::Vector2f Size(WindowWidth * Camera.Zoom, WindowHeight * Camera.Zoom);
+    const float CenterX = std::clamp(Camera.View.getCenter().x + Pan, Size.x / 2.0f, std::max(Size.x / 2.0f, WorldWidth - Size.x / 2.0f));
+    Camera.View.setSize(Size);
+    Camera.View.setCenter(CenterX, WindowHeight - Size.y / 2.0f);
+}
+
+sf::FloatRect viewBounds(const sf::View& View)
+{
+    const sf::Vector2f Size = View.getSize();
+    return sf::FloatRect(View.getCenter() - Size / 2.0f, Size);
+}
+
+// Stand-in for the mouse with --software: sweeps back and forth through the grass
+sf::Vector2f scriptedCursor(const float Time)
+{
+    return sf::Vector2f(WindowWidth / 2.0f + std::sin(Time * 0.5f) * WindowWidth * 0.45f, WindowHeight - BaseGrassLength * 0.5f);
+}
+
+// Blades drawn at each level of detail and the share whose vertices were rewritten, shown in the window title
+std::string lodTitle(const GrassLodStats& Stats, const GrassRebuildStats& Rebuild)
 {
-    sf::RenderWindow Window(sf::VideoMode(WindowWidth, WindowHeight), "Ex 1.1: Grass Simulation", sf::Style::Close);
+    std::ostringstream Title;
+    Title << "Ex 1.1: Grass Simulation | LOD full " << Stats.Blades[GrassLodFull] << ", half " << Stats.Blades[GrassLodHalf]
+        << ", two " << Stats.Blades[GrassLodTwo] << ", triangle " << Stats.Blades[GrassLodTriangle]
+        << " | rebuilt " << static_cast<int>(Rebuild.fraction() * 100.0f + 0.5f) << "%";
+    return Title.str();
+}
+
+int main(int Argc, char* Argv[])
+{
+    const GrassOptions Options = parseGrassOptions(Argc, Argv);
+
+    // With --software the frames are drawn by the CPU rasterizer on the same pool, and no window is opened.
+    // Time advances a fixed 60 Hz step per frame, and the camera and cursor follow a scripted path.
+    const SoftwareRenderOptions Software = softwareRenderOptions(Argc, Argv);
+
+    WorkerPool Pool(Options.Threads);
+    if (Options.Scaling)
+    {
+        printGrassScalingReport(std::max<std::size_t>(Options.NumBlades, 100000), Options.Isa, Pool.threadCount());
+        return 0;
+    }
+
+    GrassField Field;
+    if (!Options.LoadPath.empty())
+    {
+        if (!loadGrassSnapshot(Field, Options.LoadPath))
+        {
+            std::cerr << "Could not load grass field from " << Options.LoadPath << std::endl;
+            return 1;
+        }
+    }
+    else if (Options.Seed)
+    {
+        generateGrass(Field, Options.NumBlades, 0.0f, static_cast<float>(WindowWidth), static_cast<float>(WindowHeight), Options.Segments, *Options.Seed);
+    }
+    else
+    {
+        initializeGrass(Field, Options.NumBlades, static_cast<float>(WindowWidth), static_cast<float>(WindowHeight), Options.Segments);
+    }
+
+    // Blade bases never move in the single-screen field, so the grid is built once up front. It reorders
+    // the blades, so it comes before anything else indexed by blade is set up, and before saving: a snapshot
+    // then holds its blades in grid order, and mapping it back only reads them to bucket them.
+    GrassBladeGrid BladeGrid;
+    const bool UseDisplacement = Options.WorldScreens == 0 && (Options.Displacement || Options.Colliders > 0);
+    if (UseDisplacement || !Options.SavePath.empty())
+    {
+        buildGrassBladeGrid(BladeGrid, Field);
+    }
+    if (!Options.SavePath.empty() && !saveGrassSnapshot(Field, Options.SavePath))
+    {
+        std::cerr << "Could not save grass field to " << Options.SavePath << std::endl;
+    }
+
+    // Report the chosen update path so it can be confirmed from the console
+    std::cout << "Grass update path: " << grassIsaName(Options.Isa) << (Options.Builder == GrassSegmentBuilder::Incremental ? " incremental" : "")
+        << " on " << Pool.threadCount() << " thread(s)" << std::endl;
+    GrassPoseCache PoseCache;
+    if (Options.PoseCacheSize > 0)
+    {
+        buildGrassPoseCache(PoseCache, Field.SegmentCount, Options.PoseCacheSize, Options.PoseCacheLerp);
+        std::cout << "Pose cache: " << PoseCache.PoseCount << " poses" << (PoseCache.Interpolate ? " interpolated" : " nearest")
+            << ", max deviation from exact update: " << grassPoseCacheMaxError(Field, PoseCache) << " px" << std::endl;
+    }
+    if (Options.Verify)
+    {
+        std::cout << "Max deviation from scalar path: " << grassKernelMaxError(Field, Options.Isa, Options.Builder) << " px" << std::endl;
+        return 0;
+    }
+
+    // Chunked world mode keeps the single-screen blade density but spreads it over many screens
+    std::unique_ptr<GrassWorld> World;
+    if (Options.WorldScreens > 0)
+    {
+        GrassWorldSettings Settings;
+        Settings.BladesPerChunk = std::max<std::size_t>(1, Options.NumBlades * static_cast<std::size_t>(Settings.ChunkWidth) / WindowWidth);
+        Settings.ChunkCount = Options.WorldScreens * WindowWidth / static_cast<long long>(Settings.ChunkWidth);
+        Settings.Segments = Options.Segments;
+        Settings.GroundY = static_cast<float>(WindowHeight);
+        Settings.Seed = Options.Seed.value_or(Settings.Seed);
+        Settings.TimeSlices = Options.TimeSlices;
+        World = std::make_unique<GrassWorld>(Settings);
+    }
+
+    std::optional<sf::RenderWindow> Window;
+    std::optional<SoftwareRasterizer> Rasterizer;
+    if (Software.enabled())
+    {
+        Rasterizer.emplace(WindowWidth, WindowHeight, Pool);
+    }
+    else
+    {
+        Window.emplace(sf::VideoMode(WindowWidth, WindowHeight), "Ex 1.1: Grass Simulation", sf::Style::Close);
+    }
+
+    GrassDisplacement Displacement;
+    GrassColliders Colliders;
+    if (UseDisplacement)
+    {
+        resetGrassDisplacement(Displacement, Field, BladeGrid);
+        initializeColliders(Colliders, Options.Colliders, Options.Seed.value_or(1));
+    }
+
+    // The spring-damper mode applies to the single-screen field only
+    GrassDynamics Dynamics;
+    const bool UseDynamics = Options.Dynamics && !World;
+    if (UseDynamics)
+    {
+        resetGrassDynamics(Dynamics, Field, 0.0f);
+    }
 
-    std::vector<GrassBlade> GrassBlades(NumGrassBlades);
-    initializeGrass(GrassBlades);
+    // --time-slice amortises the kinematic update of the single-screen field over that many frames; the
+    // world spreads it per chunk instead
+    GrassTimeSlice TimeSlice;
+    const bool UseTimeSlice = !World && !UseDynamics && Options.PoseCacheSize == 0 && Options.TimeSlices > 1;
+    if (UseTimeSlice)
+    {
+        resetGrassTimeSlice(TimeSlice, Field, Options.TimeSlices);
+    }
+    GrassTimeSliceStats RunTimeSliceStats; // Summed over every frame, for the report on exit
+    GrassTimeSliceStats RunVisibleTimeSliceStats;
 
+    // --pipelined simulates into one copy of the blade segments while the other is drawn. The copies share
+    // the blade attributes: only the simulation writes those, and drawing reads nothing but the bases.
+    FramePipeline Pipeline(Pool, Options.Pipelined && !World);
+    GrassField BackField;
+    GrassField* Fields[2] = { &Field, &Field };
+    if (Pipeline.pipelined())
+    {
+        BackField.shareAttributes(Field);
+        Fields[1] = &BackField;
+        std::cout << "Pipelined loop: frames show the simulation one step behind the input" << std::endl;
+    }
+
+    GrassWindField Wind;
+    const GrassWindField* WindInput = Options.Wind ? &Wind : nullptr;
+
+    GrassRenderer Renderer;
+    Renderer.Lod.Enabled = Options.Lod;
+    Renderer.Dirty.Enabled = Options.DirtyTracking;
+    Renderer.Dirty.Epsilon = Options.DirtyEpsilon;
+    GrassRebuildStats RunRebuildStats; // Summed over every frame, for the report on exit
+    GrassCamera Camera;
     sf::Clock Clock;
+    float PreviousTime = 0.0f;
+    float NextTitleTime = 0.0f;
 
-    while (Window.isOpen())
+    FrameProfiler Profiler({ "events", "update", "build", "draw", "display" });
+    FrameOverlay Overlay;
+    if (Window)
     {
-        sf::Event Event{};
-        while (Window.pollEvent(Event))
+        loadFrameOverlayFont(Overlay);
+    }
+    const std::string CsvPath = frameProfilerCsvPath(Argc, Argv);
+    if (!CsvPath.empty() && !Profiler.startCsv(CsvPath))
+    {
+        std::cerr << "Could not open " << CsvPath << " for frame timings" << std::endl;
+    }
+
+    // Every per-frame buffer is persistent and only grows to its high-water mark, so a frame with a still
+    // camera makes no heap allocations once warmed up
+    FrameAllocationCheck AllocationCheck;
+    sf::FloatRect PreviousView;
+    for (int Frame = 0; Window ? Window->isOpen() : Frame < Software.Frames; ++Frame)
+    {
+        Profiler.beginFrame();
+        AllocationCheck.beginFrame();
         {
-            if (Event.type == sf::Event::Closed)
+            const auto Timer = Profiler.scope(PhaseEvents);
+            sf::Event Event{};
+            while (Window && Window->pollEvent(Event))
             {
-                Window.close();
+                handleFrameOverlayEvent(Overlay, Event);
+                if (Event.type == sf::Event::Closed)
+                {
+                    Window->close();
+                }
+                else if (World)
+                {
+                    handleCameraEvent(Camera, Event);
+                }
+                else if (UseDynamics && Event.type == sf::Event::MouseButtonPressed && Event.mouseButton.button == sf::Mouse::Left)
+                {
+                    const sf::Vector2f Point = Window->mapPixelToCoords(sf::Vector2i(Event.mouseButton.x, Event.mouseButton.y));
+                    applyGrassImpulse(Dynamics, Field, Point, ImpulseRadius, ImpulseStrength);
+                }
             }
         }
 
-        float ElapsedTime = Clock.getElapsedTime().asSeconds();
+        float ElapsedTime = Window ? Clock.getElapsedTime().asSeconds() : static_cast<float>(Frame) / 60.0f;
+        const float DeltaTime = ElapsedTime - PreviousTime;
+        PreviousTime = ElapsedTime;
+
+        // Input is sampled here on the main thread; the step itself may run on a worker while the previous
+        // frame is drawn, so it only touches simulation state and the back buffers
+        float Pan = 0.0f;
+        if (World)
+        {
+            Pan = Window ? cameraPanInput(Camera, DeltaTime) : CameraPanSpeed * DeltaTime;
+        }
+        sf::Vector2f Cursor(-1.0e6f, -1.0e6f); // The cursor only pushes while it is over the window
+        if (UseDisplacement && Options.Displacement && !Window)
+        {
+            Cursor = scriptedCursor(ElapsedTime);
+        }
+        else if (UseDisplacement && Options.Displacement && Window->hasFocus())
+        {
+            const sf::Vector2i Mouse = sf::Mouse::getPosition(*Window);
+            if (Mouse.x >= 0 && Mouse.y >= 0 && Mouse.x < WindowWidth && Mouse.y < WindowHeight)
+            {
+                Cursor = Window->mapPixelToCoords(Mouse);
+            }
+        }
 
         // Update grass animation based on elapsed time
-        updateGrass(GrassBlades, ElapsedTime);
+        const int Back = Pipeline.back();
+        const auto Step = [&]
+        {
+            if (World)
+            {
+                if (WindInput)
+                {
+                    updateWindField(Wind, World->activeBounds(), ElapsedTime);
+                }
+                World->update(ElapsedTime, Options.Isa, Pool, Options.Builder, WindInput);
+                return;
+            }
+
+            GrassField& Target = *Fields[Back];
+            if (WindInput)
+            {
+                updateWindField(Wind, sf::FloatRect(0.0f, 0.0f, WindowWidth, WindowHeight), ElapsedTime);
+            }
+            if (UseDynamics)
+            {
+                advanceGrassDynamics(Dynamics, Target, DeltaTime, Options.Isa, Pool, WindInput);
+            }
+            else if (Options.PoseCacheSize > 0)
+            {
+                updateGrassCached(Target, ElapsedTime, PoseCache, Pool, WindInput);
+            }
+            else if (UseTimeSlice)
+            {
+                updateGrassTimeSliced(Target, TimeSlice, ElapsedTime, Options.Isa, Pool, Options.Builder, WindInput);
+            }
+            else
+            {
+                updateGrass(Target, ElapsedTime, Options.Isa, Pool, Options.Builder, WindInput);
+            }
+
+            if (UseDisplacement)
+            {
+                Colliders.Colliders[0].Position = Cursor;
+                moveColliders(Colliders, DeltaTime);
+                applyGrassDisplacement(Displacement, Target, BladeGrid, Colliders.Colliders, DeltaTime, Pool);
+                buildColliderOutlines(Colliders, Back);
+            }
+        };
+        {
+            const auto Timer = Profiler.scope(PhaseUpdate);
+            if (World)
+            {
+                updateCamera(Camera, World->width(), Pan);
+                const sf::FloatRect View = viewBounds(Camera.View);
+                if (View != PreviousView)
+                {
+                    // Panning and zooming generate chunks and can grow the active lists past their high-water mark
+                    AllocationCheck.allowAllocations();
+                    PreviousView = View;
+                }
+                World->setView(View);
+            }
+            Pipeline.launch(Step);
+        }
 
         // Render everything
-        Window.clear(sf::Color::Cyan);
-        renderGrass(Window, GrassBlades);
-        Window.display();
+        {
+            const auto Timer = Profiler.scope(PhaseBuild);
+            if (World && Window)
+            {
+                Window->setView(Camera.View);
+            }
+            else if (World)
+            {
+                Rasterizer->setView(Camera.View.getCenter(), Camera.View.getSize());
+            }
+            const float PixelsPerUnit = Window ? grassPixelsPerUnit(*Window) : WindowWidth / Rasterizer->viewSize().x;
+            if (World)
+            {
+                buildGrassVertices(Renderer, World->activeDrawItems(), PixelsPerUnit);
+            }
+            else
+            {
+                buildGrassVertices(Renderer, *Fields[Pipeline.front()], PixelsPerUnit);
+            }
+            RunRebuildStats.Blades += Renderer.RebuildStats.Blades;
+            RunRebuildStats.Rebuilt += Renderer.RebuildStats.Rebuilt;
+        }
+        {
+            const auto Timer = Profiler.scope(PhaseDraw);
+            if (Rasterizer)
+            {
+                Rasterizer->clear(sf::Color::Cyan);
+                Rasterizer->draw(Renderer.Vertices);
+                Rasterizer->draw(Colliders.Outlines[Pipeline.front()]);
+                Rasterizer->finish();
+            }
+            else
+            {
+                Window->clear(sf::Color::Cyan);
+                drawGrass(*Window, Renderer);
+                Window->draw(Colliders.Outlines[Pipeline.front()]);
+                if (Overlay.Visible)
+                {
+                    AllocationCheck.allowAllocations(); // The overlay text is rebuilt every frame
+                }
+                drawFrameOverlay(*Window, Overlay, Profiler);
+            }
+        }
+        {
+            const auto Timer = Profiler.scope(PhaseDisplay);
+            if (Window)
+            {
+                Window->display();
+            }
+        }
+        Pipeline.presented();
+        {
+            // Waiting here is the part of the step that drawing did not hide
+            const auto Timer = Profiler.scope(PhaseUpdate);
+            Pipeline.swap();
+        }
+        if (World)
+        {
+            RunTimeSliceStats.add(World->timeSliceStats());
+            RunVisibleTimeSliceStats.add(World->visibleTimeSliceStats());
+        }
+        else if (UseTimeSlice)
+        {
+            RunTimeSliceStats.add(TimeSlice.LastStats);
+        }
+        Profiler.endFrame();
+
+        if (Window && ElapsedTime >= NextTitleTime)
+        {
+            AllocationCheck.allowAllocations();
+            Window->setTitle(lodTitle(Renderer.LodStats, Renderer.RebuildStats));
+            NextTitleTime = ElapsedTime + 1.0f;
+        }
+        AllocationCheck.endFrame();
     }
 
+    printFramePipelineReport(Pipeline, std::cout);
+    std::cout << "Blades rebuilt per frame: " << RunRebuildStats.fraction() * 100.0f << "%" << std::endl;
+    if (RunTimeSliceStats.Blades > 0)
+    {
+        std::cout << "Time slicing: " << RunTimeSliceStats.solvedFraction() * 100.0f << "% of blade updates solved ("
+            << 1.0f / RunTimeSliceStats.solvedFraction() << "x fewer), tip error mean " << RunTimeSliceStats.meanTipError()
+            << " px, max " << RunTimeSliceStats.MaxTipError << " px" << std::endl;
+    }
+    if (RunVisibleTimeSliceStats.Blades > 0)
+    {
+        std::cout << "Time slicing on screen: " << RunVisibleTimeSliceStats.solvedFraction() * 100.0f << "% of blade updates solved ("
+            << 1.0f / RunVisibleTimeSliceStats.solvedFraction() << "x fewer), tip error mean " << RunVisibleTimeSliceStats.meanTipError()
+            << " px, max " << RunVisibleTimeSliceStats.MaxTipError << " px" << std::endl;
+    }
+    if (Rasterizer && !saveSoftwareFramebuffer(Rasterizer->framebuffer(), Software.OutputPath))
+    {
+        std::cerr << "Could not write " << Software.OutputPath << std::endl;
+        return 1;
+    }
+    if (Rasterizer)
+    {
+        printWorkerStats(Pool, std::cout); // How evenly the headless run spread over the pool
+    }
     return 0;
 }
@@ -0,0 +1,44 @@
+#include "Worm.h"
+
+#include "VectorMath.h"
+#include "WorkerPool.h"
+
+#include <cassert>
+
+void initializeWorm(std::vector<WormSegment>& WormSegments, const sf::Vector2f& Head)
+{
+    for (std::size_t I = 0; I < WormSegments.size(); ++I)
+    {
+        WormSegments[I].Position = Head + sf::Vector2f(0.0f, static_cast<float>(I) * SegmentLength);
+    }
+}
+
+void updateWorm(std::vector<WormSegment>& WormSegments, const sf::Vector2f& TargetPosition)
+{
+    // Set the head of the worm to the target position (mouse cursor)
+    WormSegments[0].Position = TargetPosition;
+
+    // Update each segment to follow the previous segment
+    for (std::size_t I = 1; I < WormSegments.size(); ++I)
+    {
+        // Compared squared, so a segment within reach needs no square root at all
+        const sf::Vector2f Direction = WormSegments[I].Position - WormSegments[I - 1].Position;
+        const float DistanceSquared = Direction.x * Direction.x + Direction.y * Direction.y;
+        if (DistanceSquared > SegmentLength * SegmentLength)
+        {
+            WormSegments[I].Position = WormSegments[I - 1].Position + Direction * (fastInverseSqrt(DistanceSquared) * SegmentLength);
+        }
+    }
+}
+
+void updateWorms(const std::span<std::vector<WormSegment>> Worms, const std::span<const sf::Vector2f> Targets, WorkerPool& Pool)
+{
+    assert(Worms.size() == Targets.size());
+    Pool.parallelFor(Worms.size(), [&](const std::size_t Begin, const std::size_t End)
+    {
+        for (std::size_t I = Begin; I < End; ++I)
+        {
+            updateWorm(Worms[I], Targets[I]);
+        }
+    });
+}
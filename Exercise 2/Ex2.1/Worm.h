@@ -0,0 +1,24 @@
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+#include <span>
+#include <vector>
+
+class WorkerPool;
+
+constexpr int NumWormSegments = 10;
+constexpr float SegmentLength = 50.0f;
+constexpr float WormThickness = 6.0f;
+
+struct WormSegment
+{
+    sf::Vector2f Position;
+};
+
+// Lays the worm out vertically from Head, one SegmentLength apart
+void initializeWorm(std::vector<WormSegment>& WormSegments, const sf::Vector2f& Head);
+void updateWorm(std::vector<WormSegment>& WormSegments, const sf::Vector2f& TargetPosition);
+
+// Updates independent worms in parallel, worm I chasing Targets[I]. Each chain is sequential, so the pool
+// splits the worms rather than the segments of any one worm.
+void updateWorms(std::span<std::vector<WormSegment>> Worms, std::span<const sf::Vector2f> Targets, WorkerPool& Pool);
@@ -0,0 +1,443 @@
+#include "WormCollision.h"
+
+#include "VectorMath.h"
+#include "WorkerPool.h"
+#include "WormSwarm.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+
+namespace
+{
+    constexpr float ContactDistance = 2.0f * WormCollisionRadius;
+
+    // Gaps shorter than this, in px, belong to segments that cross or coincide, and their direction is
+    // rounding noise
+    constexpr float CrossingGap = 1e-3f;
+
+    // Capsule area of one segment
+    constexpr float SegmentArea = SegmentLength * ContactDistance + 3.14159265f * WormCollisionRadius * WormCollisionRadius;
+
+    // Points are at least a cell inside the grid's origin, so every cell and its neighbours have
+    // non-negative coordinates
+    std::uint32_t cellOf(const float Coordinate, const float Origin, const float InverseCellSize)
+    {
+        return static_cast<std::uint32_t>((Coordinate - Origin) * InverseCellSize);
+    }
+
+    // Row-major and wrapping, so unsigned overflow only wraps further round the power of two buckets
+    std::uint32_t bucketOf(const std::uint32_t Column, const std::uint32_t Row, const std::uint32_t Pitch, const std::uint32_t Mask)
+    {
+        return (Column + Row * Pitch) & Mask;
+    }
+
+    // Slots of a run of buckets
+    struct SlotRange
+    {
+        std::uint32_t Begin;
+        std::uint32_t End;
+    };
+
+    float dot(const sf::Vector2f A, const sf::Vector2f B)
+    {
+        return A.x * B.x + A.y * B.y;
+    }
+
+    // Parameters along the segments Start1 + S * Direction1 and Start2 + T * Direction2, both in [0, 1], of
+    // their closest points. Zero-length segments are points, parallel ones take S = 0.
+    void closestParameters(const sf::Vector2f Start1, const sf::Vector2f Direction1, const sf::Vector2f Start2, const sf::Vector2f Direction2,
+        float& S, float& T)
+    {
+        constexpr float Epsilon = 1e-8f;
+        const sf::Vector2f Between = Start1 - Start2;
+        const float LengthSquared1 = dot(Direction1, Direction1);
+        const float LengthSquared2 = dot(Direction2, Direction2);
+        const float Along2 = dot(Direction2, Between);
+        if (LengthSquared1 <= Epsilon)
+        {
+            S = 0.0f;
+            T = LengthSquared2 <= Epsilon ? 0.0f : std::clamp(Along2 / LengthSquared2, 0.0f, 1.0f);
+            return;
+        }
+        const float Along1 = dot(Direction1, Between);
+        if (LengthSquared2 <= Epsilon)
+        {
+            T = 0.0f;
+            S = std::clamp(-Along1 / LengthSquared1, 0.0f, 1.0f);
+            return;
+        }
+
+        const float Alignment = dot(Direction1, Direction2);
+        const float Denominator = LengthSquared1 * LengthSquared2 - Alignment * Alignment;
+        S = Denominator > 1e-6f * LengthSquared1 * LengthSquared2 ? std::clamp((Alignment * Along2 - Along1 * LengthSquared2) / Denominator, 0.0f, 1.0f) : 0.0f;
+        T = (Alignment * S + Along2) / LengthSquared2;
+        if (T < 0.0f)
+        {
+            T = 0.0f;
+            S = std::clamp(-Along1 / LengthSquared1, 0.0f, 1.0f);
+        }
+        else if (T > 1.0f)
+        {
+            T = 1.0f;
+            S = std::clamp((Alignment - Along1) / LengthSquared1, 0.0f, 1.0f);
+        }
+    }
+
+    // Counting sort of every segment into its midpoint's bucket: count, prefix sum to bucket ends, then
+    // scatter backwards so each bucket's start is left behind in BucketStart
+    void buildGrid(WormCollisionGrid& Grid, const float* X, const float* Y, const std::size_t WormCount, const std::size_t Stride, const int Points,
+        WorkerPool& Pool)
+    {
+        const std::size_t Links = static_cast<std::size_t>(Points - 1);
+        const std::size_t Segments = Links * WormCount;
+        std::size_t Buckets = 16;
+        while (Buckets < Segments * 2)
+        {
+            Buckets *= 2;
+        }
+        const std::uint32_t Mask = static_cast<std::uint32_t>(Buckets - 1);
+        Grid.BucketStart.assign(Buckets + 1, 0);
+        Grid.SegmentSlot.resize(Links * Stride);
+        Grid.SlotPoint.resize(Segments);
+        Grid.Segments.resize(Segments);
+
+        // Bounds of every point, so the rows of the grid are as wide as the points need
+        sf::Vector2f Min(X[0], Y[0]);
+        sf::Vector2f Max = Min;
+        std::mutex BoundsMutex;
+        Pool.parallelFor(WormCount, [&](const std::size_t Begin, const std::size_t End)
+        {
+            sf::Vector2f ChunkMin(X[Begin], Y[Begin]);
+            sf::Vector2f ChunkMax = ChunkMin;
+            for (int Point = 0; Point < Points; ++Point)
+            {
+                const float* RowX = X + Point * Stride;
+                const float* RowY = Y + Point * Stride;
+                for (std::size_t Worm = Begin; Worm < End; ++Worm)
+                {
+                    ChunkMin.x = std::min(ChunkMin.x, RowX[Worm]);
+                    ChunkMin.y = std::min(ChunkMin.y, RowY[Worm]);
+                    ChunkMax.x = std::max(ChunkMax.x, RowX[Worm]);
+                    ChunkMax.y = std::max(ChunkMax.y, RowY[Worm]);
+                }
+            }
+            const std::lock_guard Lock(BoundsMutex);
+            Min = sf::Vector2f(std::min(Min.x, ChunkMin.x), std::min(Min.y, ChunkMin.y));
+            Max = sf::Vector2f(std::max(Max.x, ChunkMax.x), std::max(Max.y, ChunkMax.y));
+        });
+        const float InverseCellSize = 1.0f / Grid.CellSize;
+        Grid.Origin = Min - sf::Vector2f(Grid.CellSize, Grid.CellSize);
+        // Columns 1 to the last holding a point, and one either side; far-flung points just wrap more often. The
+        // three rows around a cell must land on separate runs of buckets, or a query would visit some twice.
+        std::uint32_t Pitch = static_cast<std::uint32_t>(std::min((Max.x - Min.x) * InverseCellSize, 1e6f)) + 3;
+        const auto aliases = [Mask](const std::uint32_t Offset)
+        {
+            return (Offset & Mask) < 3 || (Offset & Mask) > Mask - 2;
+        };
+        while (aliases(Pitch) || aliases(2 * Pitch))
+        {
+            ++Pitch;
+        }
+        Grid.Pitch = Pitch;
+
+        const sf::Vector2f Origin = Grid.Origin;
+        Pool.parallelFor(WormCount, [&](const std::size_t Begin, const std::size_t End)
+        {
+            for (std::size_t Link = 0; Link < Links; ++Link)
+            {
+                const float* StartX = X + Link * Stride;
+                const float* StartY = Y + Link * Stride;
+                for (std::size_t Worm = Begin; Worm < End; ++Worm)
+                {
+                    const float MidX = 0.5f * (StartX[Worm] + StartX[Worm + Stride]);
+                    const float MidY = 0.5f * (StartY[Worm] + StartY[Worm + Stride]);
+                    Grid.SegmentSlot[Link * Stride + Worm] =
+                        bucketOf(cellOf(MidX, Origin.x, InverseCellSize), cellOf(MidY, Origin.y, InverseCellSize), Pitch, Mask);
+                }
+            }
+        });
+
+        std::uint32_t* BucketStart = Grid.BucketStart.data();
+        for (std::size_t Link = 0; Link < Links; ++Link)
+        {
+            for (std::size_t Worm = 0; Worm < WormCount; ++Worm)
+            {
+                ++BucketStart[Grid.SegmentSlot[Link * Stride + Worm]];
+            }
+        }
+        std::uint32_t Total = 0;
+        for (std::size_t Bucket = 0; Bucket < Buckets; ++Bucket)
+        {
+            Total += BucketStart[Bucket];
+            BucketStart[Bucket] = Total;
+        }
+        BucketStart[Buckets] = Total;
+        for (std::size_t Link = Links; Link-- > 0;)
+        {
+            for (std::size_t Worm = WormCount; Worm-- > 0;)
+            {
+                const std::size_t Point = Link * Stride + Worm;
+                const std::uint32_t Slot = --BucketStart[Grid.SegmentSlot[Point]];
+                Grid.SegmentSlot[Point] = Slot;
+                Grid.SlotPoint[Slot] = static_cast<std::uint32_t>(Point);
+            }
+        }
+
+        // Only the indices move serially; the segments are copied in order from them
+        Pool.parallelFor(Segments, [&](const std::size_t Begin, const std::size_t End)
+        {
+            for (std::size_t Slot = Begin; Slot < End; ++Slot)
+            {
+                const std::uint32_t Point = Grid.SlotPoint[Slot];
+                const std::uint32_t Link = static_cast<std::uint32_t>(Point / Stride);
+                const sf::Vector2f Start(X[Point], Y[Point]);
+                const sf::Vector2f Half = (sf::Vector2f(X[Point + Stride], Y[Point + Stride]) - Start) * 0.5f;
+                const sf::Vector2f Middle = Start + Half;
+                Grid.Segments[Slot] = { Middle.x, Middle.y, Half.x, Half.y, fastLength(Half), static_cast<std::uint32_t>(Point - Link * Stride), Link };
+            }
+        });
+    }
+
+    // The slots of the three cells around Column in Row, one run of buckets, or two where it wraps
+    int rowRanges(const WormCollisionGrid& Grid, const std::uint32_t Column, const std::uint32_t Row, SlotRange* Out)
+    {
+        const std::uint32_t Buckets = static_cast<std::uint32_t>(Grid.BucketStart.size() - 1);
+        const std::uint32_t First = bucketOf(Column - 1, Row, Grid.Pitch, Buckets - 1);
+        if (First + 3 <= Buckets)
+        {
+            Out[0] = { Grid.BucketStart[First], Grid.BucketStart[First + 3] };
+            return 1;
+        }
+        Out[0] = { Grid.BucketStart[First], Grid.BucketStart[Buckets] };
+        Out[1] = { Grid.BucketStart[0], Grid.BucketStart[First + 3 - Buckets] };
+        return 2;
+    }
+
+    // Works out the push every capsule overlapping the segment in Slot puts on its two points, against the
+    // grid's copies of the positions before the pass
+    std::size_t pushSegment(WormCollisionGrid& Grid, const std::uint32_t Slot, const float InverseCellSize)
+    {
+        const WormCollisionSegment& Segment = Grid.Segments[Slot];
+        const sf::Vector2f Middle(Segment.MiddleX, Segment.MiddleY);
+        const sf::Vector2f Half(Segment.HalfX, Segment.HalfY);
+        const float Clearance = ContactDistance * Segment.HalfLength;
+        const std::uint32_t Column = cellOf(Middle.x, Grid.Origin.x, InverseCellSize);
+        const std::uint32_t Row = cellOf(Middle.y, Grid.Origin.y, InverseCellSize);
+        const float ReachSquared = Grid.CellSize * Grid.CellSize;
+
+        // The three neighbouring rows
+        SlotRange Ranges[6];
+        int RangeCount = 0;
+        for (std::uint32_t Offset = 0; Offset < 3; ++Offset)
+        {
+            RangeCount += rowRanges(Grid, Column, Row + Offset - 1, Ranges + RangeCount);
+        }
+
+        sf::Vector2f PushStart;
+        sf::Vector2f PushEnd;
+        std::size_t Contacts = 0;
+        for (int Range = 0; Range < RangeCount; ++Range)
+        {
+            for (std::uint32_t OtherSlot = Ranges[Range].Begin; OtherSlot < Ranges[Range].End; ++OtherSlot)
+            {
+                const WormCollisionSegment& Other = Grid.Segments[OtherSlot];
+                // Nearly every candidate is rejected, by one of three tests that are all cheap enough to run every
+                // time, so they share one branch that is nearly always taken instead of three that are not. Most
+                // pairs near enough to pass the reach test are still apart, which shows without solving for the
+                // closest points: one segment lies wholly beyond the contact distance on one side of the other's
+                // line. Those distances are scaled by the length of the half they are measured from.
+                const sf::Vector2f OtherMiddle(Other.MiddleX, Other.MiddleY);
+                const sf::Vector2f OtherHalf(Other.HalfX, Other.HalfY);
+                const sf::Vector2f Apart = Middle - OtherMiddle;
+                const float Turn = std::abs(Half.x * OtherHalf.y - Half.y * OtherHalf.x);
+                const bool Neighbour = (Other.Worm == Segment.Worm) & (Other.Link + 1 >= Segment.Link) & (Other.Link <= Segment.Link + 1);
+                const bool OutOfReach = dot(Apart, Apart) >= ReachSquared;
+                const bool Separated = (std::abs(Half.x * Apart.y - Half.y * Apart.x) - Turn >= Clearance) |
+                    (std::abs(OtherHalf.x * Apart.y - OtherHalf.y * Apart.x) - Turn >= ContactDistance * Other.HalfLength);
+                if (Neighbour | OutOfReach | Separated)
+                {
+                    continue; // Neighbours of this segment in its own worm, and itself, share a point with it
+                }
+
+                float S;
+                float T;
+                closestParameters(Middle - Half, Half * 2.0f, OtherMiddle - OtherHalf, OtherHalf * 2.0f, S, T);
+                const sf::Vector2f Gap = Apart + Half * (2.0f * S - 1.0f) - OtherHalf * (2.0f * T - 1.0f);
+                const float GapSquared = dot(Gap, Gap);
+                if (GapSquared >= ContactDistance * ContactDistance)
+                {
+                    continue;
+                }
+                ++Contacts;
+
+                // This side moves its half of the overlap, spread over the segment's two points so the closest
+                // point moves the full half. Crossing segments have no gap to push along, so each moves away from
+                // the other's middle, the same way every pass until they come apart. Segments sharing a middle
+                // split by worm and link order.
+                sf::Vector2f Normal;
+                float Distance = 0.0f;
+                if (GapSquared > CrossingGap * CrossingGap)
+                {
+                    const float Inverse = fastInverseSqrt(GapSquared);
+                    Normal = Gap * Inverse;
+                    Distance = GapSquared * Inverse;
+                }
+                else if (dot(Apart, Apart) > CrossingGap * CrossingGap)
+                {
+                    Normal = Apart * fastInverseSqrt(dot(Apart, Apart));
+                }
+                else
+                {
+                    const bool Lower = Segment.Worm < Other.Worm || (Segment.Worm == Other.Worm && Segment.Link < Other.Link);
+                    Normal = sf::Vector2f(0.0f, Lower ? -1.0f : 1.0f);
+                }
+                const sf::Vector2f Push = Normal * ((ContactDistance - Distance) * 0.5f / ((1.0f - S) * (1.0f - S) + S * S));
+                PushStart += Push * (1.0f - S);
+                PushEnd += Push * S;
+            }
+        }
+        Grid.PushStart[Slot] = PushStart;
+        Grid.PushEnd[Slot] = PushEnd;
+        return Contacts;
+    }
+}
+
+sf::Vector2f wormCollisionFieldSize(const std::size_t Count, const int Segments, const sf::Vector2f MinSize)
+{
+    const float Covered = static_cast<float>(Count) * static_cast<float>(std::max(0, Segments - 1)) * SegmentArea;
+    const float Scale = std::sqrt(Covered / WormCollisionCoverage / (MinSize.x * MinSize.y));
+    return Scale > 1.0f ? MinSize * Scale : MinSize;
+}
+
+std::size_t resolveWormCollisions(WormCollisionGrid& Grid, float* X, float* Y, const std::size_t WormCount, const std::size_t Stride, const int Points,
+    const bool PinHeads, WorkerPool& Pool)
+{
+    if (WormCount == 0 || Points < 3)
+    {
+        Grid.Contacts = 0;
+        return 0; // Fewer than three points have no segments that are not neighbours
+    }
+    buildGrid(Grid, X, Y, WormCount, Stride, Points, Pool);
+    const std::size_t Segments = Grid.Segments.size();
+    Grid.PushStart.resize(Segments);
+    Grid.PushEnd.resize(Segments);
+
+    // In bucket order, so neighbouring segments read the same rows of the grid
+    const float InverseCellSize = 1.0f / Grid.CellSize;
+    std::atomic<std::size_t> Contacts{ 0 };
+    Pool.parallelFor(Segments, [&](const std::size_t Begin, const std::size_t End)
+    {
+        std::size_t Found = 0;
+        for (std::size_t Slot = Begin; Slot < End; ++Slot)
+        {
+            Found += pushSegment(Grid, static_cast<std::uint32_t>(Slot), InverseCellSize);
+        }
+        Contacts.fetch_add(Found, std::memory_order_relaxed);
+    });
+
+    // Every point takes the push from the segment ending at it and the one starting at it
+    Pool.parallelFor(WormCount, [&](const std::size_t Begin, const std::size_t End)
+    {
+        for (int Point = PinHeads ? 1 : 0; Point < Points; ++Point)
+        {
+            const std::uint32_t* Before = Point > 0 ? Grid.SegmentSlot.data() + (Point - 1) * Stride : nullptr;
+            const std::uint32_t* After = Point + 1 < Points ? Grid.SegmentSlot.data() + Point * Stride : nullptr;
+            float* RowX = X + Point * Stride;
+            float* RowY = Y + Point * Stride;
+            for (std::size_t Worm = Begin; Worm < End; ++Worm)
+            {
+                sf::Vector2f Push;
+                if (Before != nullptr)
+                {
+                    Push += Grid.PushEnd[Before[Worm]];
+                }
+                if (After != nullptr)
+                {
+                    Push += Grid.PushStart[After[Worm]];
+                }
+                RowX[Worm] += Push.x;
+                RowY[Worm] += Push.y;
+            }
+        }
+    });
+    Grid.Contacts = Contacts.load();
+    return Grid.Contacts;
+}
+
+std::size_t resolveWormCollisions(WormCollisionGrid& Grid, WormSwarm& Swarm, WorkerPool& Pool)
+{
+    const std::size_t Contacts = resolveWormCollisions(Grid, Swarm.X, Swarm.Y, Swarm.WormCount, Swarm.Stride, Swarm.SegmentCount, false, Pool);
+    std::copy_n(Swarm.rowX(0), Swarm.WormCount, Swarm.TargetX);
+    std::copy_n(Swarm.rowY(0), Swarm.WormCount, Swarm.TargetY);
+
+    // What the head segment ran into, for the next steer to turn away from
+    if (Grid.Segments.empty() || Swarm.SegmentCount < 3)
+    {
+        std::fill_n(Swarm.AvoidX, Swarm.WormCount, 0.0f);
+        std::fill_n(Swarm.AvoidY, Swarm.WormCount, 0.0f);
+        return Contacts;
+    }
+    Pool.parallelFor(Swarm.WormCount, [&](const std::size_t Begin, const std::size_t End)
+    {
+        for (std::size_t Worm = Begin; Worm < End; ++Worm)
+        {
+            const std::uint32_t Slot = Grid.SegmentSlot[Worm];
+            const sf::Vector2f Push = Grid.PushStart[Slot] + Grid.PushEnd[Slot];
+            Swarm.AvoidX[Worm] = Push.x;
+            Swarm.AvoidY[Worm] = Push.y;
+        }
+    });
+    return Contacts;
+}
+
+std::size_t resolveWormCollisions(WormCollisionGrid& Grid, std::vector<WormSegment>& WormSegments, WorkerPool& Pool)
+{
+    Grid.WormX.resize(WormSegments.size());
+    Grid.WormY.resize(WormSegments.size());
+    for (std::size_t I = 0; I < WormSegments.size(); ++I)
+    {
+        Grid.WormX[I] = WormSegments[I].Position.x;
+        Grid.WormY[I] = WormSegments[I].Position.y;
+    }
+    const std::size_t Contacts = resolveWormCollisions(Grid, Grid.WormX.data(), Grid.WormY.data(), 1, 1, static_cast<int>(WormSegments.size()), true, Pool);
+    for (std::size_t I = 0; I < WormSegments.size(); ++I)
+    {
+        WormSegments[I].Position = sf::Vector2f(Grid.WormX[I], Grid.WormY[I]);
+    }
+    return Contacts;
+}
+
+float wormSwarmMaxOverlap(const WormSwarm& Swarm)
+{
+    const std::size_t Links = static_cast<std::size_t>(std::max(Swarm.SegmentCount - 1, 0));
+    const auto start = [&Swarm](const std::size_t Worm, const std::size_t Link)
+    {
+        return sf::Vector2f(Swarm.rowX(static_cast<int>(Link))[Worm], Swarm.rowY(static_cast<int>(Link))[Worm]);
+    };
+    float Deepest = 0.0f;
+    for (std::size_t Worm = 0; Worm < Swarm.WormCount; ++Worm)
+    {
+        for (std::size_t Link = 0; Link < Links; ++Link)
+        {
+            const sf::Vector2f Start = start(Worm, Link);
+            const sf::Vector2f Direction = start(Worm, Link + 1) - Start;
+            for (std::size_t OtherWorm = Worm; OtherWorm < Swarm.WormCount; ++OtherWorm)
+            {
+                // Each pair once, skipping the segment itself and the ones sharing a point with it
+                for (std::size_t OtherLink = OtherWorm == Worm ? Link + 2 : 0; OtherLink < Links; ++OtherLink)
+                {
+                    const sf::Vector2f OtherStart = start(OtherWorm, OtherLink);
+                    const sf::Vector2f OtherDirection = start(OtherWorm, OtherLink + 1) - OtherStart;
+                    float S;
+                    float T;
+                    closestParameters(Start, Direction, OtherStart, OtherDirection, S, T);
+                    const sf::Vector2f Gap = Start + Direction * S - OtherStart - OtherDirection * T;
+                    Deepest = std::max(Deepest, ContactDistance - std::sqrt(dot(Gap, Gap)));
+                }
+            }
+        }
+    }
+    return Deepest;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Worm.h"
+
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class WorkerPool;
+struct WormSwarm;
+
+// Every segment is a capsule of this radius around the line between its two points
+constexpr float WormCollisionRadius = WormThickness / 2.0f;
+
+// Share of a colliding swarm's field its capsules cover. At window size a big swarm covers the window many
+// times over, which no amount of pushing apart can resolve, so the collision scene spreads it out instead.
+constexpr float WormCollisionCoverage = 0.05f;
+
+// One segment as the grid stores it, in bucket order: its midpoint and the half of it from there to its end
+struct WormCollisionSegment
+{
+    float MiddleX = 0.0f;
+    float MiddleY = 0.0f;
+    float HalfX = 0.0f;
+    float HalfY = 0.0f;
+    float HalfLength = 0.0f;
+    std::uint32_t Worm = 0;
+    std::uint32_t Link = 0; // Segment within the worm, from its first point
+};
+
+// Broadphase and scratch space for the collision pass, kept between frames so a steady-state frame allocates
+// nothing. Segments are hashed by their midpoint into square cells one segment plus one capsule diameter
+// across, so any two touching capsules sit in the same or neighbouring cells. Cells hash row-major,
+// (Column + Row * Pitch) modulo the bucket count, so the three cells of a neighbouring row are one run of
+// buckets; with enough buckets for the points' bounds it is a plain grid. The hash is rebuilt every frame
+// with a counting sort, which also copies the segments into bucket order.
+struct WormCollisionGrid
+{
+    float CellSize = SegmentLength + 2.0f * WormCollisionRadius;
+
+    sf::Vector2f Origin;   // Corner of cell (0, 0), one cell outside the points' bounds
+    std::uint32_t Pitch = 0;
+    std::vector<std::uint32_t> BucketStart; // Power of two buckets, plus one end entry
+    std::vector<std::uint32_t> SegmentSlot; // Per segment, indexed like the points of its start: its bucket while
+                                            // sorting, then its place in Segments
+    std::vector<std::uint32_t> SlotPoint;   // Per slot, the inverse: the index of the segment's start point
+    std::vector<WormCollisionSegment> Segments;
+
+    // Per slot, the push this segment's contacts put on its start and end points
+    std::vector<sf::Vector2f> PushStart;
+    std::vector<sf::Vector2f> PushEnd;
+
+    // The single worm's points, copied out of and back into its segments around the pass
+    std::vector<float> WormX;
+    std::vector<float> WormY;
+
+    std::size_t Contacts = 0; // Overlapping segment pairs found by the last pass, each counted from both sides
+};
+
+// Field size for a colliding swarm of Count worms: MinSize, grown in proportion until the capsules cover
+// at most WormCollisionCoverage of it
+sf::Vector2f wormCollisionFieldSize(std::size_t Count, int Segments, sf::Vector2f MinSize);
+
+// Pushes apart every pair of overlapping capsules among the segments of WormCount worms of Points points,
+// stored segment-major like WormSwarm (point P of worm W at P * Stride + W). Segments of one worm collide
+// too, except neighbours, which share a point. Every segment works out its push from the positions before
+// the pass, walking the grid in bucket order so neighbouring queries share cache lines, and each worm then
+// sums the pushes on its own points, so the result does not depend on the thread count. PinHeads keeps every
+// first point where it is. Returns the number of contacts.
+std::size_t resolveWormCollisions(WormCollisionGrid& Grid, float* X, float* Y, std::size_t WormCount, std::size_t Stride, int Points,
+    bool PinHeads, WorkerPool& Pool);
+
+// The same for a whole swarm, and for the single worm colliding with itself. The swarm's heads are pushed too
+// and carried back into their wander targets, and the push on each head segment is left in the swarm's
+// AvoidX/AvoidY for steerWormSwarm to turn away from. Pushing alone cannot settle a swarm: one pass, or
+// several, only holds apart worms that their steering keeps driving into each other, and the crowds and
+// contacts grow without bound. The single worm's head stays on the mouse.
+std::size_t resolveWormCollisions(WormCollisionGrid& Grid, WormSwarm& Swarm, WorkerPool& Pool);
+std::size_t resolveWormCollisions(WormCollisionGrid& Grid, std::vector<WormSegment>& WormSegments, WorkerPool& Pool);
+
+// Deepest overlap in px between any two capsules of Swarm that are not neighbours in one worm, found by
+// testing every pair without the grid, to check the pass against on small swarms
+float wormSwarmMaxOverlap(const WormSwarm& Swarm);
+
+// Most wormSwarmMaxOverlap may report for a freshly seeded swarm at WormCollisionCoverage once it has run
+// this many frames of the follow constraint and the pass without steering
+constexpr int WormCollisionSettleFrames = 64;
+constexpr float WormCollisionSettleTolerance = 0.01f;
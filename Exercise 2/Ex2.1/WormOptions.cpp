@@ -0,0 +1,69 @@
+#include "WormOptions.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+WormOptions parseWormOptions(const int Argc, char* Argv[])
+{
+    WormOptions Options;
+    for (int I = 1; I < Argc; ++I)
+    {
+        const bool HasValue = I + 1 < Argc;
+        if (std::strcmp(Argv[I], "--swarm") == 0)
+        {
+            // Optional worm count, 100000 by default
+            Options.SwarmCount = HasValue && Argv[I + 1][0] != '-' ? std::strtoull(Argv[++I], nullptr, 10) : 100000;
+        }
+        else if (std::strcmp(Argv[I], "--scalar") == 0)
+        {
+            Options.Isa = WormIsa::Scalar;
+        }
+        else if (std::strcmp(Argv[I], "--threads") == 0 && HasValue)
+        {
+            Options.Threads = static_cast<unsigned>(std::strtoul(Argv[++I], nullptr, 10));
+        }
+        else if (std::strcmp(Argv[I], "--seed") == 0 && HasValue)
+        {
+            Options.Seed = static_cast<unsigned>(std::strtoul(Argv[++I], nullptr, 10));
+        }
+        else if (std::strcmp(Argv[I], "--verify") == 0)
+        {
+            Options.Verify = true;
+        }
+        else if (std::strcmp(Argv[I], "--scaling") == 0)
+        {
+            Options.Scaling = true;
+        }
+        else if (std::strcmp(Argv[I], "--collide") == 0)
+        {
+            Options.Collide = true;
+        }
+        else if (std::strcmp(Argv[I], "--rope") == 0)
+        {
+            // Optional point count, as many as the worm's segments by default
+            Options.RopePoints = HasValue && Argv[I + 1][0] != '-' ? std::strtoull(Argv[++I], nullptr, 10) : NumWormSegments;
+        }
+        else if (std::strcmp(Argv[I], "--solver") == 0 && HasValue)
+        {
+            parseRopeSolver(Argv[++I], Options.Rope.Solver);
+        }
+        else if (std::strcmp(Argv[I], "--substeps") == 0 && HasValue)
+        {
+            Options.Rope.Substeps = std::max(1, std::atoi(Argv[++I]));
+        }
+        else if (std::strcmp(Argv[I], "--iterations") == 0 && HasValue)
+        {
+            Options.Rope.Iterations = std::max(0, std::atoi(Argv[++I]));
+        }
+        else if (std::strcmp(Argv[I], "--no-tethers") == 0)
+        {
+            Options.Rope.Tethers = false;
+        }
+        else if (std::strcmp(Argv[I], "--compliance") == 0 && HasValue)
+        {
+            Options.Rope.Compliance = std::max(0.0f, static_cast<float>(std::atof(Argv[++I])));
+        }
+    }
+    return Options;
+}
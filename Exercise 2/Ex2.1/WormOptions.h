@@ -0,0 +1,22 @@
+#pragma once
+
+#include "WormRope.h"
+#include "WormSwarm.h"
+
+#include <cstddef>
+
+// Command line settings for the worm exercise, see the Readme for the full list
+struct WormOptions
+{
+    std::size_t SwarmCount = 0; // 0 runs the single mouse-driven worm, otherwise this many wandering worms
+    WormIsa Isa = detectWormIsa();
+    unsigned Threads = 0;       // One per hardware thread in swarm and software modes
+    unsigned Seed = 1;
+    bool Verify = false;
+    bool Scaling = false;
+    bool Collide = false;       // Capsule collisions between segments, of the single worm or the whole swarm
+    std::size_t RopePoints = 0; // 0 runs the follow-the-leader worm, otherwise a rope of this many points
+    RopeSettings Rope;
+};
+
+WormOptions parseWormOptions(int Argc, char* Argv[]);
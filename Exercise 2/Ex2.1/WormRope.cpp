@@ -0,0 +1,290 @@
+#include "WormRope.h"
+
+#include "VectorMath.h"
+#include "WorkerPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+
+namespace
+{
+    // Share of its push each link applies in a Jacobi iteration. Every inner point takes pushes from two links
+    // computed without seeing each other, and applying both in full overshoots.
+    constexpr float JacobiRelaxation = 0.5f;
+
+    // The head follows its target and no link moves it
+    float inverseMass(const std::size_t Point)
+    {
+        return Point == 0 ? 0.0f : 1.0f;
+    }
+
+    // Largest residual found by any chunk of a parallel pass
+    struct ErrorMax
+    {
+        std::mutex Mutex;
+        float Value = 0.0f;
+
+        void merge(const float Chunk)
+        {
+            const std::lock_guard Lock(Mutex);
+            Value = std::max(Value, Chunk);
+        }
+    };
+
+    // The link's XPBD residual, and the multiplier step that removes it, along Direction scaled by Inverse
+    struct LinkStep
+    {
+        sf::Vector2f Direction;
+        float Inverse = 0.0f;
+        float Residual = 0.0f;
+        float Step = 0.0f;
+    };
+
+    // Alpha is the compliance over the time step squared. Links too short to have a direction are skipped.
+    LinkStep linkStep(const WormRope& Rope, const std::size_t Link, const float Alpha)
+    {
+        LinkStep Result;
+        Result.Direction = Rope.Position[Link + 1] - Rope.Position[Link];
+        const float LengthSquared = Result.Direction.x * Result.Direction.x + Result.Direction.y * Result.Direction.y;
+        if (LengthSquared > FastMinLengthSquared)
+        {
+            Result.Inverse = fastInverseSqrt(LengthSquared);
+            Result.Residual = LengthSquared * Result.Inverse - Rope.LinkLength + Alpha * Rope.Lambda[Link];
+            Result.Step = -Result.Residual / (inverseMass(Link) + inverseMass(Link + 1) + Alpha);
+        }
+        return Result;
+    }
+
+    // Projects one link in place, for the solvers that see each correction straight away
+    float solveLink(WormRope& Rope, const std::size_t Link, const float Alpha)
+    {
+        const LinkStep Step = linkStep(Rope, Link, Alpha);
+        const sf::Vector2f Push = Step.Direction * (Step.Inverse * Step.Step);
+        Rope.Lambda[Link] += Step.Step;
+        Rope.Position[Link] -= Push * inverseMass(Link);
+        Rope.Position[Link + 1] += Push * inverseMass(Link + 1);
+        return std::abs(Step.Residual);
+    }
+
+    void integrate(WormRope& Rope, const sf::Vector2f& Target, const float DeltaTime, const RopeSettings& Settings, WorkerPool& Pool)
+    {
+        Rope.Previous[0] = Rope.Position[0];
+        Rope.Position[0] = Target;
+        const sf::Vector2f Fall = Settings.Gravity * (DeltaTime * DeltaTime);
+        const float Retained = std::pow(1.0f - std::clamp(Settings.Damping, 0.0f, 1.0f), DeltaTime);
+        Pool.parallelFor(Rope.Position.size() - 1, [&](const std::size_t Begin, const std::size_t End)
+        {
+            for (std::size_t Point = Begin + 1; Point <= End; ++Point)
+            {
+                const sf::Vector2f Velocity = (Rope.Position[Point] - Rope.Previous[Point]) * Retained;
+                Rope.Previous[Point] = Rope.Position[Point];
+                Rope.Position[Point] += Velocity + Fall;
+            }
+        });
+    }
+
+    float gaussSeidelIteration(WormRope& Rope, const float Alpha)
+    {
+        float Error = 0.0f;
+        for (std::size_t Link = 0; Link < Rope.Lambda.size(); ++Link)
+        {
+            Error = std::max(Error, solveLink(Rope, Link, Alpha));
+        }
+        return Error;
+    }
+
+    float jacobiIteration(WormRope& Rope, const float Alpha, WorkerPool& Pool)
+    {
+        const std::size_t Links = Rope.Lambda.size();
+        ErrorMax Error;
+        Pool.parallelFor(Links, [&](const std::size_t Begin, const std::size_t End)
+        {
+            float Chunk = 0.0f;
+            for (std::size_t Link = Begin; Link < End; ++Link)
+            {
+                const LinkStep Step = linkStep(Rope, Link, Alpha);
+                Rope.LinkPush[Link] = Step.Direction * (Step.Inverse * Step.Step * JacobiRelaxation);
+                Rope.Lambda[Link] += Step.Step * JacobiRelaxation;
+                Chunk = std::max(Chunk, std::abs(Step.Residual));
+            }
+            Error.merge(Chunk);
+        });
+
+        // Every point but the head is pulled by the link before it and the link after it
+        Pool.parallelFor(Links, [&](const std::size_t Begin, const std::size_t End)
+        {
+            for (std::size_t Point = Begin + 1; Point <= End; ++Point)
+            {
+                sf::Vector2f Push = Rope.LinkPush[Point - 1];
+                if (Point < Links)
+                {
+                    Push -= Rope.LinkPush[Point];
+                }
+                Rope.Position[Point] += Push * inverseMass(Point);
+            }
+        });
+        return Error.Value;
+    }
+
+    float coloredIteration(WormRope& Rope, const float Alpha, WorkerPool& Pool)
+    {
+        const std::size_t Links = Rope.Lambda.size();
+        ErrorMax Error;
+        for (std::size_t Color = 0; Color < 2; ++Color)
+        {
+            Pool.parallelFor((Links + 1 - Color) / 2, [&](const std::size_t Begin, const std::size_t End)
+            {
+                float Chunk = 0.0f;
+                for (std::size_t Pair = Begin; Pair < End; ++Pair)
+                {
+                    Chunk = std::max(Chunk, solveLink(Rope, Pair * 2 + Color, Alpha));
+                }
+                Error.merge(Chunk);
+            });
+        }
+        return Error.Value;
+    }
+
+    // No point farther from the head than the rope between them allows: its rest length, plus the stretch
+    // of each link under the weight of the points hanging from it, StretchPerPoint each. Each point only
+    // reads the head, so the whole rope is one parallel pass. Returns the farthest any point was pulled in.
+    float applyTethers(WormRope& Rope, const float StretchPerPoint, WorkerPool& Pool)
+    {
+        const sf::Vector2f Head = Rope.Position[0];
+        const float Links = static_cast<float>(Rope.Lambda.size());
+        ErrorMax Correction;
+        Pool.parallelFor(Rope.Position.size() - 1, [&](const std::size_t Begin, const std::size_t End)
+        {
+            float Chunk = 0.0f;
+            for (std::size_t Point = Begin + 1; Point <= End; ++Point)
+            {
+                const sf::Vector2f Offset = Rope.Position[Point] - Head;
+                const float DistanceSquared = Offset.x * Offset.x + Offset.y * Offset.y;
+
+                // Links 0 to Point - 1 hold up Links, Links - 1, ... Links - Point + 1 points
+                const float Count = static_cast<float>(Point);
+                const float Reach = Count * Rope.LinkLength + StretchPerPoint * Count * (Links - (Count - 1.0f) * 0.5f);
+                if (DistanceSquared > Reach * Reach)
+                {
+                    const float Inverse = fastInverseSqrt(DistanceSquared);
+                    Rope.Position[Point] = Head + Offset * (Inverse * Reach);
+                    Chunk = std::max(Chunk, DistanceSquared * Inverse - Reach);
+                }
+            }
+            Correction.merge(Chunk);
+        });
+        return Correction.Value;
+    }
+
+    // What the last iteration left, measured without moving anything
+    float residualError(const WormRope& Rope, const float Alpha, WorkerPool& Pool)
+    {
+        ErrorMax Error;
+        Pool.parallelFor(Rope.Lambda.size(), [&](const std::size_t Begin, const std::size_t End)
+        {
+            float Chunk = 0.0f;
+            for (std::size_t Link = Begin; Link < End; ++Link)
+            {
+                Chunk = std::max(Chunk, std::abs(linkStep(Rope, Link, Alpha).Residual));
+            }
+            Error.merge(Chunk);
+        });
+        return Error.Value;
+    }
+}
+
+void initializeWormRope(WormRope& Rope, const std::size_t Points, const sf::Vector2f& Head, const float LinkLength)
+{
+    Rope.LinkLength = LinkLength;
+    Rope.Position.resize(Points);
+    for (std::size_t I = 0; I < Points; ++I)
+    {
+        Rope.Position[I] = Head + sf::Vector2f(0.0f, static_cast<float>(I) * LinkLength);
+    }
+    Rope.Previous = Rope.Position;
+    const std::size_t Links = Points > 0 ? Points - 1 : 0;
+    Rope.Lambda.assign(Links, 0.0f);
+    Rope.LinkPush.assign(Links, sf::Vector2f());
+    Rope.IterationError.clear();
+    Rope.TetherCorrection = 0.0f;
+}
+
+void updateWormRope(WormRope& Rope, const sf::Vector2f& Target, const float DeltaTime, const RopeSettings& Settings, WorkerPool& Pool)
+{
+    if (Rope.Position.empty() || DeltaTime <= 0.0f)
+    {
+        return;
+    }
+    const int Substeps = std::max(Settings.Substeps, 1);
+    const int Iterations = std::max(Settings.Iterations, 0);
+    const float Step = DeltaTime / static_cast<float>(Substeps);
+
+    // XPBD: the multipliers restart every substep, and the compliance is scaled by the step so the stiffness
+    // does not depend on the frame rate, the substeps or the iteration count
+    const float Alpha = Settings.Compliance / (Step * Step);
+    const float StretchPerPoint = Settings.Compliance * std::hypot(Settings.Gravity.x, Settings.Gravity.y);
+    const sf::Vector2f Start = Rope.Position[0];
+    Rope.IterationError.assign(static_cast<std::size_t>(Iterations) + 1, 0.0f);
+    Rope.TetherCorrection = 0.0f;
+    for (int Substep = 1; Substep <= Substeps; ++Substep)
+    {
+        integrate(Rope, Start + (Target - Start) * (static_cast<float>(Substep) / static_cast<float>(Substeps)), Step, Settings, Pool);
+        std::fill(Rope.Lambda.begin(), Rope.Lambda.end(), 0.0f);
+        for (int Iteration = 0; Iteration < Iterations; ++Iteration)
+        {
+            float Error = 0.0f;
+            switch (Settings.Solver)
+            {
+            case RopeSolver::GaussSeidel:
+                Error = gaussSeidelIteration(Rope, Alpha);
+                break;
+            case RopeSolver::Jacobi:
+                Error = jacobiIteration(Rope, Alpha, Pool);
+                break;
+            case RopeSolver::Colored:
+                Error = coloredIteration(Rope, Alpha, Pool);
+                break;
+            }
+            Rope.IterationError[static_cast<std::size_t>(Iteration)] = Error;
+        }
+
+        // The residual is taken before the tethers move anything, so it is what the iterations left
+        if (Substep == Substeps)
+        {
+            Rope.IterationError.back() = residualError(Rope, Alpha, Pool);
+        }
+        if (Settings.Tethers)
+        {
+            Rope.TetherCorrection = applyTethers(Rope, StretchPerPoint, Pool);
+        }
+    }
+}
+
+const char* ropeSolverName(const RopeSolver Solver)
+{
+    switch (Solver)
+    {
+    case RopeSolver::GaussSeidel:
+        return "gauss-seidel";
+    case RopeSolver::Jacobi:
+        return "jacobi";
+    case RopeSolver::Colored:
+        return "colored";
+    }
+    return "unknown";
+}
+
+bool parseRopeSolver(const char* Name, RopeSolver& Solver)
+{
+    for (const RopeSolver Candidate : { RopeSolver::GaussSeidel, RopeSolver::Jacobi, RopeSolver::Colored })
+    {
+        if (std::strcmp(Name, ropeSolverName(Candidate)) == 0)
+        {
+            Solver = Candidate;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Worm.h"
+
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <vector>
+
+class WorkerPool;
+
+// How each iteration solves the rope's links
+enum class RopeSolver
+{
+    GaussSeidel, // One sweep from head to tail, each link seeing the corrections before it. Sequential.
+    Jacobi,      // Every link from the positions before the iteration, then half of each push applied. Parallel.
+    Colored      // Even links, then odd links. No two links of one colour share a point, so each half is parallel.
+};
+
+struct RopeSettings
+{
+    RopeSolver Solver = RopeSolver::GaussSeidel;
+    int Substeps = 4;                     // Steps each update is split into, each integrated and solved on its own
+    int Iterations = 2;                   // Per substep
+    float Compliance = 0.0f;              // Stretch of a link per unit of force, in px per px/s^2 of unit mass. 0 is inextensible.
+    sf::Vector2f Gravity{ 0.0f, 980.0f }; // px/s^2
+    float Damping = 0.5f;                 // Share of its velocity every point loses per second
+
+    // Long-range attachments: after each substep's iterations, every point is pulled back within its
+    // distance along the rope from the head. The iterations only carry a correction one link further each,
+    // so without these a rope of thousands of links stretches many times over under gravity. The distance
+    // is the rest length plus the stretch Compliance gives the links while hanging still under Gravity, so
+    // a compliant rope hangs at its compliant length; only stretch beyond that, such as a fast swing
+    // pulling harder than gravity, is cut back.
+    bool Tethers = true;
+};
+
+// The worm as position-based dynamics: a chain of unit-mass Verlet points joined by links that XPBD holds at
+// LinkLength, hanging under gravity from a head pinned to its target
+struct WormRope
+{
+    std::vector<sf::Vector2f> Position;
+    std::vector<sf::Vector2f> Previous; // Each point's position a step ago, which carries its velocity
+    std::vector<float> Lambda;          // Per link, the multiplier accumulated over this step's iterations
+    std::vector<sf::Vector2f> LinkPush; // Per link, the Jacobi solver's push from the positions before the iteration
+    float LinkLength = SegmentLength;
+
+    // Largest link residual in px, |length - LinkLength + compliance term|, that each iteration corrected,
+    // then one more entry for what the last iteration left, before the tethers. All of them cover only the
+    // last substep of the update. At zero the links are solved exactly.
+    std::vector<float> IterationError;
+    float TetherCorrection = 0.0f; // Farthest the tethers pulled a point in, in px, on the last substep
+
+};
+
+// Most residual, in px, any solver may leave after the last update of KernelBenchmark's scripted rope run: a
+// fresh rope of 10 or 100 points, 450 px long, led round a circle for 120 updates of 60 Hz
+constexpr float RopeScriptedResidualTolerance = 2.0f;
+
+// Lays Points points out vertically from Head, LinkLength apart and at rest
+void initializeWormRope(WormRope& Rope, std::size_t Points, const sf::Vector2f& Head, float LinkLength);
+
+// Advances the rope by DeltaTime in Settings.Substeps substeps, each Verlet integration under gravity with the
+// head moved along towards Target, then Settings.Iterations iterations over the links. Substeps cost as much
+// as iterations but converge far better, as each has less motion to undo. The parallel solvers spread the
+// links of a long rope across the pool, at the price of converging more slowly per iteration. A zero
+// DeltaTime leaves the rope as it is.
+void updateWormRope(WormRope& Rope, const sf::Vector2f& Target, float DeltaTime, const RopeSettings& Settings, WorkerPool& Pool);
+
+const char* ropeSolverName(RopeSolver Solver);
+
+// Parses the names ropeSolverName returns, leaving Solver alone and returning false for anything else
+bool parseRopeSolver(const char* Name, RopeSolver& Solver);
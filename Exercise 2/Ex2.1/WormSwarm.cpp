@@ -0,0 +1,299 @@
+#include "WormSwarm.h"
+
+#include "VectorMath.h"
+#include "WorkerPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+
+namespace
+{
+    constexpr float WanderCellSize = 200.0f;
+    constexpr float WanderTurnRate = 1.5f; // Share of the way a heading turns towards the field per second
+    constexpr float AvoidTurn = 20.0f;     // Sideways heading change per px of push on the head segment
+    constexpr float MinWormSpeed = 40.0f;
+    constexpr float MaxWormSpeed = 160.0f;
+
+    // Reflects a coordinate that left [0, Extent] back inside, turning the heading component with it
+    void bounce(float& Position, float& Heading, const float Extent)
+    {
+        if (Position < 0.0f)
+        {
+            Position = -Position;
+            Heading = std::abs(Heading);
+        }
+        else if (Position > Extent)
+        {
+            Position = 2.0f * Extent - Position;
+            Heading = -std::abs(Heading);
+        }
+        Position = std::clamp(Position, 0.0f, Extent);
+    }
+}
+
+void WormAlignedDeleter::operator()(float* Memory) const
+{
+    ::operator delete[](Memory, std::align_val_t{ WormArrayAlignment });
+}
+
+void initializeWormSwarm(WormSwarm& Swarm, const std::size_t Count, const sf::Vector2f Size, const unsigned Seed, const int Segments)
+{
+    Swarm.WormCount = Count;
+    Swarm.Stride = (Count + WormLaneWidth - 1) / WormLaneWidth * WormLaneWidth;
+    Swarm.SegmentCount = std::max(1, Segments);
+    Swarm.Size = Size;
+
+    // Zero everything so the padding lanes hold harmless values for the vector kernels
+    const std::size_t TotalFloats = Swarm.Stride * (2 * static_cast<std::size_t>(Swarm.SegmentCount) + 7);
+    Swarm.Storage.reset(static_cast<float*>(::operator new[](TotalFloats * sizeof(float), std::align_val_t{ WormArrayAlignment })));
+    std::fill(Swarm.Storage.get(), Swarm.Storage.get() + TotalFloats, 0.0f);
+    Swarm.X = Swarm.Storage.get();
+    Swarm.Y = Swarm.X + Swarm.Stride * static_cast<std::size_t>(Swarm.SegmentCount);
+    Swarm.TargetX = Swarm.Y + Swarm.Stride * static_cast<std::size_t>(Swarm.SegmentCount);
+    Swarm.TargetY = Swarm.TargetX + Swarm.Stride;
+    Swarm.HeadingX = Swarm.TargetY + Swarm.Stride;
+    Swarm.HeadingY = Swarm.HeadingX + Swarm.Stride;
+    Swarm.Speed = Swarm.HeadingY + Swarm.Stride;
+    Swarm.AvoidX = Swarm.Speed + Swarm.Stride;
+    Swarm.AvoidY = Swarm.AvoidX + Swarm.Stride;
+
+    std::mt19937 Generator(Seed);
+    std::uniform_real_distribution<float> PositionX(0.0f, Size.x);
+    std::uniform_real_distribution<float> PositionY(0.0f, Size.y);
+    std::uniform_real_distribution<float> Angle(0.0f, 6.2831853f);
+    std::uniform_real_distribution<float> Speed(MinWormSpeed, MaxWormSpeed);
+
+    Swarm.FieldCellSize = WanderCellSize;
+    Swarm.FieldColumns = std::max(1, static_cast<int>(std::ceil(Size.x / WanderCellSize)));
+    Swarm.FieldRows = std::max(1, static_cast<int>(std::ceil(Size.y / WanderCellSize)));
+    Swarm.FieldDirections.resize(static_cast<std::size_t>(Swarm.FieldColumns) * static_cast<std::size_t>(Swarm.FieldRows));
+
+    // The potential at the cell corners, and each cell's direction square to its gradient there
+    std::uniform_real_distribution<float> Potential(0.0f, 1.0f);
+    const std::size_t Corners = static_cast<std::size_t>(Swarm.FieldColumns) + 1;
+    std::vector<float> CornerPotential(Corners * (static_cast<std::size_t>(Swarm.FieldRows) + 1));
+    for (float& Value : CornerPotential)
+    {
+        Value = Potential(Generator);
+    }
+    for (std::size_t Row = 0; Row < static_cast<std::size_t>(Swarm.FieldRows); ++Row)
+    {
+        for (std::size_t Column = 0; Column < static_cast<std::size_t>(Swarm.FieldColumns); ++Column)
+        {
+            const float* Top = CornerPotential.data() + Row * Corners + Column;
+            const float* Bottom = Top + Corners;
+            const sf::Vector2f Gradient(Top[1] + Bottom[1] - Top[0] - Bottom[0], Bottom[0] + Bottom[1] - Top[0] - Top[1]);
+            const float LengthSquared = Gradient.x * Gradient.x + Gradient.y * Gradient.y;
+            Swarm.FieldDirections[Row * static_cast<std::size_t>(Swarm.FieldColumns) + Column] =
+                LengthSquared > FastMinLengthSquared ? sf::Vector2f(-Gradient.y, Gradient.x) * fastInverseSqrt(LengthSquared) : sf::Vector2f(1.0f, 0.0f);
+        }
+    }
+
+    for (std::size_t Worm = 0; Worm < Count; ++Worm)
+    {
+        const sf::Vector2f Head(PositionX(Generator), PositionY(Generator));
+        for (int Segment = 0; Segment < Swarm.SegmentCount; ++Segment)
+        {
+            Swarm.rowX(Segment)[Worm] = Head.x;
+            Swarm.rowY(Segment)[Worm] = Head.y + static_cast<float>(Segment) * SegmentLength;
+        }
+        const float Heading = Angle(Generator);
+        Swarm.TargetX[Worm] = Head.x;
+        Swarm.TargetY[Worm] = Head.y;
+        Swarm.HeadingX[Worm] = std::cos(Heading);
+        Swarm.HeadingY[Worm] = std::sin(Heading);
+        Swarm.Speed[Worm] = Speed(Generator);
+    }
+}
+
+void steerWormSwarm(WormSwarm& Swarm, const float DeltaTime, WorkerPool& Pool)
+{
+    const float Turn = std::min(1.0f, WanderTurnRate * DeltaTime);
+    Pool.parallelFor(Swarm.WormCount, [&](const std::size_t Begin, const std::size_t End)
+    {
+        for (std::size_t Worm = Begin; Worm < End; ++Worm)
+        {
+            const int Column = std::clamp(static_cast<int>(Swarm.TargetX[Worm] / Swarm.FieldCellSize), 0, Swarm.FieldColumns - 1);
+            const int Row = std::clamp(static_cast<int>(Swarm.TargetY[Worm] / Swarm.FieldCellSize), 0, Swarm.FieldRows - 1);
+            const sf::Vector2f Field = Swarm.FieldDirections[static_cast<std::size_t>(Row) * static_cast<std::size_t>(Swarm.FieldColumns) + static_cast<std::size_t>(Column)];
+
+            // Only the sideways part of the push turns the worm, so a head pushed back by its own body turns
+            // off it instead of reversing along it
+            const sf::Vector2f Current(Swarm.HeadingX[Worm], Swarm.HeadingY[Worm]);
+            sf::Vector2f Avoid(Swarm.AvoidX[Worm], Swarm.AvoidY[Worm]);
+            Avoid -= Current * (Avoid.x * Current.x + Avoid.y * Current.y);
+            const sf::Vector2f Heading = fastNormalize(Current + (Field - Current) * Turn + Avoid * AvoidTurn);
+            float HeadingX = Heading.x;
+            float HeadingY = Heading.y;
+
+            float TargetX = Swarm.TargetX[Worm] + HeadingX * Swarm.Speed[Worm] * DeltaTime;
+            float TargetY = Swarm.TargetY[Worm] + HeadingY * Swarm.Speed[Worm] * DeltaTime;
+            bounce(TargetX, HeadingX, Swarm.Size.x);
+            bounce(TargetY, HeadingY, Swarm.Size.y);
+            Swarm.TargetX[Worm] = TargetX;
+            Swarm.TargetY[Worm] = TargetY;
+            Swarm.HeadingX[Worm] = HeadingX;
+            Swarm.HeadingY[Worm] = HeadingY;
+        }
+    });
+}
+
+WormIsa detectWormIsa()
+{
+#if CPU_FEATURES_X86
+    if (cpuHasAvx512())
+    {
+        return WormIsa::Avx512;
+    }
+    if (cpuHasAvx2())
+    {
+        return WormIsa::Avx2;
+    }
+    return WormIsa::Sse2;
+#else
+    return WormIsa::Scalar;
+#endif
+}
+
+const char* wormIsaName(const WormIsa Isa)
+{
+    switch (Isa)
+    {
+    case WormIsa::Sse2:
+        return "SSE2";
+    case WormIsa::Avx2:
+        return "AVX2";
+    case WormIsa::Avx512:
+        return "AVX-512";
+    default:
+        return "Scalar";
+    }
+}
+
+WormSwarmKernel wormSwarmKernel(const WormIsa Isa)
+{
+    switch (Isa)
+    {
+#if CPU_FEATURES_X86
+    case WormIsa::Sse2:
+        return updateWormSwarmSse2;
+    case WormIsa::Avx2:
+        return updateWormSwarmAvx2;
+    case WormIsa::Avx512:
+        return updateWormSwarmAvx512;
+#endif
+    default:
+        return updateWormSwarmRange;
+    }
+}
+
+void updateWormSwarmRange(WormSwarm& Swarm, const std::size_t Begin, const std::size_t End)
+{
+    const std::size_t Last = std::min(End, Swarm.WormCount);
+    for (std::size_t Worm = Begin; Worm < Last; ++Worm)
+    {
+        sf::Vector2f Previous(Swarm.TargetX[Worm], Swarm.TargetY[Worm]);
+        Swarm.rowX(0)[Worm] = Previous.x;
+        Swarm.rowY(0)[Worm] = Previous.y;
+        for (int Segment = 1; Segment < Swarm.SegmentCount; ++Segment)
+        {
+            sf::Vector2f Position(Swarm.rowX(Segment)[Worm], Swarm.rowY(Segment)[Worm]);
+            const sf::Vector2f Direction = Position - Previous;
+            const float DistanceSquared = Direction.x * Direction.x + Direction.y * Direction.y;
+            if (DistanceSquared > SegmentLength * SegmentLength)
+            {
+                Position = Previous + Direction * (fastInverseSqrt(DistanceSquared) * SegmentLength);
+                Swarm.rowX(Segment)[Worm] = Position.x;
+                Swarm.rowY(Segment)[Worm] = Position.y;
+            }
+            Previous = Position;
+        }
+    }
+}
+
+void updateWormSwarm(WormSwarm& Swarm, const WormIsa Isa, WorkerPool& Pool)
+{
+    const WormSwarmKernel Kernel = wormSwarmKernel(Isa);
+    Pool.parallelFor(Swarm.WormCount, WormLaneWidth, [&](const std::size_t Begin, const std::size_t End)
+    {
+        Kernel(Swarm, Begin, End);
+    });
+}
+
+float wormSwarmKernelMaxError(const std::size_t Count, const WormIsa Isa, const unsigned Seed)
+{
+    constexpr int Frames = 240;
+
+    WorkerPool Pool(1);
+    WormSwarm Reference;
+    WormSwarm Test;
+    initializeWormSwarm(Reference, Count, sf::Vector2f(1600.0f, 900.0f), Seed);
+    initializeWormSwarm(Test, Count, sf::Vector2f(1600.0f, 900.0f), Seed);
+    const WormSwarmKernel Kernel = wormSwarmKernel(Isa);
+
+    float MaxError = 0.0f;
+    for (int Frame = 0; Frame < Frames; ++Frame)
+    {
+        // Steering only reads the targets, so both swarms keep identical targets throughout
+        steerWormSwarm(Reference, 1.0f / 60.0f, Pool);
+        steerWormSwarm(Test, 1.0f / 60.0f, Pool);
+        updateWormSwarmRange(Reference, 0, Reference.WormCount);
+        Kernel(Test, 0, Test.WormCount);
+        for (int Segment = 0; Segment < Reference.SegmentCount; ++Segment)
+        {
+            for (std::size_t Worm = 0; Worm < Reference.WormCount; ++Worm)
+            {
+                const float DX = Test.rowX(Segment)[Worm] - Reference.rowX(Segment)[Worm];
+                const float DY = Test.rowY(Segment)[Worm] - Reference.rowY(Segment)[Worm];
+                MaxError = std::max(MaxError, std::sqrt(DX * DX + DY * DY));
+            }
+        }
+    }
+    return MaxError;
+}
+
+void printWormSwarmScalingReport(const std::size_t Count, const WormIsa Isa, const unsigned MaxThreads)
+{
+    constexpr int Iterations = 50;
+
+    WormSwarm Swarm;
+    initializeWormSwarm(Swarm, Count, sf::Vector2f(1600.0f, 900.0f), 1);
+    const double SegmentsPerUpdate = static_cast<double>(Count) * static_cast<double>(Swarm.SegmentCount);
+
+    std::cout << "Worm swarm scaling report: " << Count << " worms x " << Swarm.SegmentCount << " segments, " << wormIsaName(Isa)
+        << " kernel" << std::endl;
+    std::cout << "threads   ms/update   Msegments/s   speedup   efficiency" << std::endl;
+
+    double SingleThreadMs = 0.0;
+    for (unsigned Threads = 1; Threads <= MaxThreads; ++Threads)
+    {
+        WorkerPool Pool(Threads);
+        steerWormSwarm(Swarm, 1.0f / 60.0f, Pool);
+        updateWormSwarm(Swarm, Isa, Pool); // Warm up caches and wake the workers once
+
+        // Only the constraint solve is timed; the targets still move between updates so the chains keep stretching
+        double TotalMs = 0.0;
+        for (int I = 0; I < Iterations; ++I)
+        {
+            steerWormSwarm(Swarm, 1.0f / 60.0f, Pool);
+            const auto Start = std::chrono::steady_clock::now();
+            updateWormSwarm(Swarm, Isa, Pool);
+            TotalMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+        }
+        const double Ms = TotalMs / Iterations;
+        if (Threads == 1)
+        {
+            SingleThreadMs = Ms;
+        }
+
+        const double Speedup = SingleThreadMs / Ms;
+        std::cout << std::setw(7) << Threads << std::fixed << std::setprecision(3) << std::setw(12) << Ms
+            << std::setprecision(1) << std::setw(14) << SegmentsPerUpdate / (Ms * 1e3)
+            << std::setprecision(3) << std::setw(10) << Speedup << std::setw(13) << Speedup / Threads << std::endl;
+    }
+}
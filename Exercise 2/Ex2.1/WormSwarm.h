@@ -0,0 +1,105 @@
+#pragma once
+
+#include "CpuFeatures.h"
+#include "Worm.h"
+
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+class WorkerPool;
+
+// Widest vector register (AVX-512) in floats, and the alignment of every array
+constexpr std::size_t WormLaneWidth = 16;
+constexpr std::size_t WormArrayAlignment = 64;
+
+enum class WormIsa
+{
+    Scalar,
+    Sse2,
+    Avx2,
+    Avx512
+};
+
+struct WormAlignedDeleter
+{
+    void operator()(float* Memory) const;
+};
+
+// A crowd of independent worms, each wandering after its own target. Positions are segment-major,
+// X[Segment * Stride + Worm], so one vector instruction moves the same segment of WormLaneWidth worms and
+// the follow-the-leader constraint runs down all of their chains at once. Segment 0 is the head.
+struct WormSwarm
+{
+    std::size_t WormCount = 0;
+    std::size_t Stride = 0; // WormCount rounded up to WormLaneWidth
+    int SegmentCount = NumWormSegments;
+    sf::Vector2f Size;      // The worms wander inside (0, 0) to Size
+
+    float* X = nullptr;        // SegmentCount rows of Stride floats
+    float* Y = nullptr;
+    float* TargetX = nullptr;  // Per worm, where the head goes on the next update
+    float* TargetY = nullptr;
+    float* HeadingX = nullptr; // Per worm, unit direction the target moves in
+    float* HeadingY = nullptr;
+    float* Speed = nullptr;    // Per worm, units per second
+    float* AvoidX = nullptr;   // Per worm, the push the last collision pass put on the head segment, zero
+    float* AvoidY = nullptr;   // without collisions
+
+    // Seeded field of unit directions over Size that the headings steer towards, row-major. Each cell points
+    // along the contour through it of a random potential, so the flow circles round and has no sinks where
+    // worms would gather, or turn back and forth on the spot folding over their own bodies.
+    int FieldColumns = 0;
+    int FieldRows = 0;
+    float FieldCellSize = 0.0f;
+    std::vector<sf::Vector2f> FieldDirections;
+
+    std::unique_ptr<float, WormAlignedDeleter> Storage;
+
+    float* rowX(const int Segment) { return X + static_cast<std::size_t>(Segment) * Stride; }
+    float* rowY(const int Segment) { return Y + static_cast<std::size_t>(Segment) * Stride; }
+    const float* rowX(const int Segment) const { return X + static_cast<std::size_t>(Segment) * Stride; }
+    const float* rowY(const int Segment) const { return Y + static_cast<std::size_t>(Segment) * Stride; }
+};
+
+// Scatters Count worms over Size, laid out vertically like initializeWorm, with seeded headings, speeds
+// and wander field
+void initializeWormSwarm(WormSwarm& Swarm, std::size_t Count, sf::Vector2f Size, unsigned Seed, int Segments = NumWormSegments);
+
+// Moves every worm's target DeltaTime along its heading, which turns towards the wander field under the
+// head and bounces off the edges of Size. A worm whose head segment was pushed by the collision pass also
+// turns sideways away from the push, so crowded worms spread out instead of pressing on into each other.
+void steerWormSwarm(WormSwarm& Swarm, float DeltaTime, WorkerPool& Pool);
+
+// Puts the heads of worms [Begin, End) on their targets and pulls every following segment back to within
+// SegmentLength of the one before, exactly as updateWorm does for one worm. The vector kernels need Begin
+// to be a multiple of WormLaneWidth and round End up to it, which the padding to Stride makes safe.
+using WormSwarmKernel = void (*)(WormSwarm& Swarm, std::size_t Begin, std::size_t End);
+
+// Picks the widest instruction set supported by both the build and the running CPU
+WormIsa detectWormIsa();
+const char* wormIsaName(WormIsa Isa);
+WormSwarmKernel wormSwarmKernel(WormIsa Isa);
+
+// Scalar reference, one worm at a time
+void updateWormSwarmRange(WormSwarm& Swarm, std::size_t Begin, std::size_t End);
+
+// Updates the whole swarm, split across the pool in lane-aligned chunks
+void updateWormSwarm(WormSwarm& Swarm, WormIsa Isa, WorkerPool& Pool);
+
+// Largest distance between any segment produced by the given kernel and by the scalar reference, over a
+// run of steered frames of a seeded swarm
+float wormSwarmKernelMaxError(std::size_t Count, WormIsa Isa, unsigned Seed = 1);
+
+// Most wormSwarmKernelMaxError may report for the AVX-512 kernel, in px. SSE2 and AVX2 must report zero.
+constexpr float WormSwarmAvx512Tolerance = 0.005f;
+
+// Times the swarm update on 1 to MaxThreads threads and prints worms x segments per second, speedup and
+// efficiency for each
+void printWormSwarmScalingReport(std::size_t Count, WormIsa Isa, unsigned MaxThreads);
+
+// Kernels built in their own translation units so each can be compiled for its instruction set
+void updateWormSwarmSse2(WormSwarm& Swarm, std::size_t Begin, std::size_t End);
+void updateWormSwarmAvx2(WormSwarm& Swarm, std::size_t Begin, std::size_t End);
+void updateWormSwarmAvx512(WormSwarm& Swarm, std::size_t Begin, std::size_t End);
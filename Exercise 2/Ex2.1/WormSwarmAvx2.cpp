@@ -0,0 +1,36 @@
+// Compiled with AVX2 enabled (see the project files); only called after detectWormIsa() has confirmed
+// the CPU supports it.
+
+#include "WormSwarm.h"
+#include "WormSwarmKernel.h"
+
+#if CPU_FEATURES_X86
+
+#include <immintrin.h>
+
+namespace
+{
+    struct Avx2Lanes
+    {
+        using Float = __m256;
+        using Mask = __m256;
+        static constexpr std::size_t Width = 8;
+
+        static Float set(const float Value) { return _mm256_set1_ps(Value); }
+        static Float load(const float* Address) { return _mm256_load_ps(Address); }
+        static void store(float* Address, const Float Value) { _mm256_store_ps(Address, Value); }
+        static Float add(const Float A, const Float B) { return _mm256_add_ps(A, B); }
+        static Float sub(const Float A, const Float B) { return _mm256_sub_ps(A, B); }
+        static Float mul(const Float A, const Float B) { return _mm256_mul_ps(A, B); }
+        static Float rsqrt(const Float Value) { return _mm256_rsqrt_ps(Value); }
+        static Mask greater(const Float A, const Float B) { return _mm256_cmp_ps(A, B, _CMP_GT_OQ); }
+        static Float select(const Mask Condition, const Float IfTrue, const Float IfFalse) { return _mm256_blendv_ps(IfFalse, IfTrue, Condition); }
+    };
+}
+
+void updateWormSwarmAvx2(WormSwarm& Swarm, const std::size_t Begin, const std::size_t End)
+{
+    WormSwarmDetail::updateWormSwarmLanes<Avx2Lanes>(Swarm, Begin, End);
+}
+
+#endif
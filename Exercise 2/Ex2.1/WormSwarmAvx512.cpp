@@ -0,0 +1,36 @@
+// Compiled with AVX-512F enabled (see the project files); only called after detectWormIsa() has
+// confirmed the CPU and operating system support it.
+
+#include "WormSwarm.h"
+#include "WormSwarmKernel.h"
+
+#if CPU_FEATURES_X86
+
+#include <immintrin.h>
+
+namespace
+{
+    struct Avx512Lanes
+    {
+        using Float = __m512;
+        using Mask = __mmask16;
+        static constexpr std::size_t Width = 16;
+
+        static Float set(const float Value) { return _mm512_set1_ps(Value); }
+        static Float load(const float* Address) { return _mm512_load_ps(Address); }
+        static void store(float* Address, const Float Value) { _mm512_store_ps(Address, Value); }
+        static Float add(const Float A, const Float B) { return _mm512_add_ps(A, B); }
+        static Float sub(const Float A, const Float B) { return _mm512_sub_ps(A, B); }
+        static Float mul(const Float A, const Float B) { return _mm512_mul_ps(A, B); }
+        static Float rsqrt(const Float Value) { return _mm512_rsqrt14_ps(Value); }
+        static Mask greater(const Float A, const Float B) { return _mm512_cmp_ps_mask(A, B, _CMP_GT_OQ); }
+        static Float select(const Mask Condition, const Float IfTrue, const Float IfFalse) { return _mm512_mask_blend_ps(Condition, IfFalse, IfTrue); }
+    };
+}
+
+void updateWormSwarmAvx512(WormSwarm& Swarm, const std::size_t Begin, const std::size_t End)
+{
+    WormSwarmDetail::updateWormSwarmLanes<Avx512Lanes>(Swarm, Begin, End);
+}
+
+#endif
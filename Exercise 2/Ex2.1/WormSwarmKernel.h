@@ -0,0 +1,49 @@
+#pragma once
+
+// Instruction-set independent body of the vector worm swarm kernels. Only included by the WormSwarm*.cpp
+// translation units, each of which supplies a lane type V wrapping one register width.
+
+#include "VectorMathKernel.h"
+#include "WormSwarm.h"
+
+#include <cstddef>
+
+namespace WormSwarmDetail
+{
+    // Same operations in the same order as updateWorm, so SSE2 and AVX2 lanes match the scalar path bit for
+    // bit. AVX-512's finer reciprocal square root estimate differs by an ulp here and there, which drifts
+    // to around a thousandth of a pixel over a few hundred frames, well within WormSwarmAvx512Tolerance.
+    template <class V>
+    inline void updateWormSwarmLanes(WormSwarm& Swarm, const std::size_t Begin, const std::size_t End)
+    {
+        using F = typename V::Float;
+
+        const F Length = V::set(SegmentLength);
+        const F LengthSquared = V::set(SegmentLength * SegmentLength);
+        for (std::size_t Worm = Begin; Worm < End; Worm += V::Width)
+        {
+            F PreviousX = V::load(Swarm.TargetX + Worm);
+            F PreviousY = V::load(Swarm.TargetY + Worm);
+            V::store(Swarm.rowX(0) + Worm, PreviousX);
+            V::store(Swarm.rowY(0) + Worm, PreviousY);
+
+            // Each segment only depends on the one before, which is still in registers
+            for (int Segment = 1; Segment < Swarm.SegmentCount; ++Segment)
+            {
+                const F X = V::load(Swarm.rowX(Segment) + Worm);
+                const F Y = V::load(Swarm.rowY(Segment) + Worm);
+                const F DirectionX = V::sub(X, PreviousX);
+                const F DirectionY = V::sub(Y, PreviousY);
+                const F DistanceSquared = V::add(V::mul(DirectionX, DirectionX), V::mul(DirectionY, DirectionY));
+
+                // Lanes within reach keep their position, so a zero distance there only produces a discarded NaN
+                const auto Stretched = V::greater(DistanceSquared, LengthSquared);
+                const F Scale = V::mul(VectorMathDetail::inverseSqrtLanes<V>(DistanceSquared), Length);
+                PreviousX = V::select(Stretched, V::add(PreviousX, V::mul(DirectionX, Scale)), X);
+                PreviousY = V::select(Stretched, V::add(PreviousY, V::mul(DirectionY, Scale)), Y);
+                V::store(Swarm.rowX(Segment) + Worm, PreviousX);
+                V::store(Swarm.rowY(Segment) + Worm, PreviousY);
+            }
+        }
+    }
+}
@@ -0,0 +1,38 @@
+// Baseline vector kernel: SSE2 is part of x86-64, so this one needs no runtime check.
+
+#include "WormSwarm.h"
+#include "WormSwarmKernel.h"
+
+#if CPU_FEATURES_X86
+
+#include <emmintrin.h>
+
+namespace
+{
+    struct Sse2Lanes
+    {
+        using Float = __m128;
+        using Mask = __m128;
+        static constexpr std::size_t Width = 4;
+
+        static Float set(const float Value) { return _mm_set1_ps(Value); }
+        static Float load(const float* Address) { return _mm_load_ps(Address); }
+        static void store(float* Address, const Float Value) { _mm_store_ps(Address, Value); }
+        static Float add(const Float A, const Float B) { return _mm_add_ps(A, B); }
+        static Float sub(const Float A, const Float B) { return _mm_sub_ps(A, B); }
+        static Float mul(const Float A, const Float B) { return _mm_mul_ps(A, B); }
+        static Float rsqrt(const Float Value) { return _mm_rsqrt_ps(Value); }
+        static Mask greater(const Float A, const Float B) { return _mm_cmpgt_ps(A, B); }
+        static Float select(const Mask Condition, const Float IfTrue, const Float IfFalse)
+        {
+            return _mm_or_ps(_mm_and_ps(Condition, IfTrue), _mm_andnot_ps(Condition, IfFalse));
+        }
+    };
+}
+
+void updateWormSwarmSse2(WormSwarm& Swarm, const std::size_t Begin, const std::size_t End)
+{
+    WormSwarmDetail::updateWormSwarmLanes<Sse2Lanes>(Swarm, Begin, End);
+}
+
+#endif
@@ -1,84 +1,291 @@
+#include "ChainRenderer.h"
+#include "FrameAllocations.h"
+#include "FrameArena.h"
+#include "FrameOverlay.h"
+#include "FrameProfiler.h"
+#include "SoftwareRasterizer.h"
+#include "WorkerPool.h"
+#include "Worm.h"
+#include "WormCollision.h"
+#include "WormOptions.h"
+#include "WormRope.h"
+#include "WormSwarm.h"
+
 #include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <optional>
+#include <span>
 #include <vector>
 #include <cmath>
 
 constexpr int WindowWidth = 1600;
 constexpr int WindowHeight = 900;
-constexpr int NumWormSegments = 10; 
-constexpr float SegmentLength = 50.0f; 
-constexpr float WormThickness = 6.0f; 
 
-struct WormSegment
+// Phases timed by the frame profiler
+enum FramePhase
 {
-    sf::Vector2f Position;
+    PhaseEvents,
+    PhaseUpdate,
+    PhaseDraw,
+    PhaseDisplay
 };
 
-void updateWorm(std::vector<WormSegment>& WormSegments, const sf::Vector2f& TargetPosition)
+// Stand-in for the mouse with --software: a slow figure of eight around the window centre
+sf::Vector2f scriptedCursor(const int Frame)
 {
-    // Set the head of the worm to the target position (mouse cursor)
-    WormSegments[0].Position = TargetPosition;
+    const float Time = static_cast<float>(Frame) / 60.0f;
+    return sf::Vector2f(WindowWidth / 2.0f + std::sin(Time) * 500.0f, WindowHeight / 2.0f + std::sin(Time * 2.0f) * 250.0f);
+}
 
-    // Update each segment to follow the previous segment
-    for (int I = 1; I < NumWormSegments; ++I)
+int main(int Argc, char* Argv[])
+{
+    // With --software the frames are drawn by the CPU rasterizer instead, and no window is opened
+    const SoftwareRenderOptions Software = softwareRenderOptions(Argc, Argv);
+    const WormOptions Options = parseWormOptions(Argc, Argv);
+    const bool SwarmMode = Options.SwarmCount > 0;
+    if (Options.Verify)
     {
-        sf::Vector2f Direction = WormSegments[I].Position - WormSegments[I - 1].Position;
-        const float Distance = std::sqrt(Direction.x * Direction.x + Direction.y * Direction.y);
-        if (Distance > SegmentLength)
-        {
-            Direction /= Distance; // Normalize direction
-            WormSegments[I].Position = WormSegments[I - 1].Position + Direction * SegmentLength;
-        }
+        std::cout << "Max deviation of the " << wormIsaName(Options.Isa) << " swarm kernel from the scalar path: "
+            << wormSwarmKernelMaxError(std::max<std::size_t>(Options.SwarmCount, 1000), Options.Isa, Options.Seed) << " px" << std::endl;
+        return 0;
     }
-}
 
-void renderWorm(sf::RenderWindow& Window, const std::vector<WormSegment>& WormSegments)
-{
-    for (int I = 0; I < NumWormSegments - 1; ++I)
+    // Rope mode swaps the follow-the-leader constraint for position-based dynamics
+    const bool RopeMode = !SwarmMode && Options.RopePoints > 1;
+
+    // The single worm is one sequential chain, so it only gets a pool for the CPU rasterizer or the rope's
+    // parallel solvers
+    WorkerPool Pool(Software.enabled() || SwarmMode || RopeMode || Options.Scaling ? Options.Threads : 1);
+    if (Options.Scaling)
     {
-        sf::RectangleShape SegmentLine;
-        SegmentLine.setPosition(WormSegments[I].Position);
-        const sf::Vector2f Direction = WormSegments[I + 1].Position - WormSegments[I].Position;
-        const float Length = std::sqrt(Direction.x * Direction.x + Direction.y * Direction.y);
-        SegmentLine.setSize(sf::Vector2f(Length, WormThickness));
-        SegmentLine.setRotation(std::atan2(Direction.y, Direction.x) * 180.f / 3.14159265f);
-        SegmentLine.setFillColor(sf::Color::Red);
-        Window.draw(SegmentLine);
+        printWormSwarmScalingReport(std::max<std::size_t>(Options.SwarmCount, 100000), Options.Isa, Pool.threadCount());
+        return 0;
     }
-}
 
-int main()
-{
-    sf::RenderWindow Window(sf::VideoMode(WindowWidth, WindowHeight), "Ex 2.1: Unconstrained Worm", sf::Style::Close);
+    std::optional<sf::RenderWindow> Window;
+    std::optional<SoftwareRasterizer> Rasterizer;
+    if (Software.enabled())
+    {
+        Rasterizer.emplace(WindowWidth, WindowHeight, Pool);
+    }
+    else
+    {
+        Window.emplace(sf::VideoMode(WindowWidth, WindowHeight), "Ex 2.1: Unconstrained Worm", sf::Style::Close);
+    }
 
     // Initialize worm segments
     std::vector<WormSegment> WormSegments(NumWormSegments);
-    for (int I = 0; I < NumWormSegments; ++I)
+    initializeWorm(WormSegments, sf::Vector2f(WindowWidth / 2.0f, WindowHeight / 2.0f));
+    const ChainStyle WormStyle{ WormThickness, sf::Color::Red };
+    const auto WormPoint = [&WormSegments](std::size_t, const std::size_t Segment) { return WormSegments[Segment].Position; };
+
+    // However many points it has, the rope is as long as the worm
+    WormRope Rope;
+    std::vector<double> RopeErrorTotals;
+    double RopeTetherTotal = 0.0;
+    double RopeUpdateSeconds = 0.0;
+    std::size_t RopeUpdates = 0;
+    if (RopeMode)
+    {
+        initializeWormRope(Rope, Options.RopePoints, sf::Vector2f(WindowWidth / 2.0f, WindowHeight / 2.0f),
+            SegmentLength * static_cast<float>(NumWormSegments - 1) / static_cast<float>(Options.RopePoints - 1));
+        RopeErrorTotals.assign(static_cast<std::size_t>(Options.Rope.Iterations) + 1, 0.0);
+        std::cout << "Worm rope: " << Options.RopePoints << " points, " << ropeSolverName(Options.Rope.Solver) << " solver, "
+            << Options.Rope.Substeps << " substeps of " << Options.Rope.Iterations << " iterations, compliance " << Options.Rope.Compliance
+            << (Options.Rope.Tethers ? "" : ", no tethers") << " on " << Pool.threadCount() << " thread(s)" << std::endl;
+    }
+    const auto RopePoint = [&Rope](std::size_t, const std::size_t Point) { return Rope.Position[Point]; };
+
+    // Swarm mode replaces the mouse-driven worm with many worms wandering over the window. A colliding swarm
+    // gets a field big enough to move in, and the view zooms out to show all of it.
+    WormSwarm Swarm;
+    double SwarmUpdateSeconds = 0.0;
+    std::size_t SwarmUpdates = 0;
+    if (SwarmMode)
+    {
+        const sf::Vector2f WindowSize(WindowWidth, WindowHeight);
+        const sf::Vector2f FieldSize = Options.Collide ? wormCollisionFieldSize(Options.SwarmCount, NumWormSegments, WindowSize) : WindowSize;
+        initializeWormSwarm(Swarm, Options.SwarmCount, FieldSize, Options.Seed);
+        if (Window)
+        {
+            Window->setView(sf::View(FieldSize * 0.5f, FieldSize));
+        }
+        else
+        {
+            Rasterizer->setView(FieldSize * 0.5f, FieldSize);
+        }
+        std::cout << "Worm swarm: " << Swarm.WormCount << " worms, " << wormIsaName(Options.Isa) << " kernel on "
+            << Pool.threadCount() << " thread(s)" << std::endl;
+    }
+
+    // Drawn like the single worm, with mitred joins so a swarm of a hundred thousand stays at four vertices
+    // per joint instead of a round join's ten
+    const ChainStyle SwarmStyle{ WormThickness, sf::Color::Red, ChainJoin::Miter };
+    const auto SwarmPoint = [&Swarm](const std::size_t Worm, const std::size_t Segment)
+    {
+        return sf::Vector2f(Swarm.rowX(static_cast<int>(Segment))[Worm], Swarm.rowY(static_cast<int>(Segment))[Worm]);
+    };
+
+    // Optional for either scene, resolved after the follow constraint every frame
+    WormCollisionGrid CollisionGrid;
+    double CollisionSeconds = 0.0;
+    std::size_t CollisionContacts = 0;
+
+    FrameProfiler Profiler({ "events", "update", "draw", "display" });
+    FrameOverlay Overlay;
+    if (Window)
+    {
+        loadFrameOverlayFont(Overlay);
+    }
+    const std::string CsvPath = frameProfilerCsvPath(Argc, Argv);
+    if (!CsvPath.empty() && !Profiler.startCsv(CsvPath))
     {
-        WormSegments[I].Position = sf::Vector2f(WindowWidth / 2.0f, WindowHeight / 2.0f + I * SegmentLength);
+        std::cerr << "Could not open " << CsvPath << " for frame timings" << std::endl;
     }
 
-    while (Window.isOpen())
+    // Transient geometry comes from the arena, so a steady-state frame makes no heap allocations
+    FrameArena Arena;
+    FrameAllocationCheck AllocationCheck;
+    sf::Clock Clock;
+    float PreviousTime = 0.0f;
+    for (int Frame = 0; Window ? Window->isOpen() : Frame < Software.Frames; ++Frame)
     {
-        sf::Event Event{};
-        while (Window.pollEvent(Event))
+        Profiler.beginFrame();
+        AllocationCheck.beginFrame();
+        Arena.reset();
         {
-            if (Event.type == sf::Event::Closed)
+            const auto Timer = Profiler.scope(PhaseEvents);
+            sf::Event Event{};
+            while (Window && Window->pollEvent(Event))
             {
-                Window.close();
+                handleFrameOverlayEvent(Overlay, Event);
+                if (Event.type == sf::Event::Closed)
+                {
+                    Window->close();
+                }
             }
         }
 
-        // Get mouse position and convert to world coordinates
-        sf::Vector2f MousePosition = Window.mapPixelToCoords(sf::Mouse::getPosition(Window));
+        {
+            const auto Timer = Profiler.scope(PhaseUpdate);
+
+            const float Time = Window ? Clock.getElapsedTime().asSeconds() : static_cast<float>(Frame) / 60.0f;
+            const float DeltaTime = std::min(Time - PreviousTime, 0.1f); // A stalled frame does not fling the swarm
+            PreviousTime = Time;
+            if (SwarmMode)
+            {
+                steerWormSwarm(Swarm, DeltaTime, Pool);
+                const auto Start = std::chrono::steady_clock::now();
+                updateWormSwarm(Swarm, Options.Isa, Pool);
+                const auto Updated = std::chrono::steady_clock::now();
+                SwarmUpdateSeconds += std::chrono::duration<double>(Updated - Start).count();
+                ++SwarmUpdates;
+                if (Options.Collide)
+                {
+                    CollisionContacts += resolveWormCollisions(CollisionGrid, Swarm, Pool);
+                    CollisionSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - Updated).count();
+                }
+            }
+            else
+            {
+                // Get mouse position and convert to world coordinates
+                sf::Vector2f MousePosition = Window ? Window->mapPixelToCoords(sf::Mouse::getPosition(*Window)) : scriptedCursor(Frame);
 
-        // Update worm position to follow mouse
-        updateWorm(WormSegments, MousePosition);
+                // Update worm position to follow mouse
+                if (RopeMode)
+                {
+                    if (DeltaTime > 0.0f)
+                    {
+                        const auto Start = std::chrono::steady_clock::now();
+                        updateWormRope(Rope, MousePosition, DeltaTime, Options.Rope, Pool);
+                        RopeUpdateSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+                        ++RopeUpdates;
+                        for (std::size_t I = 0; I < RopeErrorTotals.size(); ++I)
+                        {
+                            RopeErrorTotals[I] += Rope.IterationError[I];
+                        }
+                        RopeTetherTotal += Rope.TetherCorrection;
+                    }
+                }
+                else
+                {
+                    updateWorm(WormSegments, MousePosition);
+                    if (Options.Collide)
+                    {
+                        resolveWormCollisions(CollisionGrid, WormSegments, Pool);
+                    }
+                }
+            }
+        }
 
         // Render everything
-        Window.clear(sf::Color::Black);
-        renderWorm(Window, WormSegments);
-        Window.display();
+        {
+            const auto Timer = Profiler.scope(PhaseDraw);
+            // The worm is one triangle strip, its segments joined without gaps, and so is the whole swarm
+            const std::span<const sf::Vertex> Vertices = SwarmMode ? buildChainStrip(Swarm.WormCount, static_cast<std::size_t>(Swarm.SegmentCount), SwarmStyle, Arena, Pool, SwarmPoint)
+                : RopeMode ? buildChainStrip(1, Rope.Position.size(), WormStyle, Arena, RopePoint)
+                : buildChainStrip(1, WormSegments.size(), WormStyle, Arena, WormPoint);
+            if (Rasterizer)
+            {
+                Rasterizer->clear(sf::Color::Black);
+                Rasterizer->draw(Vertices.data(), Vertices.size(), sf::TriangleStrip);
+                Rasterizer->finish();
+            }
+            else
+            {
+                Window->clear(sf::Color::Black);
+                Window->draw(Vertices.data(), Vertices.size(), sf::TriangleStrip);
+                if (Overlay.Visible)
+                {
+                    AllocationCheck.allowAllocations(); // The overlay text is rebuilt every frame
+                }
+                drawFrameOverlay(*Window, Overlay, Profiler);
+            }
+        }
+        {
+            const auto Timer = Profiler.scope(PhaseDisplay);
+            if (Window)
+            {
+                Window->display();
+            }
+        }
+        Profiler.endFrame();
+        AllocationCheck.endFrame();
     }
 
+    if (SwarmUpdates > 0 && SwarmUpdateSeconds > 0.0)
+    {
+        const double Segments = static_cast<double>(Swarm.WormCount) * static_cast<double>(Swarm.SegmentCount) * static_cast<double>(SwarmUpdates);
+        std::cout << "Worm swarm: " << Segments / SwarmUpdateSeconds / 1e6 << " million worm segments updated per second over "
+            << SwarmUpdates << " updates" << std::endl;
+        if (Options.Collide)
+        {
+            std::cout << "Worm collisions: " << CollisionSeconds * 1e3 / static_cast<double>(SwarmUpdates) << " ms and "
+                << CollisionContacts / SwarmUpdates << " contacts per update" << std::endl;
+        }
+    }
+    if (RopeUpdates > 0)
+    {
+        // How far each iteration got, averaged over the run, against what the iterations cost
+        const double Updates = static_cast<double>(RopeUpdates);
+        std::cout << "Worm rope: " << RopeUpdateSeconds * 1e3 / Updates << " ms per update, mean largest link residual by iteration (px):";
+        for (std::size_t I = 0; I + 1 < RopeErrorTotals.size(); ++I)
+        {
+            std::cout << ' ' << RopeErrorTotals[I] / Updates;
+        }
+        std::cout << ", left after the last: " << RopeErrorTotals.back() / Updates << ", then pulled in by the tethers: "
+            << RopeTetherTotal / Updates << std::endl;
+    }
+    if (Rasterizer && !saveSoftwareFramebuffer(Rasterizer->framebuffer(), Software.OutputPath))
+    {
+        std::cerr << "Could not write " << Software.OutputPath << std::endl;
+        return 1;
+    }
+    if (Rasterizer)
+    {
+        printWorkerStats(Pool, std::cout); // How evenly the headless run spread over the pool
+    }
     return 0;
 }
@@ -0,0 +1,48 @@
+#include "Arm.h"
+
+#include "VectorMath.h"
+#include "WorkerPool.h"
+
+#include <cassert>
+
+void initializeArm(std::vector<ArmSegment>& ArmSegments, const sf::Vector2f& Base)
+{
+    for (std::size_t I = 0; I < ArmSegments.size(); ++I)
+    {
+        ArmSegments[I].Position = Base + sf::Vector2f(0.0f, static_cast<float>(I) * SegmentLength);
+    }
+}
+
+void updateArm(std::vector<ArmSegment>& ArmSegments, const sf::Vector2f& TargetPosition, const sf::Vector2f& BasePosition)
+{
+    // Set the end effector (last segment) to the target position (mouse cursor)
+    ArmSegments.back().Position = TargetPosition;
+
+    // Update each segment to follow the next segment towards the constrained base
+    for (int I = static_cast<int>(ArmSegments.size()) - 2; I >= 0; --I)
+    {
+        // Compared squared, so a segment within reach needs no square root at all
+        const sf::Vector2f Direction = ArmSegments[I].Position - ArmSegments[I + 1].Position;
+        const float DistanceSquared = Direction.x * Direction.x + Direction.y * Direction.y;
+        if (DistanceSquared > SegmentLength * SegmentLength)
+        {
+            ArmSegments[I].Position = ArmSegments[I + 1].Position + Direction * (fastInverseSqrt(DistanceSquared) * SegmentLength);
+        }
+    }
+
+    // Constrain the base of the arm to its anchor
+    ArmSegments[0].Position = BasePosition;
+}
+
+void updateArms(const std::span<std::vector<ArmSegment>> Arms, const std::span<const sf::Vector2f> Targets, const std::span<const sf::Vector2f> Bases,
+    WorkerPool& Pool)
+{
+    assert(Arms.size() == Targets.size() && Arms.size() == Bases.size());
+    Pool.parallelFor(Arms.size(), [&](const std::size_t Begin, const std::size_t End)
+    {
+        for (std::size_t I = Begin; I < End; ++I)
+        {
+            updateArm(Arms[I], Targets[I], Bases[I]);
+        }
+    });
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+#include <span>
+#include <vector>
+
+class WorkerPool;
+
+constexpr int NumArmSegments = 10;
+constexpr float SegmentLength = 50.0f;
+constexpr float ArmThickness = 6.0f;
+
+struct ArmSegment
+{
+    sf::Vector2f Position;
+};
+
+// Lays the arm out vertically from Base, one SegmentLength apart
+void initializeArm(std::vector<ArmSegment>& ArmSegments, const sf::Vector2f& Base);
+void updateArm(std::vector<ArmSegment>& ArmSegments, const sf::Vector2f& TargetPosition, const sf::Vector2f& BasePosition);
+
+// Updates independent arms in parallel, arm I reaching for Targets[I] from Bases[I]
+void updateArms(std::span<std::vector<ArmSegment>> Arms, std::span<const sf::Vector2f> Targets, std::span<const sf::Vector2f> Bases,
+    WorkerPool& Pool);
@@ -1,87 +1,146 @@
+#include "Arm.h"
+#include "ChainRenderer.h"
+#include "FrameAllocations.h"
+#include "FrameArena.h"
+#include "FrameOverlay.h"
+#include "FrameProfiler.h"
+#include "SoftwareRasterizer.h"
+#include "WorkerPool.h"
+
 #include <SFML/Graphics.hpp>
+#include <iostream>
+#include <optional>
+#include <span>
 #include <vector>
 #include <cmath>
 
 constexpr int WindowWidth = 1600;
 constexpr int WindowHeight = 900;
-constexpr int NumArmSegments = 10; 
-constexpr float SegmentLength = 50.0f;
-constexpr float ArmThickness = 6.0f;
 
-struct ArmSegment
+// Phases timed by the frame profiler
+enum FramePhase
 {
-    sf::Vector2f Position;
+    PhaseEvents,
+    PhaseUpdate,
+    PhaseDraw,
+    PhaseDisplay
 };
 
-void updateArm(std::vector<ArmSegment>& ArmSegments, const sf::Vector2f& TargetPosition)
+// Stand-in for the mouse with --software: circles the base, drifting in and out of the arm's reach
+sf::Vector2f scriptedCursor(const int Frame, const sf::Vector2f ArmBase)
 {
-    // Set the end effector (last segment) to the target position (mouse cursor)
-    ArmSegments.back().Position = TargetPosition;
-
-    // Update each segment to follow the next segment towards the constrained base
-    for (int I = NumArmSegments - 2; I >= 0; --I)
-    {
-        sf::Vector2f Direction = ArmSegments[I].Position - ArmSegments[I + 1].Position;
-        const float Distance = std::sqrt(Direction.x * Direction.x + Direction.y * Direction.y);
-        if (Distance > SegmentLength)
-        {
-            Direction /= Distance; // Normalize direction
-            ArmSegments[I].Position = ArmSegments[I + 1].Position + Direction * SegmentLength;
-        }
-    }
-
-    // Constrain the base of the arm to the center of the window
-    ArmSegments[0].Position = sf::Vector2f(WindowWidth / 2.0f, WindowHeight / 2.0f);
+    const float Time = static_cast<float>(Frame) / 60.0f;
+    const float Radius = 300.0f + std::sin(Time * 0.7f) * 200.0f;
+    return ArmBase + sf::Vector2f(std::cos(Time), std::sin(Time)) * Radius;
 }
 
-void renderArm(sf::RenderWindow& Window, const std::vector<ArmSegment>& ArmSegments)
+int main(int Argc, char* Argv[])
 {
-    for (int I = 0; I < NumArmSegments - 1; ++I)
+    // With --software the frames are drawn by the CPU rasterizer instead, and no window is opened
+    const SoftwareRenderOptions Software = softwareRenderOptions(Argc, Argv);
+    std::optional<sf::RenderWindow> Window;
+    WorkerPool Pool(Software.enabled() ? 0 : 1);
+    std::optional<SoftwareRasterizer> Rasterizer;
+    if (Software.enabled())
     {
-        sf::RectangleShape SegmentLine;
-        SegmentLine.setPosition(ArmSegments[I].Position);
-        const sf::Vector2f Direction = ArmSegments[I + 1].Position - ArmSegments[I].Position;
-        const float Length = std::sqrt(Direction.x * Direction.x + Direction.y * Direction.y);
-        SegmentLine.setSize(sf::Vector2f(Length, ArmThickness)); 
-        SegmentLine.setRotation(std::atan2(Direction.y, Direction.x) * 180.f / 3.14159265f);
-        SegmentLine.setFillColor(sf::Color::Blue);
-        Window.draw(SegmentLine);
+        Rasterizer.emplace(WindowWidth, WindowHeight, Pool);
+    }
+    else
+    {
+        Window.emplace(sf::VideoMode(WindowWidth, WindowHeight), "Ex 2.2: Constrained Arm", sf::Style::Close);
     }
-}
-
-int main()
-{
-    sf::RenderWindow Window(sf::VideoMode(WindowWidth, WindowHeight), "Ex 2.2: Constrained Arm", sf::Style::Close);
 
     // Initialize arm segments
+    const sf::Vector2f ArmBase(WindowWidth / 2.0f, WindowHeight / 2.0f);
     std::vector<ArmSegment> ArmSegments(NumArmSegments);
-    for (int I = 0; I < NumArmSegments; ++I)
+    initializeArm(ArmSegments, ArmBase);
+    const ChainStyle ArmStyle{ ArmThickness, sf::Color::Blue };
+    const auto ArmPoint = [&ArmSegments](std::size_t, const std::size_t Segment) { return ArmSegments[Segment].Position; };
+
+    FrameProfiler Profiler({ "events", "update", "draw", "display" });
+    FrameOverlay Overlay;
+    if (Window)
+    {
+        loadFrameOverlayFont(Overlay);
+    }
+    const std::string CsvPath = frameProfilerCsvPath(Argc, Argv);
+    if (!CsvPath.empty() && !Profiler.startCsv(CsvPath))
     {
-        ArmSegments[I].Position = sf::Vector2f(WindowWidth / 2.0f, WindowHeight / 2.0f + I * SegmentLength);
+        std::cerr << "Could not open " << CsvPath << " for frame timings" << std::endl;
     }
 
-    while (Window.isOpen())
+    // Transient geometry comes from the arena, so a steady-state frame makes no heap allocations
+    FrameArena Arena;
+    FrameAllocationCheck AllocationCheck;
+    for (int Frame = 0; Window ? Window->isOpen() : Frame < Software.Frames; ++Frame)
     {
-        sf::Event Event{};
-        while (Window.pollEvent(Event))
+        Profiler.beginFrame();
+        AllocationCheck.beginFrame();
+        Arena.reset();
         {
-            if (Event.type == sf::Event::Closed)
+            const auto Timer = Profiler.scope(PhaseEvents);
+            sf::Event Event{};
+            while (Window && Window->pollEvent(Event))
             {
-                Window.close();
+                handleFrameOverlayEvent(Overlay, Event);
+                if (Event.type == sf::Event::Closed)
+                {
+                    Window->close();
+                }
             }
         }
 
-        // Get mouse position and convert to world coordinates
-        sf::Vector2f MousePosition = Window.mapPixelToCoords(sf::Mouse::getPosition(Window));
+        {
+            const auto Timer = Profiler.scope(PhaseUpdate);
+
+            // Get mouse position and convert to world coordinates
+            sf::Vector2f MousePosition = Window ? Window->mapPixelToCoords(sf::Mouse::getPosition(*Window)) : scriptedCursor(Frame, ArmBase);
 
-        // Update arm position to follow mouse
-        updateArm(ArmSegments, MousePosition);
+            // Update arm position to follow mouse
+            updateArm(ArmSegments, MousePosition, ArmBase);
+        }
 
         // Render everything
-        Window.clear(sf::Color::Black);
-        renderArm(Window, ArmSegments);
-        Window.display();
+        {
+            const auto Timer = Profiler.scope(PhaseDraw);
+            // The arm is one triangle strip, its segments joined without gaps
+            const std::span<const sf::Vertex> Vertices = buildChainStrip(1, ArmSegments.size(), ArmStyle, Arena, ArmPoint);
+            if (Rasterizer)
+            {
+                Rasterizer->clear(sf::Color::Black);
+                Rasterizer->draw(Vertices.data(), Vertices.size(), sf::TriangleStrip);
+                Rasterizer->finish();
+            }
+            else
+            {
+                Window->clear(sf::Color::Black);
+                Window->draw(Vertices.data(), Vertices.size(), sf::TriangleStrip);
+                if (Overlay.Visible)
+                {
+                    AllocationCheck.allowAllocations(); // The overlay text is rebuilt every frame
+                }
+                drawFrameOverlay(*Window, Overlay, Profiler);
+            }
+        }
+        {
+            const auto Timer = Profiler.scope(PhaseDisplay);
+            if (Window)
+            {
+                Window->display();
+            }
+        }
+        Profiler.endFrame();
+        AllocationCheck.endFrame();
     }
 
+    if (Rasterizer && !saveSoftwareFramebuffer(Rasterizer->framebuffer(), Software.OutputPath))
+    {
+        std::cerr << "Could not write " << Software.OutputPath << std::endl;
+        return 1;
+    }
+    if (Rasterizer)
+    {
+        printWorkerStats(Pool, std::cout); // How evenly the headless run spread over the pool
+    }
     return 0;
 }
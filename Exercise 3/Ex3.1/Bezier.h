@@ -0,0 +1,47 @@
+#pragma once
+
+#include "WorkerPool.h"
+
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <span>
+
+inline sf::Vector2f bezierPoint(const sf::Vector2f& P0, const sf::Vector2f& P1, const sf::Vector2f& P2, const sf::Vector2f& P3, const float T)
+{
+	const float U = 1 - T;
+	const float TT = T * T;
+	const float UU = U * U;
+    float UUU = UU * U;
+    float TTT = TT * T;
+
+    sf::Vector2f Point = UUU * P0; // (1-T)^3 * P0
+    Point += 3 * UU * T * P1;     // 3 * (1-T)^2 * T * P1
+    Point += 3 * U * TT * P2;      // 3 * (1-T) * T^2 * P2
+    Point += TTT * P3;             // T^3 * P3
+
+    return Point;
+}
+
+// Samples the curve at Points.size() evenly spaced T from 0 to 1 inclusive, split across the pool. Chunks
+// are whole multiples of 16 points, so no two threads write the same cache line.
+inline void tessellateBezier(const std::span<sf::Vector2f> Points, const sf::Vector2f& P0, const sf::Vector2f& P1, const sf::Vector2f& P2,
+    const sf::Vector2f& P3, WorkerPool& Pool)
+{
+    if (Points.size() < 2)
+    {
+        if (!Points.empty())
+        {
+            Points[0] = P0;
+        }
+        return;
+    }
+
+    const float Step = 1.0f / static_cast<float>(Points.size() - 1);
+    Pool.parallelFor(Points.size(), 16, [&](const std::size_t Begin, const std::size_t End)
+    {
+        for (std::size_t I = Begin; I < End; ++I)
+        {
+            Points[I] = bezierPoint(P0, P1, P2, P3, static_cast<float>(I) * Step);
+        }
+    });
+}
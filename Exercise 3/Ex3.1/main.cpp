@@ -1,124 +1,219 @@
+#include "Bezier.h"
+#include "FrameAllocations.h"
+#include "FrameArena.h"
+#include "FrameOverlay.h"
+#include "FrameProfiler.h"
+#include "SoftwareRasterizer.h"
+#include "WorkerPool.h"
+
 #include <SFML/Graphics.hpp>
-#include <vector>
+#include <iostream>
+#include <optional>
+#include <span>
 #include <cmath>
 
 constexpr int WindowWidth = 1600;
 constexpr int WindowHeight = 900;
 constexpr int CurvePoints = 1000;
 
-sf::Vector2f bezierPoint(const sf::Vector2f& P0, const sf::Vector2f& P1, const sf::Vector2f& P2, const sf::Vector2f& P3, const float T)
+// Phases timed by the frame profiler
+enum FramePhase
+{
+    PhaseEvents,
+    PhaseUpdate,
+    PhaseBuild,
+    PhaseDraw,
+    PhaseDisplay
+};
+
+// Stand-in for dragging with --software: each control point circles its starting position
+sf::Vector2f scriptedControlPoint(const int Frame, const sf::Vector2f Start, const float Phase)
 {
-	const float U = 1 - T;
-	const float TT = T * T;
-	const float UU = U * U;
-    float UUU = UU * U;
-    float TTT = TT * T;
-
-    sf::Vector2f Point = UUU * P0; // (1-T)^3 * P0
-    Point += 3 * UU * T * P1;     // 3 * (1-T)^2 * T * P1
-    Point += 3 * U * TT * P2;      // 3 * (1-T) * T^2 * P2
-    Point += TTT * P3;             // T^3 * P3
-
-    return Point;
+    const float Time = static_cast<float>(Frame) / 60.0f + Phase;
+    return Start + sf::Vector2f(std::cos(Time), std::sin(Time)) * 200.0f;
 }
 
-int main()
+int main(int Argc, char* Argv[])
 {
-    sf::RenderWindow Window(sf::VideoMode(WindowWidth, WindowHeight), "Ex 3.1: Cubic Bezier Curve", sf::Style::Close);
+    // With --software the frames are drawn by the CPU rasterizer instead, and no window is opened
+    const SoftwareRenderOptions Software = softwareRenderOptions(Argc, Argv);
+    std::optional<sf::RenderWindow> Window;
+    WorkerPool Pool(Software.enabled() ? 0 : 1);
+    std::optional<SoftwareRasterizer> Rasterizer;
+    if (Software.enabled())
+    {
+        Rasterizer.emplace(WindowWidth, WindowHeight, Pool);
+    }
+    else
+    {
+        Window.emplace(sf::VideoMode(WindowWidth, WindowHeight), "Ex 3.1: Cubic Bezier Curve", sf::Style::Close);
+    }
 
     // Define anchor and control points
     sf::Vector2f AnchorLeft(0.0f, WindowHeight / 2.0f);
     sf::Vector2f AnchorRight(WindowWidth, WindowHeight / 2.0f);
     sf::Vector2f ControlLeft(400.0f, WindowHeight / 3.0f);
     sf::Vector2f ControlRight(1200.0f, 2 * WindowHeight / 3.0f);
+    const sf::Vector2f ControlLeftStart = ControlLeft;
+    const sf::Vector2f ControlRightStart = ControlRight;
 
     bool MovingControlLeft = false;
     bool MovingControlRight = false;
 
-    while (Window.isOpen())
+    FrameProfiler Profiler({ "events", "update", "build", "draw", "display" });
+    FrameOverlay Overlay;
+    if (Window)
+    {
+        loadFrameOverlayFont(Overlay);
+    }
+    const std::string CsvPath = frameProfilerCsvPath(Argc, Argv);
+    if (!CsvPath.empty() && !Profiler.startCsv(CsvPath))
+    {
+        std::cerr << "Could not open " << CsvPath << " for frame timings" << std::endl;
+    }
+
+    // Control points keep their shapes across frames; only their positions change. Left point, left mouse
+    // button (LMB, MB1); right point, right mouse button (RMB, MB2).
+    sf::CircleShape ControlLeftShape(10.0f);
+    ControlLeftShape.setFillColor(sf::Color::Red);
+    sf::CircleShape ControlRightShape(10.0f);
+    ControlRightShape.setFillColor(sf::Color::Blue);
+
+    // Transient geometry comes from the arena, so a steady-state frame makes no heap allocations
+    FrameArena Arena;
+    FrameAllocationCheck AllocationCheck;
+    for (int Frame = 0; Window ? Window->isOpen() : Frame < Software.Frames; ++Frame)
     {
-        sf::Event Event{};
-        while (Window.pollEvent(Event))
+        Profiler.beginFrame();
+        AllocationCheck.beginFrame();
+        Arena.reset();
         {
-            if (Event.type == sf::Event::Closed)
+            const auto Timer = Profiler.scope(PhaseEvents);
+            sf::Event Event{};
+            while (Window && Window->pollEvent(Event))
             {
-                Window.close();
-            }
-            else if (Event.type == sf::Event::MouseButtonPressed)
-            {
-                if (Event.mouseButton.button == sf::Mouse::Left)
+                handleFrameOverlayEvent(Overlay, Event);
+                if (Event.type == sf::Event::Closed)
                 {
-                    sf::Vector2f MousePosition = Window.mapPixelToCoords(sf::Mouse::getPosition(Window));
-                    if (std::hypot(MousePosition.x - ControlLeft.x, MousePosition.y - ControlLeft.y) < 10.0f)
-                    {
-                        MovingControlLeft = true;
-                    }
+                    Window->close();
                 }
-                else if (Event.mouseButton.button == sf::Mouse::Right)
+                else if (Event.type == sf::Event::MouseButtonPressed)
                 {
-                    sf::Vector2f MousePosition = Window.mapPixelToCoords(sf::Mouse::getPosition(Window));
-                    if (std::hypot(MousePosition.x - ControlRight.x, MousePosition.y - ControlRight.y) < 10.0f)
+                    if (Event.mouseButton.button == sf::Mouse::Left)
                     {
-                        MovingControlRight = true;
+                        sf::Vector2f MousePosition = Window->mapPixelToCoords(sf::Mouse::getPosition(*Window));
+                        if (std::hypot(MousePosition.x - ControlLeft.x, MousePosition.y - ControlLeft.y) < 10.0f)
+                        {
+                            MovingControlLeft = true;
+                        }
+                    }
+                    else if (Event.mouseButton.button == sf::Mouse::Right)
+                    {
+                        sf::Vector2f MousePosition = Window->mapPixelToCoords(sf::Mouse::getPosition(*Window));
+                        if (std::hypot(MousePosition.x - ControlRight.x, MousePosition.y - ControlRight.y) < 10.0f)
+                        {
+                            MovingControlRight = true;
+                        }
                     }
                 }
-            }
-            else if (Event.type == sf::Event::MouseButtonReleased)
-            {
-                if (Event.mouseButton.button == sf::Mouse::Left)
-                {
-                    MovingControlLeft = false;
-                }
-                else if (Event.mouseButton.button == sf::Mouse::Right)
+                else if (Event.type == sf::Event::MouseButtonReleased)
                 {
-                    MovingControlRight = false;
+                    if (Event.mouseButton.button == sf::Mouse::Left)
+                    {
+                        MovingControlLeft = false;
+                    }
+                    else if (Event.mouseButton.button == sf::Mouse::Right)
+                    {
+                        MovingControlRight = false;
+                    }
                 }
             }
         }
 
-        // Update control point positions if being dragged
-        if (MovingControlLeft)
         {
-            ControlLeft = Window.mapPixelToCoords(sf::Mouse::getPosition(Window));
-        }
-        if (MovingControlRight)
-        {
-            ControlRight = Window.mapPixelToCoords(sf::Mouse::getPosition(Window));
+            const auto Timer = Profiler.scope(PhaseUpdate);
+            // Update control point positions if being dragged
+            if (!Window)
+            {
+                ControlLeft = scriptedControlPoint(Frame, ControlLeftStart, 0.0f);
+                ControlRight = scriptedControlPoint(Frame, ControlRightStart, 3.1415927f);
+            }
+            if (MovingControlLeft)
+            {
+                ControlLeft = Window->mapPixelToCoords(sf::Mouse::getPosition(*Window));
+            }
+            if (MovingControlRight)
+            {
+                ControlRight = Window->mapPixelToCoords(sf::Mouse::getPosition(*Window));
+            }
         }
 
-        // Draw the Bezier curve
-        std::vector<sf::Vertex> CurveVertices;
-        for (int I = 0; I <= CurvePoints; ++I)
+        // Build the Bezier curve
+        std::span<sf::Vertex> CurveVertices;
         {
-            float T = static_cast<float>(I) / CurvePoints;
-            sf::Vector2f Point = bezierPoint(AnchorLeft, ControlLeft, ControlRight, AnchorRight, T);
-            CurveVertices.emplace_back(Point, sf::Color::Green);
+            const auto Timer = Profiler.scope(PhaseBuild);
+            CurveVertices = Arena.allocate<sf::Vertex>(CurvePoints + 1);
+            for (int I = 0; I <= CurvePoints; ++I)
+            {
+                float T = static_cast<float>(I) / CurvePoints;
+                sf::Vector2f Point = bezierPoint(AnchorLeft, ControlLeft, ControlRight, AnchorRight, T);
+                CurveVertices[I] = sf::Vertex(Point, sf::Color::Green);
+            }
         }
 
         // Render everything
-        Window.clear(sf::Color::Black);
-
-        // Draw bezier curve
-        if (!CurveVertices.empty())
         {
-            Window.draw(CurveVertices.data(), CurveVertices.size(), sf::LineStrip);
-        }
-
-        // Draw control points
-        sf::CircleShape ControlPointShape(10.0f);
-        ControlPointShape.setFillColor(sf::Color::Red); // Left point, left mouse button (LMB, MB1)
-
-        ControlPointShape.setPosition(ControlLeft.x - 10.0f, ControlLeft.y - 10.0f);
-        Window.draw(ControlPointShape);
+            const auto Timer = Profiler.scope(PhaseDraw);
+            if (Rasterizer)
+            {
+                Rasterizer->clear(sf::Color::Black);
+                Rasterizer->draw(CurveVertices.data(), CurveVertices.size(), sf::LineStrip);
+                Rasterizer->drawCircle(ControlLeft, 10.0f, softwareColor(sf::Color::Red));
+                Rasterizer->drawCircle(ControlRight, 10.0f, softwareColor(sf::Color::Blue));
+                Rasterizer->finish();
+            }
+            else
+            {
+                Window->clear(sf::Color::Black);
 
-        // Change color for the right control point
-        ControlPointShape.setFillColor(sf::Color::Blue); // Right point, right mouse button (RMB, MB2)
+                // Draw bezier curve
+                if (!CurveVertices.empty())
+                {
+                    Window->draw(CurveVertices.data(), CurveVertices.size(), sf::LineStrip);
+                }
 
-        ControlPointShape.setPosition(ControlRight.x - 10.0f, ControlRight.y - 10.0f);
-        Window.draw(ControlPointShape);
+                // Draw control points
+                ControlLeftShape.setPosition(ControlLeft.x - 10.0f, ControlLeft.y - 10.0f);
+                Window->draw(ControlLeftShape);
+                ControlRightShape.setPosition(ControlRight.x - 10.0f, ControlRight.y - 10.0f);
+                Window->draw(ControlRightShape);
 
-        Window.display();
+                if (Overlay.Visible)
+                {
+                    AllocationCheck.allowAllocations(); // The overlay text is rebuilt every frame
+                }
+                drawFrameOverlay(*Window, Overlay, Profiler);
+            }
+        }
+        {
+            const auto Timer = Profiler.scope(PhaseDisplay);
+            if (Window)
+            {
+                Window->display();
+            }
+        }
+        Profiler.endFrame();
+        AllocationCheck.endFrame();
     }
 
+    if (Rasterizer && !saveSoftwareFramebuffer(Rasterizer->framebuffer(), Software.OutputPath))
+    {
+        std::cerr << "Could not write " << Software.OutputPath << std::endl;
+        return 1;
+    }
+    if (Rasterizer)
+    {
+        printWorkerStats(Pool, std::cout); // How evenly the headless run spread over the pool
+    }
     return 0;
 }